@@ -0,0 +1,156 @@
+#pragma once
+
+#include "Objects.h"
+
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace uconfig {
+
+/// Limits of a single parse, every one is unlimited by default.
+struct ParseLimits
+{
+    static constexpr std::size_t kUnlimited = std::numeric_limits<std::size_t>::max();
+
+    /// Maximum nesting of configs and vectors, the root config is at depth 1.
+    std::size_t max_depth = kUnlimited;
+    /// Maximum number of elements of a vector.
+    std::size_t max_vector_size = kUnlimited;
+    /// Maximum length of a string value.
+    std::size_t max_string_size = kUnlimited;
+    /// Maximum total size of parsed values: length of strings and size of other values.
+    std::size_t max_total_bytes = kUnlimited;
+    /// Maximum duration of the parse.
+    std::chrono::nanoseconds timeout = std::chrono::nanoseconds::max();
+};
+
+/// Error thrown if a parse exceeds its' uconfig::ParseLimits. Never swallowed by optional elements.
+struct BudgetError: public ParseError
+{
+    /// Exceeded limit.
+    enum class Limit
+    {
+        Depth,
+        VectorSize,
+        StringSize,
+        TotalBytes,
+        Deadline,
+    };
+
+    /**
+     * Constructor.
+     *
+     * @param[in] exceeded Exceeded limit.
+     * @param[in] element_path Path to the element exceeding the limit.
+     * @param[in] message Error message.
+     */
+    BudgetError(Limit exceeded, std::string element_path, const std::string& message);
+
+    /// Exceeded limit.
+    Limit limit;
+    /// Path to the element exceeding the limit.
+    std::string path;
+};
+
+/**
+ * Budget of parses on the calling thread.
+ * While the budget exists, parses on the thread (and workers of parallel vector parsing) are checked against
+ *  its' limits and throw uconfig::BudgetError as soon as one is exceeded. Vectors are checked before their
+ *  elements are stored, so memory is bounded by the limits regardless of the input.
+ * Checks cost a load of a thread-local pointer if there is no budget.
+ */
+class ParseBudget
+{
+public:
+    /**
+     * Constructor. Attaches the budget to the calling thread, the deadline starts now.
+     *
+     * @param[in] limits Limits of the parse.
+     */
+    explicit ParseBudget(const ParseLimits& limits);
+
+    /// Copy constructor.
+    ParseBudget(const ParseBudget&) = delete;
+    /// Copy assignment.
+    ParseBudget& operator=(const ParseBudget&) = delete;
+
+    /// Destructor. Detaches the budget from the thread.
+    ~ParseBudget();
+
+    /// Get total size of values parsed so far.
+    std::size_t TotalBytes() const noexcept;
+
+    /// Nesting level of a config or a vector, checks depth and deadline.
+    class DepthGuard
+    {
+    public:
+        DepthGuard(const std::string& format, const std::string& path);
+        DepthGuard(const DepthGuard&) = delete;
+        DepthGuard& operator=(const DepthGuard&) = delete;
+        ~DepthGuard();
+
+    private:
+        ParseBudget* budget_;
+    };
+
+    /// Attachment of a budget to a worker thread parsing part of a vector.
+    class WorkerScope
+    {
+    public:
+        /// Capture budget and depth of the calling thread.
+        WorkerScope() noexcept;
+        /// Attach captured budget and depth to the calling thread.
+        void Attach() const noexcept;
+
+    private:
+        ParseBudget* budget_;
+        std::size_t depth_;
+    };
+
+    /**
+     * Check that a vector may hold @p size elements.
+     *
+     * @throws uconfig::BudgetError Thrown if the limit is exceeded.
+     */
+    static void CheckVectorSize(const std::string& format, const std::string& path, std::size_t size);
+
+    /**
+     * Account parsed @p value, checks string size, total size and deadline.
+     *
+     * @throws uconfig::BudgetError Thrown if some limit is exceeded.
+     */
+    template <typename T>
+    static void Account(const std::string& format, const std::string& path, const T& value);
+
+private:
+    /// Budget attached to the calling thread.
+    static ParseBudget*& Current() noexcept;
+    /// Nesting level on the calling thread.
+    static std::size_t& Depth() noexcept;
+
+    /// Account @p bytes of a value, @p is_string to check them against the string size limit.
+    void Account(const std::string& format, const std::string& path, std::size_t bytes, bool is_string);
+    /// Check the deadline every few calls.
+    void CheckDeadline(const std::string& format, const std::string& path, bool force);
+
+    /// Throw uconfig::BudgetError.
+    [[noreturn]] static void Fail(BudgetError::Limit limit, const std::string& format, const std::string& path,
+                                  const std::string& reason);
+
+private:
+    ParseLimits limits_;
+    std::chrono::steady_clock::time_point deadline_;
+    ParseBudget* previous_;
+    std::size_t previous_depth_;
+    std::atomic<std::size_t> total_bytes_{0};
+    std::atomic<std::size_t> checks_{0};
+};
+
+} // namespace uconfig
+
+#include "impl/Budget.ipp"
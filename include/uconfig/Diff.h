@@ -0,0 +1,79 @@
+#pragma once
+
+#include "Objects.h"
+
+#include <string>
+#include <vector>
+
+namespace uconfig {
+
+/// Change of a single element between two configs, see uconfig::Diff().
+struct Change
+{
+    /// Kind of the change.
+    enum class Kind
+    {
+        Added,    ///< Element has no value before the change.
+        Removed,  ///< Element has no value after the change.
+        Replaced, ///< Element has different values.
+    };
+
+    Kind kind;             ///< Kind of the change.
+    std::string path;      ///< Path to the element in terms of the format.
+    std::string old_value; ///< Printed value before the change, empty if added or not printable.
+    std::string new_value; ///< Printed value after the change, empty if removed or not printable.
+};
+
+/**
+ * Find changes between two instances of the same config.
+ * Registered elements of both configs are walked in lockstep and their values are compared directly, nothing is
+ *  emitted. Changes of vector elements are reported per element, elements removed from the end of a vector are
+ *  reported last to first. Copies of uconfig::SharedVector and uconfig::SharedSection sharing the storage are
+ *  equal without comparing their values.
+ *
+ * @tparam F Type of the format to build paths with. Should be one of formats of @p C.
+ * @tparam C Type of the config.
+ *
+ * @param[in] format Format instance to build paths with.
+ * @param[in] before Config before the changes.
+ * @param[in] after Config after the changes.
+ * @param[in] path Path of the configs in terms of @p F. Default empty.
+ *
+ * @returns Changes in order of registration of the elements.
+ * @throws uconfig::Error Thrown if configs have different elements registered.
+ *
+ * @note Elements of the configs are registered again, so the configs should not be parsed, emitted or checked
+ *  with Initialized() concurrently.
+ */
+template <typename F, typename C>
+std::vector<Change> Diff(const F& format, const C& before, const C& after, const std::string& path = "");
+
+namespace detail {
+
+/// Print @p value for uconfig::Change, empty string if it is not printable.
+template <typename T>
+std::string print_value(const T& value);
+
+/// Print @p values for uconfig::Change, empty string if they are not printable.
+template <typename T>
+std::string print_value(const std::vector<T>& values);
+
+/// Get interface of the same element of another config as @p iface.
+template <typename IfaceT, typename F>
+const IfaceT& diff_peer(const IfaceT& iface, const Interface<F>& other);
+
+/// Append changes between optional @p before and @p after values at @p path to @p changes.
+template <typename T, typename F>
+void diff_values(const F& format, const std::string& path, const T* before, const T* after,
+                 std::vector<Change>* changes);
+
+/// Append changes between optional @p before and @p after vectors at @p path to @p changes.
+template <typename T, typename F>
+void diff_vectors(const F& format, const std::string& path, const std::vector<T>* before,
+                  const std::vector<T>* after, std::vector<Change>* changes);
+
+} // namespace detail
+
+} // namespace uconfig
+
+#include "impl/Diff.ipp"
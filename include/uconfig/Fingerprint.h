@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Objects.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace uconfig {
+namespace detail {
+
+/**
+ * Continue fingerprint @p hash with @p value, see Config::Fingerprint().
+ * Values are tagged with their kind, so e.g. `1` and `"1"` differ.
+ *
+ * @tparam F Format the config of the value is registered for.
+ *
+ * @param[in] path Path to the value, used for errors only.
+ * @param[in] value Value to hash.
+ * @param[in] hash Hash to continue.
+ *
+ * @returns Continued hash.
+ * @throws uconfig::Error Thrown if @p value is neither of a built-in type nor printable.
+ */
+template <typename F, typename T>
+std::uint64_t fingerprint_value(const std::string& path, const T& value, std::uint64_t hash);
+
+/// Continue fingerprint @p hash with @p values, see Config::Fingerprint().
+template <typename F, typename T>
+std::uint64_t fingerprint_value(const std::string& path, const std::vector<T>& values, std::uint64_t hash);
+
+/// Continue fingerprint @p hash with an absent value, see Config::Fingerprint().
+std::uint64_t fingerprint_absent(std::uint64_t hash) noexcept;
+
+} // namespace detail
+} // namespace uconfig
+
+#include "impl/Fingerprint.ipp"
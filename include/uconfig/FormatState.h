@@ -0,0 +1,66 @@
+#pragma once
+
+#include "detail/detail.h"
+
+namespace uconfig {
+
+/**
+ * State of a format kept for one config parse, e.g. caches of lookups in the parsed source.
+ *
+ * Format defines `parse_state` type constructible from the format. Config::Parse() constructs one for every parse
+ *  and attaches it to the calling thread (and workers of parallel vector parsing), the format gets it from
+ *  FormatState<parse_state>::Current(). State is dropped at the end of the parse, so it never serves a later one.
+ *  Lookups outside of a config parse, e.g. direct calls of the format, see no state.
+ *
+ * @tparam State Type of the state.
+ */
+template <typename State>
+class FormatState
+{
+public:
+    /// State attached to the calling thread.
+    static State* Current() noexcept;
+
+    /// Attachment of a state to the calling thread, nested attachments override outer ones.
+    class Scope
+    {
+    public:
+        explicit Scope(State* state) noexcept;
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+        ~Scope();
+
+    private:
+        State* previous_;
+    };
+
+private:
+    /// State attached to the calling thread.
+    static State*& CurrentRef() noexcept;
+};
+
+namespace detail {
+
+/// Attached state of format @p F, see uconfig::FormatState.
+template <typename F>
+using format_state_type = FormatState<format_state_t<F>>;
+
+/// State of format @p F for one parse, attached to the calling thread for the lifetime of the object.
+template <typename F>
+class FormatStateScope
+{
+public:
+    explicit FormatStateScope(const F& format);
+    FormatStateScope(const FormatStateScope&) = delete;
+    FormatStateScope& operator=(const FormatStateScope&) = delete;
+
+private:
+    format_state_t<F> state_;
+    typename format_state_type<F>::Scope scope_;
+};
+
+} // namespace detail
+
+} // namespace uconfig
+
+#include "impl/FormatState.ipp"
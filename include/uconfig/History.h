@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace uconfig {
+
+/**
+ * Bounded history of immutable config versions for rollback.
+ *
+ * Versions are stored as snapshots, so a version is committed and rolled back to in O(1). Snapshots are the config
+ *  copies, which share the storage of uconfig::SharedSection and uconfig::SharedVector elements (and interned
+ *  strings): a section or vector left unchanged by a reparse is stored once for all the retained versions.
+ *
+ * @tparam T Type of the config, e.g. derivative of uconfig::Config.
+ */
+template <typename T>
+class ConfigHistory
+{
+public:
+    /**
+     * Constructor.
+     *
+     * @param[in] capacity Maximum number of retained versions, the oldest ones are dropped first.
+     */
+    explicit ConfigHistory(std::size_t capacity);
+
+    /// Copy constructor.
+    ConfigHistory(const ConfigHistory&) = delete;
+    /// Copy assignment.
+    ConfigHistory& operator=(const ConfigHistory&) = delete;
+
+    /**
+     * Commit new version.
+     *
+     * @param[in] value Config to store, copy of the config being reparsed shares unchanged sections with it.
+     *
+     * @returns Committed version number, starting from 1.
+     */
+    std::uint64_t Commit(T value);
+
+    /**
+     * Commit new version.
+     *
+     * @param[in] snapshot Config to store.
+     *
+     * @returns Committed version number, starting from 1.
+     */
+    std::uint64_t Commit(std::shared_ptr<const T> snapshot);
+
+    /**
+     * Roll back to a retained version by committing its' snapshot as a new version.
+     *
+     * @param[in] version Version to roll back to.
+     *
+     * @returns Snapshot of @p version, now the current one.
+     * @throws std::out_of_range Thrown if @p version is not retained.
+     */
+    std::shared_ptr<const T> Rollback(std::uint64_t version);
+
+    /// Get the last committed version or nullptr if there is none.
+    std::shared_ptr<const T> Current() const;
+    /// Get number of the last committed version, 0 if there is none.
+    std::uint64_t CurrentVersion() const;
+
+    /**
+     * Get a retained version.
+     *
+     * @param[in] version Version to get.
+     *
+     * @returns Snapshot of @p version or nullptr if it is not retained.
+     */
+    std::shared_ptr<const T> Get(std::uint64_t version) const;
+
+    /// Get numbers of the retained versions, oldest first.
+    std::vector<std::uint64_t> Versions() const;
+
+private:
+    /// Get snapshot of @p version, nullptr if it is not retained. Requires the lock.
+    const std::shared_ptr<const T>* Find(std::uint64_t version) const noexcept;
+    /// Append @p snapshot dropping the oldest one over the capacity. Requires the lock.
+    std::shared_ptr<const T> Push(std::shared_ptr<const T> snapshot);
+
+private:
+    mutable std::mutex mutex_;
+    std::size_t capacity_;
+    std::uint64_t first_version_ = 1; ///< Version of the first retained snapshot.
+    std::deque<std::shared_ptr<const T>> snapshots_;
+};
+
+} // namespace uconfig
+
+#include "impl/History.ipp"
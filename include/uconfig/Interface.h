@@ -1,8 +1,19 @@
 #pragma once
 
+#include "Budget.h"
+#include "Diff.h"
+#include "Fingerprint.h"
+#include "Interpolation.h"
 #include "Objects.h"
+#include "Profiler.h"
 
-#include <functional>
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <utility>
 
 namespace uconfig {
 
@@ -56,8 +67,166 @@ public:
     virtual bool Initialized() const noexcept = 0;
     /// Check if wrapped object declared as optional.
     virtual bool Optional() const noexcept = 0;
+
+    /**
+     * Append changes between the wrapped object and the same object of another config to @p changes.
+     * Objects without comparison support throw, see uconfig::Diff().
+     *
+     * @param[in] format Format instance to build paths with.
+     * @param[in] other Interface of the same object in another config.
+     * @param[out] changes Changes to append to.
+     *
+     * @throws uconfig::Error Thrown if @p other wraps a different object or objects can not be compared.
+     */
+    virtual void Diff(const format_type& format, const Interface<Format>& other, std::vector<Change>* changes) const;
+
+    /**
+     * Continue fingerprint @p hash with the value of the wrapped object, see Config::Fingerprint().
+     *
+     * @param[in] hash Hash to continue.
+     *
+     * @returns Continued hash.
+     * @throws uconfig::Error Thrown if the object can not be fingerprinted.
+     */
+    virtual std::uint64_t Fingerprint(std::uint64_t hash) const;
+};
+
+namespace detail {
+
+/// Memoization of a section parse, nested sections account into statistics of the outermost memoized config.
+class MemoScope
+{
+public:
+    MemoScope(MemoStats* stats) noexcept;
+    MemoScope(const MemoScope&) = delete;
+    MemoScope& operator=(const MemoScope&) = delete;
+    ~MemoScope();
+
+    /// Check if the section should be memoized.
+    bool Active() const noexcept;
+    /// Account parsed or skipped section.
+    void Account(bool skipped) noexcept;
+
+private:
+    /// Statistics of the memoized parse on the calling thread.
+    static MemoStats*& Current() noexcept;
+
+private:
+    MemoStats* previous_;
 };
 
+/*
+ * Control flow shared by interfaces of all the types and formats lives in non-template functions, so that it is
+ *  not instantiated for every combination of them.
+ */
+
+/**
+ * Run Validate() of @p object.
+ *
+ * @param[in] format_name Name of the format parsed from.
+ * @param[in] path Path to the object in terms of the format.
+ * @param[in] object Object to validate.
+ * @param[in] throw_on_fail Will throw an uconfig::ParseError if @p object is not valid.
+ *
+ * @returns true if @p object is valid, false otherwise.
+ * @throws uconfig::ParseError Thrown if @p throw_on_fail.
+ */
+bool validate_object(const std::string& format_name, const std::string& path, const Object& object,
+                     bool throw_on_fail);
+
+/// Throw uconfig::ParseError for the object at @p path failed for @p reason.
+[[noreturn]] void throw_parse_error(const std::string& format_name, const std::string& path, const char* reason);
+
+/// Throw uconfig::EmitError for the object at @p path failed for @p reason.
+[[noreturn]] void throw_emit_error(const std::string& format_name, const std::string& path, const char* reason);
+
+/**
+ * Check if the value of a variable has been found by the parse.
+ *
+ * @param[in] format_name Name of the format parsed from.
+ * @param[in] path Path to the variable in terms of the format.
+ * @param[in] found Whether the value has been found.
+ * @param[in] required Whether the variable has to be found, e.g. it is mandatory and has no value yet.
+ * @param[in] throw_on_fail Will throw an uconfig::ParseError if @p required variable is not found.
+ *
+ * @returns @p found.
+ * @throws uconfig::ParseError Thrown if @p throw_on_fail.
+ */
+bool check_found(const std::string& format_name, const std::string& path, bool found, bool required,
+                 bool throw_on_fail);
+
+/// Type-specific operation on the element of a vector at an index, called by the loops below.
+using ElementThunk = bool (*)(void* context, std::size_t index);
+
+/**
+ * Parse elements of a vector one by one, starting from the first one, until one is not found or fails.
+ *
+ * @param[in] parse_element Parse the element at an index and append it, returns false if there is no element.
+ * @param[in] context Context passed to @p parse_element.
+ * @param[out] error Error of the failed element.
+ *
+ * @returns Number of parsed elements.
+ * @throws uconfig::BudgetError Thrown by @p parse_element.
+ */
+std::size_t parse_elements(ElementThunk parse_element, void* context, std::optional<Error>* error);
+
+/**
+ * Complete the parse of a vector: check that a mandatory vector is set and validate it.
+ *
+ * @param[in] format_name Name of the format parsed from.
+ * @param[in] path Path to the vector in terms of the format.
+ * @param[in] vector Parsed vector.
+ * @param[in] parsed_size Number of parsed elements.
+ * @param[in] error Error of the failed element, if any.
+ * @param[in] throw_on_fail Will throw an uconfig::ParseError if @p vector is not valid.
+ *
+ * @returns true if any element has been parsed, false otherwise.
+ * @throws uconfig::ParseError Thrown if mandatory @p vector is not set or if @p throw_on_fail.
+ */
+bool complete_vector_parse(const std::string& format_name, const std::string& path, const Object& vector,
+                           std::size_t parsed_size, const std::optional<Error>& error, bool throw_on_fail);
+
+/**
+ * Emit elements of a vector one by one.
+ *
+ * @param[in] format_name Name of the format emitted to.
+ * @param[in] first_path Path to the first element, reported if there are no elements.
+ * @param[in] vector Emitted vector.
+ * @param[in] size Number of elements, 0 if @p vector is not set.
+ * @param[in] emit_element Emit the element at an index.
+ * @param[in] context Context passed to @p emit_element.
+ * @param[in] throw_on_fail Will throw an uconfig::EmitError if mandatory @p vector has no elements.
+ *
+ * @throws uconfig::EmitError Thrown if @p throw_on_fail.
+ */
+void emit_elements(const std::string& format_name, const std::string& first_path, const Object& vector,
+                   std::size_t size, ElementThunk emit_element, void* context, bool throw_on_fail);
+
+/// Context of emit_element().
+template <typename T, typename F>
+struct EmitContext
+{
+    const F* emitter;
+    typename F::dest_type* dest;
+    const std::string* path; ///< Path to the vector.
+    std::vector<T>* elements;
+    bool throw_on_fail;
+};
+
+/// Emit the element at @p index with the interface deduced for @p T, @p context is detail::EmitContext.
+template <typename T, typename F>
+bool emit_element(void* context, std::size_t index);
+
+/**
+ * Lock shared storages to access the sections stored in them in place, as registration of the sections modifies
+ *  them. Either storage may be null, the same storage is locked once.
+ */
+template <typename T>
+std::pair<std::unique_lock<std::mutex>, std::unique_lock<std::mutex>> lock_storages(SharedStorage<T>* storage,
+                                                                                    SharedStorage<T>* other = nullptr);
+
+} // namespace detail
+
 /**
  * Interface for uconfig::Config objects.
  *
@@ -128,12 +297,22 @@ public:
     virtual bool Initialized() const noexcept override;
     /// Check if wrapped uconfig::Config declared as optional.
     virtual bool Optional() const noexcept override;
+    /// Append changes between wrapped uconfig::Config and @p other to @p changes.
+    virtual void Diff(const format_type& format, const Interface<Format>& other,
+                      std::vector<Change>* changes) const override;
+    /// Continue fingerprint @p hash with the value of wrapped uconfig::Config.
+    virtual std::uint64_t Fingerprint(std::uint64_t hash) const override;
 
 private:
     std::string path_;
     bool cfg_optional_;
     std::vector<std::unique_ptr<Interface<format_type>>>* cfg_interfaces_;
-    std::function<void()> cfg_validate_;
+    const Object* cfg_object_;
+    detail::SubtreeMemo* cfg_memo_;
+    MemoStats* cfg_memo_stats_;
+    detail::FingerprintMemo* cfg_fingerprint_;
+    std::shared_ptr<InternPool>* cfg_intern_pool_;
+    bool cfg_interpolation_;
 };
 
 /**
@@ -204,6 +383,11 @@ public:
     virtual bool Initialized() const noexcept override;
     /// Check if wrapped value declared as optional.
     virtual bool Optional() const noexcept override;
+    /// Append changes between wrapped value and @p other to @p changes.
+    virtual void Diff(const format_type& format, const Interface<Format>& other,
+                      std::vector<Change>* changes) const override;
+    /// Continue fingerprint @p hash with the value of wrapped value.
+    virtual std::uint64_t Fingerprint(std::uint64_t hash) const override;
 
 private:
     std::string path_;
@@ -279,6 +463,11 @@ public:
     virtual bool Initialized() const noexcept override;
     /// Check if wrapped uconfig::Variable<> declared as optional.
     virtual bool Optional() const noexcept override;
+    /// Append changes between wrapped uconfig::Variable<> and @p other to @p changes.
+    virtual void Diff(const format_type& format, const Interface<Format>& other,
+                      std::vector<Change>* changes) const override;
+    /// Continue fingerprint @p hash with the value of wrapped uconfig::Variable<>.
+    virtual std::uint64_t Fingerprint(std::uint64_t hash) const override;
 
 private:
     std::string path_;
@@ -353,12 +542,288 @@ public:
     virtual bool Initialized() const noexcept override;
     /// Check if wrapped uconfig::Vector declared as optional.
     virtual bool Optional() const noexcept override;
+    /// Append changes between wrapped uconfig::Vector and @p other to @p changes.
+    virtual void Diff(const format_type& format, const Interface<Format>& other,
+                      std::vector<Change>* changes) const override;
+    /// Continue fingerprint @p hash with the value of wrapped uconfig::Vector.
+    virtual std::uint64_t Fingerprint(std::uint64_t hash) const override;
+
+private:
+    /// Make path to the element at @p index according to the @p format.
+    std::string ElementPath(const format_type& format, std::size_t index) const;
+
+    /**
+     * Parse elements on several threads if enabled for the vector and its' size is known up front.
+     *
+     * @param[in] parser Parser instance to use.
+     * @param[in] source Source to parse from.
+     * @param[out] parsed_size Number of elements parsed before the first failed one.
+     * @param[out] error Error of the first failed element.
+     *
+     * @returns true if elements have been parsed in parallel, false if they should be parsed sequentially.
+     */
+    bool ParseParallel(const format_type& parser, const source_type* source, std::size_t* parsed_size,
+                       std::optional<Error>* error);
+
+    /// Context of ParseElement().
+    struct ParseContext
+    {
+        VectorIface<T, Format>* iface;
+        const format_type* parser;
+        const source_type* source;
+    };
+
+    /// Parse the element at @p index and append it to the vector, see detail::parse_elements().
+    static bool ParseElement(void* context, std::size_t index);
 
 private:
     std::string path_;
     Vector<T>* vector_ptr_;
 };
 
+/**
+ * Interface for uconfig::SharedVector objects.
+ * Elements are parsed and emitted the same way as for uconfig::Vector.
+ *
+ * @tparam T Type of SharedVector elements.
+ * @tparam Format Format this interface interacts with.
+ */
+template <typename T, typename Format>
+class SharedVectorIface: public Interface<Format>
+{
+public:
+    /// Alias to the @p Format.
+    using typename Interface<Format>::format_type;
+    /// Alias to the @p Format::source_type.
+    using typename Interface<Format>::source_type;
+    /// Alias to the @p Format::dest_type.
+    using typename Interface<Format>::dest_type;
+
+    /**
+     * Constructor.
+     *
+     * @param[in] vector_path Path to the vector in terms of @p Format.
+     * @param[in] vector Pointer to the uconfig::SharedVector to wrap.
+     *
+     * @note Does not own @p vector, should not outlive it.
+     */
+    SharedVectorIface(const std::string& vector_path, SharedVector<T>* vector);
+
+    /// Copy constructor.
+    SharedVectorIface(const SharedVectorIface<T, Format>&) = default;
+    /// Copy assignment.
+    SharedVectorIface<T, Format>& operator=(const SharedVectorIface<T, Format>&) = default;
+    /// Move constructor.
+    SharedVectorIface(SharedVectorIface<T, Format>&&) noexcept = default;
+    /// Move assignment.
+    SharedVectorIface<T, Format>& operator=(SharedVectorIface<T, Format>&&) noexcept = default;
+
+    /// Destructor.
+    virtual ~SharedVectorIface() = default;
+
+    /**
+     * Parse referenced uconfig::SharedVector from @p source using @p parser.
+     * Keeps the storage if the vector has not changed.
+     *
+     * @param[in] parser Parser instance to use.
+     * @param[in] source Source to parse from.
+     * @param[in] throw_on_fail Will throw an uconfig::ParseError is failed to parse. Default true.
+     *
+     * @returns true if vector has been parsed, false otherwise.
+     * @throws uconfig::ParseError Thrown if @p throw_on_fail.
+     */
+    virtual bool Parse(const format_type& parser, const source_type* source, bool throw_on_fail = true) override;
+
+    /**
+     * Emit referenced uconfig::SharedVector to @p destination using @p emitter.
+     *
+     * @param[in] emitter Emitter instance to use.
+     * @param[in] dest Destination to emit into.
+     * @param[in] throw_on_fail Will throw an uconfig::EmitError is failed to emit. Default true.
+     *
+     * @throws uconfig::EmitError Thrown if @p throw_on_fail.
+     */
+    virtual void Emit(const format_type& emitter, dest_type* dest, bool throw_on_fail = true) override;
+
+    /// Get path of the wrapped uconfig::SharedVector.
+    virtual const std::string& Path() const noexcept override;
+    /// Check if wrapped uconfig::SharedVector has a value.
+    virtual bool Initialized() const noexcept override;
+    /// Check if wrapped uconfig::SharedVector declared as optional.
+    virtual bool Optional() const noexcept override;
+    /// Append changes between wrapped uconfig::SharedVector and @p other to @p changes.
+    virtual void Diff(const format_type& format, const Interface<Format>& other,
+                      std::vector<Change>* changes) const override;
+    /// Continue fingerprint @p hash with the value of wrapped uconfig::SharedVector.
+    virtual std::uint64_t Fingerprint(std::uint64_t hash) const override;
+
+private:
+    std::string path_;
+    SharedVector<T>* vector_ptr_;
+};
+
+/**
+ * Interface for uconfig::SharedSection objects.
+ * Section is parsed into a copy of the stored one, which replaces the storage afterwards.
+ *
+ * @tparam C Type of the section.
+ * @tparam Format Format this interface interacts with.
+ */
+template <typename C, typename Format>
+class SharedSectionIface: public Interface<Format>
+{
+public:
+    /// Alias to the @p Format.
+    using typename Interface<Format>::format_type;
+    /// Alias to the @p Format::source_type.
+    using typename Interface<Format>::source_type;
+    /// Alias to the @p Format::dest_type.
+    using typename Interface<Format>::dest_type;
+
+    /**
+     * Constructor.
+     *
+     * @param[in] section_path Path to the section in terms of @p Format.
+     * @param[in] section Pointer to the uconfig::SharedSection to wrap.
+     *
+     * @note Does not own @p section, should not outlive it.
+     */
+    SharedSectionIface(const std::string& section_path, SharedSection<C>* section);
+
+    /// Copy constructor.
+    SharedSectionIface(const SharedSectionIface<C, Format>&) = default;
+    /// Copy assignment.
+    SharedSectionIface<C, Format>& operator=(const SharedSectionIface<C, Format>&) = default;
+    /// Move constructor.
+    SharedSectionIface(SharedSectionIface<C, Format>&&) noexcept = default;
+    /// Move assignment.
+    SharedSectionIface<C, Format>& operator=(SharedSectionIface<C, Format>&&) noexcept = default;
+
+    /// Destructor.
+    virtual ~SharedSectionIface() = default;
+
+    /**
+     * Parse referenced uconfig::SharedSection from @p source using @p parser.
+     * Keeps the storage if the source subtree has not changed.
+     *
+     * @param[in] parser Parser instance to use.
+     * @param[in] source Source to parse from.
+     * @param[in] throw_on_fail Will throw an uconfig::ParseError is failed to parse. Default true.
+     *
+     * @returns true if section has been parsed, false otherwise.
+     * @throws uconfig::ParseError Thrown if @p throw_on_fail.
+     */
+    virtual bool Parse(const format_type& parser, const source_type* source, bool throw_on_fail = true) override;
+
+    /**
+     * Emit referenced uconfig::SharedSection to @p destination using @p emitter.
+     *
+     * @param[in] emitter Emitter instance to use.
+     * @param[in] dest Destination to emit into.
+     * @param[in] throw_on_fail Will throw an uconfig::EmitError is failed to emit. Default true.
+     *
+     * @throws uconfig::EmitError Thrown if @p throw_on_fail.
+     */
+    virtual void Emit(const format_type& emitter, dest_type* dest, bool throw_on_fail = true) override;
+
+    /// Get path of the wrapped uconfig::SharedSection.
+    virtual const std::string& Path() const noexcept override;
+    /// Check if wrapped uconfig::SharedSection has been parsed.
+    virtual bool Initialized() const noexcept override;
+    /// Check if wrapped uconfig::SharedSection declared as optional.
+    virtual bool Optional() const noexcept override;
+    /// Append changes between wrapped uconfig::SharedSection and @p other to @p changes.
+    virtual void Diff(const format_type& format, const Interface<Format>& other,
+                      std::vector<Change>* changes) const override;
+    /// Continue fingerprint @p hash with the value of wrapped uconfig::SharedSection.
+    virtual std::uint64_t Fingerprint(std::uint64_t hash) const override;
+
+private:
+    std::string path_;
+    SharedSection<C>* section_ptr_;
+};
+
+/**
+ * Interface for uconfig::LazyConfig objects.
+ * Parse records the source of the section to be parsed on the first access.
+ *
+ * @tparam C Type of the section.
+ * @tparam Format Format this interface interacts with.
+ */
+template <typename C, typename Format>
+class LazyConfigIface: public Interface<Format>
+{
+public:
+    /// Alias to the @p Format.
+    using typename Interface<Format>::format_type;
+    /// Alias to the @p Format::source_type.
+    using typename Interface<Format>::source_type;
+    /// Alias to the @p Format::dest_type.
+    using typename Interface<Format>::dest_type;
+
+    /**
+     * Constructor.
+     *
+     * @param[in] section_path Path to the section in terms of @p Format.
+     * @param[in] section Pointer to the uconfig::LazyConfig to wrap.
+     *
+     * @note Does not own @p section, should not outlive it.
+     */
+    LazyConfigIface(const std::string& section_path, LazyConfig<C>* section);
+
+    /// Copy constructor.
+    LazyConfigIface(const LazyConfigIface<C, Format>&) = default;
+    /// Copy assignment.
+    LazyConfigIface<C, Format>& operator=(const LazyConfigIface<C, Format>&) = default;
+    /// Move constructor.
+    LazyConfigIface(LazyConfigIface<C, Format>&&) noexcept = default;
+    /// Move assignment.
+    LazyConfigIface<C, Format>& operator=(LazyConfigIface<C, Format>&&) noexcept = default;
+
+    /// Destructor.
+    virtual ~LazyConfigIface() = default;
+
+    /**
+     * Record @p source of referenced uconfig::LazyConfig to be parsed with @p parser on the first access.
+     * Section is parsed right away during a strict parse.
+     *
+     * @param[in] parser Parser instance to use.
+     * @param[in] source Source to parse from.
+     * @param[in] throw_on_fail Will throw an uconfig::ParseError is failed to parse. Default true.
+     *
+     * @returns true if section has been recorded or parsed, false otherwise.
+     * @throws uconfig::ParseError Thrown if @p throw_on_fail and the section is parsed right away.
+     */
+    virtual bool Parse(const format_type& parser, const source_type* source, bool throw_on_fail = true) override;
+
+    /**
+     * Emit referenced uconfig::LazyConfig to @p destination using @p emitter, parsing it if not yet.
+     *
+     * @param[in] emitter Emitter instance to use.
+     * @param[in] dest Destination to emit into.
+     * @param[in] throw_on_fail Will throw an uconfig::EmitError is failed to emit. Default true.
+     *
+     * @throws uconfig::EmitError Thrown if @p throw_on_fail.
+     */
+    virtual void Emit(const format_type& emitter, dest_type* dest, bool throw_on_fail = true) override;
+
+    /// Get path of the wrapped uconfig::LazyConfig.
+    virtual const std::string& Path() const noexcept override;
+    /// Check if wrapped uconfig::LazyConfig has been recorded or parsed.
+    virtual bool Initialized() const noexcept override;
+    /// Check if wrapped uconfig::LazyConfig declared as optional.
+    virtual bool Optional() const noexcept override;
+    /// Append changes between wrapped uconfig::LazyConfig and @p other to @p changes.
+    virtual void Diff(const format_type& format, const Interface<Format>& other,
+                      std::vector<Change>* changes) const override;
+    /// Continue fingerprint @p hash with the value of wrapped uconfig::LazyConfig.
+    virtual std::uint64_t Fingerprint(std::uint64_t hash) const override;
+
+private:
+    std::string path_;
+    LazyConfig<C>* lazy_ptr_;
+};
+
 } // namespace uconfig
 
 #include "impl/Interface.ipp"
@@ -0,0 +1,166 @@
+#pragma once
+
+#include "detail/detail.h"
+
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+
+namespace uconfig {
+
+/**
+ * Immutable string value, deduplicated through uconfig::InternPool.
+ * Equal strings interned into the same pool share the storage and are compared by pointer. Interned strings keep
+ *  the pool alive, so they may outlive the config they were parsed into.
+ * Parsed and emitted as a `std::string`, so no format-specific code is required.
+ */
+class InternedString
+{
+public:
+    /// Constructor. Empty string.
+    InternedString() noexcept;
+    /// Constructor. String not deduplicated with any other.
+    explicit InternedString(std::string value);
+    /// Constructor. String stored in a pool.
+    explicit InternedString(std::shared_ptr<const std::string> value) noexcept;
+
+    /// Get the string.
+    const std::string& Get() const noexcept;
+    /// Get the string.
+    operator const std::string&() const noexcept;
+    /// Get the string.
+    operator std::string_view() const noexcept;
+
+    /// Compare strings, by pointer if they share the storage.
+    friend bool operator==(const InternedString& lhs, const InternedString& rhs) noexcept;
+    /// Compare strings.
+    friend bool operator!=(const InternedString& lhs, const InternedString& rhs) noexcept;
+    /// Compare strings.
+    friend bool operator<(const InternedString& lhs, const InternedString& rhs) noexcept;
+    /// Compare with a string.
+    friend bool operator==(const InternedString& lhs, std::string_view rhs) noexcept;
+    /// Compare with a string.
+    friend bool operator==(std::string_view lhs, const InternedString& rhs) noexcept;
+    /// Compare with a string.
+    friend bool operator!=(const InternedString& lhs, std::string_view rhs) noexcept;
+    /// Compare with a string.
+    friend bool operator!=(std::string_view lhs, const InternedString& rhs) noexcept;
+    /// Print the string.
+    friend std::ostream& operator<<(std::ostream& out, const InternedString& value);
+
+private:
+    std::shared_ptr<const std::string> value_;
+};
+
+/**
+ * Pool of unique strings.
+ * Each unique string is stored once for the lifetime of the pool. Thread-safe.
+ */
+class InternPool: public std::enable_shared_from_this<InternPool>
+{
+public:
+    /// Create an empty pool.
+    static std::shared_ptr<InternPool> Create();
+
+    /// Copy constructor.
+    InternPool(const InternPool&) = delete;
+    /// Copy assignment.
+    InternPool& operator=(const InternPool&) = delete;
+
+    /**
+     * Intern @p value. Does not allocate if such string is already in the pool.
+     *
+     * @param[in] value String to intern.
+     *
+     * @returns Interned string sharing storage with all equal strings of the pool.
+     */
+    InternedString Intern(std::string_view value);
+
+    /// Get number of unique strings in the pool.
+    std::size_t Size() const;
+    /// Get total length of unique strings in the pool.
+    std::size_t Bytes() const;
+
+    /// Pool attached to the calling thread while a config with interning enabled is parsed.
+    static InternPool* Current() noexcept;
+
+    /// Attachment of a pool to the calling thread, nested attachments override outer ones.
+    class Scope
+    {
+    public:
+        explicit Scope(InternPool* pool) noexcept;
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+        ~Scope();
+
+    private:
+        InternPool* previous_;
+    };
+
+private:
+    InternPool() = default;
+
+    /// Pool attached to the calling thread.
+    static InternPool*& CurrentRef() noexcept;
+
+private:
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string_view, const std::string*> index_;
+    std::deque<std::string> storage_;
+    std::size_t bytes_ = 0;
+};
+
+namespace detail {
+
+/// Intern @p value into the current pool of the thread, if any.
+InternedString intern(std::string_view value);
+
+/**
+ * Parse value of type @p T at @p path from @p source using @p parser.
+ * Interned strings are parsed as std::string, or as a view into the source if the format allows it.
+ */
+template <typename T, typename F>
+std::optional<T> parse_value(const F& parser, const typename F::source_type* source, const std::string& path)
+{
+    if constexpr (!std::is_same<T, InternedString>::value) {
+        return parser.template Parse<T>(source, path);
+    } else if constexpr (has_string_view<F>::value) {
+        const std::optional<std::string_view> value = parser.StringView(source, path);
+        if (!value) {
+            return std::nullopt;
+        }
+        return intern(*value);
+    } else {
+        const std::optional<std::string> value = parser.template Parse<std::string>(source, path);
+        if (!value) {
+            return std::nullopt;
+        }
+        return intern(*value);
+    }
+}
+
+/// Value to emit in place of @p value, interned strings are emitted as std::string.
+template <typename T>
+const T& emit_value(const T& value) noexcept
+{
+    return value;
+}
+
+/// Value to emit in place of @p value, interned strings are emitted as std::string.
+inline const std::string& emit_value(const InternedString& value) noexcept
+{
+    return value.Get();
+}
+
+} // namespace detail
+
+} // namespace uconfig
+
+#include "impl/Intern.ipp"
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "Objects.h"
+
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace uconfig {
+
+/**
+ * Resolver of placeholders in string values of a parse, see Config::SetInterpolation().
+ *
+ * While attached to the calling thread (and workers of parallel vector parsing), string values are parsed with
+ *  their placeholders substituted:
+ *  - `${other.key}` with the value at the referenced path of the same source. Format may define
+ *    `std::string ReferencePath(const std::string& reference) const` to map references to its' paths, otherwise
+ *    references are paths as is;
+ *  - `${env:NAME}` with the environment variable `NAME`;
+ *  - `$${` with literal `${`.
+ * Referenced values may contain placeholders as well. Each path is resolved once per parse and memoized, so
+ *  references form a dependency graph walked depth-first, a reference back to a path being resolved is a cycle.
+ * Resolution costs a load of a thread-local pointer if there is no interpolation.
+ */
+class Interpolation
+{
+public:
+    /// Constructor.
+    Interpolation() = default;
+    /// Copy constructor.
+    Interpolation(const Interpolation&) = delete;
+    /// Copy assignment.
+    Interpolation& operator=(const Interpolation&) = delete;
+
+    /**
+     * Parse string at @p path from @p source with its' placeholders substituted.
+     *
+     * @tparam F Type of the parser.
+     *
+     * @param[in] parser Parser instance to use.
+     * @param[in] source Source to parse from.
+     * @param[in] path Path to the string.
+     *
+     * @returns Resolved string or std::nullopt if there is no string at @p path.
+     * @throws uconfig::ParseError Thrown if a reference is not resolved or forms a cycle.
+     */
+    template <typename F>
+    std::optional<std::string> Resolve(const F& parser, const typename F::source_type* source,
+                                       const std::string& path);
+
+    /// Get number of paths resolved so far.
+    std::size_t Size() const;
+
+    /// Interpolation attached to the calling thread.
+    static Interpolation* Current() noexcept;
+
+    /// Attachment of an interpolation to the calling thread, nested attachments override outer ones.
+    class Scope
+    {
+    public:
+        explicit Scope(Interpolation* interpolation) noexcept;
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+        ~Scope();
+
+    private:
+        Interpolation* previous_;
+    };
+
+private:
+    /// Resolve string at @p path, @p chain holds paths being resolved.
+    template <typename F>
+    std::optional<std::string> Resolve(const F& parser, const typename F::source_type* source,
+                                       const std::string& path, std::vector<std::string>& chain);
+    /// Resolve value of any scalar type at @p path as a string.
+    template <typename F>
+    std::optional<std::string> ResolveReference(const F& parser, const typename F::source_type* source,
+                                                const std::string& path, std::vector<std::string>& chain);
+    /// Substitute placeholders of @p value parsed at @p path.
+    template <typename F>
+    std::string Expand(const F& parser, const typename F::source_type* source, std::string_view value,
+                       std::vector<std::string>& chain);
+
+    /// Find memoized string at @p path.
+    bool Find(const std::string& path, std::optional<std::string>* value) const;
+    /// Memoize string at @p path.
+    void Store(const std::string& path, const std::optional<std::string>& value);
+
+    /// Interpolation attached to the calling thread.
+    static Interpolation*& CurrentRef() noexcept;
+
+private:
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, std::optional<std::string>> resolved_;
+};
+
+namespace detail {
+
+/// Throw uconfig::ParseError for a placeholder of the string at @p path.
+[[noreturn]] void throw_interpolation_error(const std::string& format_name, const std::string& path,
+                                            const std::string& reason);
+
+/**
+ * Parse value of type @p T at @p path from @p source using @p parser.
+ * Strings have their placeholders substituted if an interpolation is attached to the calling thread.
+ */
+template <typename T, typename F>
+std::optional<T> parse_interpolated(const F& parser, const typename F::source_type* source, const std::string& path)
+{
+    if constexpr (std::is_same<T, std::string>::value || std::is_same<T, InternedString>::value) {
+        if (Interpolation* interpolation = Interpolation::Current()) {
+            std::optional<std::string> value = interpolation->Resolve(parser, source, path);
+            if constexpr (std::is_same<T, InternedString>::value) {
+                if (value) {
+                    return intern(*value);
+                }
+                return std::nullopt;
+            } else {
+                return value;
+            }
+        }
+    }
+    return parse_value<T>(parser, source, path);
+}
+
+} // namespace detail
+
+} // namespace uconfig
+
+#include "impl/Interpolation.ipp"
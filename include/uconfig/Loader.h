@@ -0,0 +1,175 @@
+#pragma once
+
+#include "Objects.h"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#if !defined(UCONFIG_NO_IO_URING) && defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define UCONFIG_IO_URING 1
+#endif
+
+namespace uconfig {
+namespace detail {
+
+#ifdef UCONFIG_IO_URING
+
+/// Submission and completion rings of io_uring instance, set up with raw syscalls.
+class IoUring
+{
+public:
+    IoUring() = default;
+    IoUring(const IoUring&) = delete;
+    IoUring& operator=(const IoUring&) = delete;
+    ~IoUring();
+
+    /// Set up the rings for @p entries requests. Returns errno on failure.
+    int Setup(unsigned entries) noexcept;
+    /// Number of submission entries.
+    unsigned Capacity() const noexcept;
+
+    /// Queue readv of @p iov at @p offset of @p fd. Requests in flight should not exceed Capacity().
+    void PushRead(int fd, const void* iov, std::uint64_t offset, std::uint64_t user_data) noexcept;
+    /// Submit queued requests and wait for at least @p min_complete completions. Returns errno on failure.
+    int Enter(unsigned min_complete) noexcept;
+    /// Wait for at least @p min_complete completions without submitting. Returns errno on failure.
+    int Wait(unsigned min_complete) noexcept;
+    /// Pop a completion if any, @p result is the number of bytes read or -errno.
+    bool PopCompletion(std::uint64_t* user_data, int* result) noexcept;
+    /// Number of requests queued but not submitted yet.
+    unsigned Queued() const noexcept;
+
+    /// Unmap the rings and close the instance. Queued requests are never submitted.
+    void Reset() noexcept;
+
+private:
+    int fd_ = -1;
+    void* sq_ring_ = nullptr;
+    std::size_t sq_ring_size_ = 0;
+    void* cq_ring_ = nullptr;
+    std::size_t cq_ring_size_ = 0;
+    void* sqes_ = nullptr;
+    std::size_t sqes_size_ = 0;
+
+    unsigned* sq_head_ = nullptr;
+    unsigned* sq_tail_ = nullptr;
+    unsigned* sq_mask_ = nullptr;
+    unsigned* sq_array_ = nullptr;
+    unsigned* cq_head_ = nullptr;
+    unsigned* cq_tail_ = nullptr;
+    unsigned* cq_mask_ = nullptr;
+    void* cqes_ = nullptr;
+    unsigned entries_ = 0;
+    unsigned queued_ = 0;
+};
+
+#endif
+
+} // namespace detail
+
+/**
+ * Batched loader of config files, e.g. JSON fragments read on every reload.
+ *
+ * All reads of a batch are submitted at once and contents are handed to the caller as reads complete, so parsing
+ *  of the first fragments overlaps with reading of the rest. On Linux reads are submitted through io_uring,
+ *  otherwise (or if io_uring is not permitted) files are read by a small set of threads.
+ * Define `UCONFIG_NO_IO_URING` to build without io_uring.
+ *
+ * Loader is not thread-safe, use one per reloading thread.
+ */
+class FileLoader
+{
+public:
+    /// Name of the loader. Used to form nice error-strings.
+    static inline const std::string name = "[LOADER]";
+
+    /// Way to read the files.
+    enum class Backend
+    {
+        Auto,    ///< io_uring if available, threads otherwise.
+        IoUring, ///< io_uring only.
+        Threads, ///< Blocking reads on a set of threads.
+    };
+
+    /**
+     * Handler of the loaded file, called on the thread calling Load() in order of completion.
+     *
+     * @param[in] index Index of the file in the batch.
+     * @param[in] contents Contents of the file.
+     */
+    using Handler = std::function<void(std::size_t index, std::string&& contents)>;
+
+    /**
+     * Constructor.
+     *
+     * @param[in] backend Way to read the files. Default uconfig::FileLoader::Backend::Auto.
+     * @param[in] queue_depth Maximum number of reads in flight. Default 64.
+     * @param[in] threads Number of threads to read on if io_uring is not used. Default 4.
+     *
+     * @throws uconfig::Error Thrown if @p backend is io_uring and it is not available.
+     */
+    explicit FileLoader(Backend backend = Backend::Auto, std::size_t queue_depth = 64, std::size_t threads = 4);
+
+    /// Copy constructor.
+    FileLoader(const FileLoader&) = delete;
+    /// Copy assignment.
+    FileLoader& operator=(const FileLoader&) = delete;
+
+    /// Destructor.
+    ~FileLoader() = default;
+
+    /**
+     * Read all the @p paths, handing contents of every file to @p handler as soon as it is read.
+     * If some file fails to be read or @p handler throws, reads in flight are awaited and the error is rethrown,
+     *  remaining files are not handled.
+     *
+     * @param[in] paths Paths to the files.
+     * @param[in] handler Handler of the loaded files.
+     *
+     * @throws uconfig::ParseError Thrown if some file failed to be read.
+     */
+    void Load(const std::vector<std::string>& paths, const Handler& handler);
+
+    /**
+     * Read all the @p paths.
+     *
+     * @param[in] paths Paths to the files.
+     *
+     * @returns Contents of the files in order of @p paths.
+     *
+     * @throws uconfig::ParseError Thrown if some file failed to be read.
+     */
+    std::vector<std::string> Load(const std::vector<std::string>& paths);
+
+    /// Get the backend in use, either io_uring or threads.
+    Backend Used() const noexcept;
+
+private:
+    /// Read @p paths through io_uring.
+    void LoadIoUring(const std::vector<std::string>& paths, const Handler& handler);
+    /**
+     * Reap @p in_flight requests of an interrupted LoadIoUring() and set the ring up anew.
+     * Returns false if some submitted request may still complete into its' buffer.
+     */
+    bool AbortIoUring(std::size_t in_flight) noexcept;
+    /// Read @p paths on threads.
+    void LoadThreads(const std::vector<std::string>& paths, const Handler& handler);
+
+    /// Read the whole file @p path into @p contents. Returns errno on failure.
+    static int ReadFile(const std::string& path, std::string* contents);
+    /// Make uconfig::ParseError for @p path failed with @p error.
+    static ParseError ReadError(const std::string& path, int error);
+
+private:
+    Backend backend_;
+    std::size_t queue_depth_;
+    std::size_t threads_;
+#ifdef UCONFIG_IO_URING
+    detail::IoUring ring_;
+#endif
+};
+
+} // namespace uconfig
+
+#include "impl/Loader.ipp"
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <typeinfo>
+
+// Config::Parse() calls are counted unless UCONFIG_NO_METRICS is defined.
+#ifndef UCONFIG_NO_METRICS
+#define UCONFIG_PARSE_METRICS(observer, type, format) ::uconfig::detail::ParseObserver observer(type, format)
+#define UCONFIG_PARSE_RESULT(observer, parsed) observer.Complete(parsed)
+#else
+#define UCONFIG_PARSE_METRICS(observer, type, format)
+#define UCONFIG_PARSE_RESULT(observer, parsed) (parsed)
+#endif
+
+namespace uconfig {
+namespace detail {
+
+/// Metrics of parsing of a single config type from a single format.
+struct MetricSeries
+{
+    /// Series state: empty, being claimed, ready.
+    enum State : int
+    {
+        kEmpty = 0,
+        kClaimed = 1,
+        kReady = 2,
+    };
+    /// Number of the histogram buckets with upper bounds, +Inf one excluded.
+    static constexpr std::size_t kBuckets = 12;
+
+    std::atomic<int> state{kEmpty};
+    const std::type_info* type = nullptr;
+    const std::string* format = nullptr;
+    /// Readable name of the config type, truncated if too long.
+    char type_name[96] = {};
+
+    std::atomic<std::uint64_t> parses{0};
+    std::atomic<std::uint64_t> failures{0};
+    std::atomic<std::uint64_t> duration_ns{0};
+    /// Non-cumulative bucket counters, the last one is +Inf.
+    std::array<std::atomic<std::uint64_t>, kBuckets + 1> buckets{};
+    std::atomic<std::int64_t> last_success_ms{0};
+};
+
+/// Observer of a single Config::Parse() call, the call is failed unless completed with a successful result.
+class ParseObserver
+{
+public:
+    ParseObserver(const std::type_info& type, const std::string& format) noexcept;
+    ParseObserver(const ParseObserver&) = delete;
+    ParseObserver& operator=(const ParseObserver&) = delete;
+    ~ParseObserver();
+
+    /// Record result @p parsed of the call, returns it as is.
+    bool Complete(bool parsed) noexcept;
+
+private:
+    MetricSeries* series_;
+    std::chrono::steady_clock::time_point start_;
+    bool failed_ = true;
+};
+
+} // namespace detail
+
+/**
+ * Reload health metrics of all the parsed config types, rendered in Prometheus text exposition format.
+ *
+ * Every Config::Parse() call is counted per dynamic config type and format: number of calls, number of calls
+ *  failed (ended with an exception or returned false), latency histogram, number of successful parses (config
+ *  generation) and time of the last successful one. Counters are lock-free atomics in a fixed-size table, neither
+ *  counting nor rendering allocates (except demangling of the type name on the first parse of a type).
+ * Define `UCONFIG_NO_METRICS` to compile counting out.
+ */
+class ParseMetrics
+{
+public:
+    /// Maximum number of (config type, format) series, parses of the types beyond are not counted.
+    static constexpr std::size_t kCapacity = 128;
+    /// Upper bounds of the latency histogram buckets in microseconds.
+    static constexpr std::array<std::uint64_t, detail::MetricSeries::kBuckets> kBucketBoundsUs = {
+        100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000, 1000000, 10000000};
+
+    /// Get process-wide metrics.
+    static ParseMetrics& Global() noexcept;
+
+    /// Copy constructor.
+    ParseMetrics(const ParseMetrics&) = delete;
+    /// Copy assignment.
+    ParseMetrics& operator=(const ParseMetrics&) = delete;
+
+    /**
+     * Get series of the config @p type parsed from @p format, registering it on the first call.
+     *
+     * @param[in] type Dynamic type of the config.
+     * @param[in] format Name of the format, should have static storage duration, e.g. `F::name`.
+     *
+     * @returns Series or nullptr if the table is full.
+     */
+    detail::MetricSeries* Series(const std::type_info& type, const std::string& format) noexcept;
+
+    /**
+     * Account a parse.
+     *
+     * @param[in] series Series of the parsed config.
+     * @param[in] duration Duration of the parse.
+     * @param[in] failed Whether the parse has failed.
+     */
+    static void Observe(detail::MetricSeries* series, std::chrono::nanoseconds duration, bool failed) noexcept;
+
+    /**
+     * Render metrics in Prometheus text exposition format.
+     * Output is truncated to @p size and always null-terminated if @p size is not zero.
+     *
+     * @param[out] buffer Buffer to render into.
+     * @param[in] size Size of the buffer.
+     *
+     * @returns Length of the whole output excluding the terminating null, may exceed @p size.
+     */
+    std::size_t Render(char* buffer, std::size_t size) const noexcept;
+
+private:
+    ParseMetrics() = default;
+
+    /// Demangle name of @p type into @p series.
+    static void SetTypeName(detail::MetricSeries* series, const std::type_info& type) noexcept;
+
+private:
+    std::array<detail::MetricSeries, kCapacity> series_;
+};
+
+} // namespace uconfig
+
+#include "impl/Metrics.ipp"
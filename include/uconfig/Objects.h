@@ -1,10 +1,20 @@
 #pragma once
 
+#include "FormatState.h"
+#include "Intern.h"
+#include "Metrics.h"
+#include "Strict.h"
+#include "Trace.h"
 #include "detail/detail.h"
 
+#include <atomic>
+#include <exception>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <stdexcept>
+#include <tuple>
 #include <typeindex>
 #include <unordered_set>
 #include <vector>
@@ -29,6 +39,47 @@ struct EmitError: public Error
     using Error::Error;
 };
 
+/// Statistics of memoized parsing, see Config::SetMemoize().
+struct MemoStats
+{
+    std::size_t parsed = 0;  ///< Number of sections parsed.
+    std::size_t skipped = 0; ///< Number of sections skipped as unchanged.
+};
+
+namespace detail {
+
+/// Hash of the source subtree of a section at its' last successful parse.
+struct SubtreeMemo
+{
+    const std::string* format = nullptr;
+    std::uint64_t hash = 0;
+    bool parsed = false;
+};
+
+/// Fingerprint of a section computed after its' last parse.
+struct FingerprintMemo
+{
+    const std::string* format = nullptr;
+    std::uint64_t hash = 0;
+};
+
+/// Storage of uconfig::SharedVector and uconfig::SharedSection shared by their copies.
+template <typename T>
+struct SharedStorage
+{
+    template <typename... Args>
+    explicit SharedStorage(Args&&... args)
+        : value(std::forward<Args>(args)...)
+    {
+    }
+
+    T value;
+    std::mutex mutex;      ///< Serializes registration of the sections stored in the value.
+    bool modified = false; ///< Whether the value has been handed out to modify, so cached fingerprints are stale.
+};
+
+} // namespace detail
+
 /// Abstract object interface.
 class Object
 {
@@ -89,7 +140,7 @@ public:
      *  Default true.
      *
      * @returns true if config has been found in some form in the @p source, false otherwise.
-     * @throws uconfig::ParseError Thrown if @p throw_on_fail.
+     * @throws uconfig::ParseError Thrown if @p throw_on_fail, also if strict parse has found unknown keys.
      */
     template <typename F>
     bool Parse(const F& parser, const std::string& path, const typename F::source_type* source,
@@ -124,6 +175,86 @@ public:
      */
     virtual bool Optional() const noexcept override;
 
+    /**
+     * Enable memoization of parsing for this config and all its' nested sections.
+     * Each section remembers a hash of its' source subtree and skips conversion and Validate() entirely if the
+     *  hash has not changed since its' last successful parse (with `throw_on_fail`) from the same format.
+     *  Format should define `SubtreeHash()`, otherwise sections are always parsed.
+     *
+     * @param[in] enable Whether to memoize parsing.
+     *
+     * @note Values modified after the parse are not restored in the skipped sections.
+     */
+    void SetMemoize(bool enable) noexcept;
+
+    /**
+     * Get statistics of memoized parses of this config, accumulated over all of them.
+     *
+     * @returns Number of parsed and skipped sections.
+     */
+    const MemoStats& Memo() const noexcept;
+
+    /**
+     * Enable deduplication of uconfig::InternedString values of this config and all its' nested sections.
+     * Every parse interns the strings into a new pool, so each unique value is stored once and strings of the
+     *  previous parse are released along with the values holding them.
+     *
+     * @param[in] enable Whether to intern strings.
+     */
+    void SetInterning(bool enable) noexcept;
+
+    /**
+     * Get pool of the strings interned by the last parse.
+     *
+     * @returns Pool or nullptr if interning is not enabled or config has not been parsed yet.
+     */
+    const std::shared_ptr<InternPool>& StringPool() const noexcept;
+
+    /**
+     * Enable strict parsing of this config: keys of the source in the config section which no element has
+     *  consumed are reported after the parse. Keys are tracked during the parse itself, so the source is not
+     *  walked twice and no paths are compared. Format should define `UnknownKeys()`, otherwise strict parse fails
+     *  with uconfig::ParseError. Memoized sections are always parsed during a strict parse.
+     *
+     * @param[in] enable Whether to parse strictly.
+     */
+    void SetStrict(bool enable) noexcept;
+
+    /**
+     * Get keys of the source unknown to the config, found by the last strict parse.
+     *
+     * @returns Paths to the unknown keys in terms of the format.
+     */
+    const std::vector<std::string>& UnknownKeys() const noexcept;
+
+    /**
+     * Enable interpolation of string values of this config and all its' nested sections: placeholders
+     *  `${other.key}` are substituted with values at the referenced paths of the same source and `${env:NAME}`
+     *  with environment variables, see uconfig::Interpolation. Each referenced path is resolved once per parse,
+     *  so parsed values are plain strings. Memoized sections are always parsed during an interpolated parse.
+     *
+     * @param[in] enable Whether to interpolate values.
+     */
+    void SetInterpolation(bool enable) noexcept;
+
+    /**
+     * Get fingerprint of the config values, e.g. to deduplicate configs or to key caches by their content.
+     * Values of the elements registered for @p F are hashed in order of registration with 64-bit FNV-1a, tagged
+     *  with their kind, so e.g. `1` and `"1"` differ. Fingerprints of the config and its' nested sections are
+     *  cached until they are parsed again, so repeated calls are O(1) and a reload with memoization only hashes
+     *  the changed sections.
+     *
+     * @tparam F Type of the format to take the registered elements of. Default first of FormatTs.
+     *
+     * @returns Fingerprint, the same for equal values of the config in any process of the same platform.
+     * @throws uconfig::Error Thrown if a value is neither of a built-in type nor printable with operator<<.
+     *
+     * @note Values modified after the parse are not accounted in the cached fingerprint. Elements are registered
+     *  on the first call, so it should not be concurrent with other uses of the config.
+     */
+    template <typename F = std::tuple_element_t<0, std::tuple<FormatTs...>>>
+    std::uint64_t Fingerprint() const;
+
 protected:
     /**
      * Initialize config before parsing.
@@ -161,6 +292,15 @@ private:
 
 private:
     bool optional_ = false;
+    bool memoize_ = false;
+    MemoStats memo_stats_;
+    detail::SubtreeMemo memo_;
+    bool interning_ = false;
+    std::shared_ptr<InternPool> intern_pool_;
+    bool strict_ = false;
+    std::vector<std::string> unknown_keys_;
+    bool interpolation_ = false;
+    mutable detail::FingerprintMemo fingerprint_;
     std::unordered_set<Object*> elements_;
     std::unordered_set<std::type_index> register_formats_;
     std::tuple<std::vector<std::unique_ptr<Interface<FormatTs>>>...> interfaces_;
@@ -382,6 +522,17 @@ public:
      */
     const T& operator[](std::size_t pos) const;
 
+    /**
+     * Parse elements in parallel.
+     * Applies if the format knows size of the vector up front (e.g. JSON and YAML arrays). Elements are split into
+     *  chunks parsed and validated on separate threads into pre-sized storage, so validation of the elements
+     *  should be thread-safe. Parsed elements and reported error are the same as for sequential parsing.
+     *
+     * @param[in] threads Maximum number of threads to use, 1 disables parallel parsing.
+     * @param[in] min_chunk_size Minimum number of elements per thread. Default 1024.
+     */
+    void SetParallel(std::size_t threads, std::size_t min_chunk_size = 1024) noexcept;
+
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 
     // operator== for Vector<Variable<V>> and std::vector<V>.
@@ -389,6 +540,338 @@ public:
     friend bool operator==(const Vector<Variable<V>>& lhs, const std::vector<V>& rhs);
 
 #endif /* DOXYGEN_SHOULD_SKIP_THIS */
+
+protected:
+    std::size_t parallel_threads_ = 1;       ///< Maximum number of threads to parse elements on.
+    std::size_t parallel_chunk_size_ = 1024; ///< Minimum number of elements per thread.
+};
+
+/**
+ * Vector object with immutable copy-on-write storage.
+ * Copies of the vector share the storage, so copying a config is O(1) for such vectors. If the format defines
+ *  `SubtreeHash()`, a vector whose source subtree has not changed since the last parse keeps its' storage without
+ *  parsing the elements, otherwise the storage is kept if parsed elements are equal to the stored ones. Elements
+ *  are emitted, compared and fingerprinted in place, uses of the storage registering sections among them are
+ *  serialized.
+ *
+ * @tparam T Type to form vector of.
+ */
+template <typename T>
+class SharedVector: public Object
+{
+public:
+    template <typename F>
+    using iface_type = SharedVectorIface<T, F>;
+
+    template <typename U, typename F>
+    friend class SharedVectorIface;
+
+    /**
+     * Constructor.
+     *
+     * @param[in] optional If vector considered to be optional (may be not initialized). Default false.
+     */
+    SharedVector(bool optional = false);
+    /// Constructor.
+    SharedVector(std::vector<T> init_value);
+
+    /// Copy constructor. Shares the storage.
+    SharedVector(const SharedVector<T>&) = default;
+    /// Copy assignment. Shares the storage.
+    SharedVector<T>& operator=(const SharedVector<T>&) = default;
+    /// Move constructor.
+    SharedVector(SharedVector<T>&& other) noexcept = default;
+    /// Move assignment.
+    SharedVector<T>& operator=(SharedVector<T>&& other) noexcept = default;
+
+    /// Destructor.
+    virtual ~SharedVector() = default;
+
+    /**
+     * Check if vector has a value.
+     *
+     * @returns true if it has, false otherwise.
+     */
+    virtual bool Initialized() const noexcept override;
+
+    /**
+     * Check if vector is marked as optional.
+     *
+     * @returns true if has been, false otherwise.
+     */
+    virtual bool Optional() const noexcept override;
+
+    /**
+     * Read the value.
+     *
+     * @returns A const reference to the value.
+     * @throws uconfig::Error Thrown if vector has no value.
+     */
+    const std::vector<T>& Get() const;
+
+    /**
+     * Dereference operator. Read the value.
+     *
+     * @returns A const reference to the value.
+     * @throws uconfig::Error Thrown if vector has no value.
+     */
+    const std::vector<T>& operator*() const;
+
+    /**
+     * Structure dereference operator. Read the value.
+     *
+     * @returns A const pointer to the value.
+     * @throws uconfig::Error Thrown if vector has no value.
+     */
+    const std::vector<T>* operator->() const;
+
+    /**
+     * Get the value from underlying vector.
+     *
+     * @param[in] pos Position to get value at.
+     *
+     * @returns A const reference to the value at @p pos.
+     * @throws uconfig::Error Thrown if vector has no value.
+     */
+    const T& operator[](std::size_t pos) const;
+
+    /**
+     * Get the value to modify. Copies the storage if it is shared with other vectors.
+     *
+     * @returns A reference to the value.
+     * @throws uconfig::Error Thrown if vector has no value.
+     */
+    std::vector<T>& Mutable();
+
+    /**
+     * Get the storage.
+     *
+     * @returns Storage or nullptr if vector has no value.
+     */
+    std::shared_ptr<const std::vector<T>> Storage() const noexcept;
+
+    /**
+     * Parse elements in parallel, see Vector::SetParallel().
+     *
+     * @param[in] threads Maximum number of threads to use, 1 disables parallel parsing.
+     * @param[in] min_chunk_size Minimum number of elements per thread. Default 1024.
+     */
+    void SetParallel(std::size_t threads, std::size_t min_chunk_size = 1024) noexcept;
+
+protected:
+    bool optional_ = false;
+    std::shared_ptr<detail::SharedStorage<std::vector<T>>> value_; ///< Stored value or none.
+    detail::SubtreeMemo memo_; ///< Hash of the source the value has been parsed from.
+    std::size_t parallel_threads_ = 1;
+    std::size_t parallel_chunk_size_ = 1024;
+};
+
+/**
+ * Nested config section with immutable copy-on-write storage.
+ * Copies of the section share the storage, so copying a config is O(1) for such sections. Every parse fills a new
+ *  storage, unless the format defines `SubtreeHash()` and the source subtree has not changed since the last parse.
+ *  The stored section is emitted, compared and fingerprinted in place, such uses of the storage by copies are
+ *  serialized as they register elements of the section.
+ *
+ * @tparam C Type of the section, derivative of uconfig::Config.
+ */
+template <typename C>
+class SharedSection: public Object
+{
+public:
+    template <typename F>
+    using iface_type = SharedSectionIface<C, F>;
+
+    template <typename U, typename F>
+    friend class SharedSectionIface;
+
+    /**
+     * Constructor.
+     *
+     * @param[in] optional If section considered to be optional (may be not initialized). Default false.
+     */
+    SharedSection(bool optional = false);
+    /// Constructor.
+    SharedSection(C init_value);
+
+    /// Copy constructor. Shares the storage.
+    SharedSection(const SharedSection<C>&) = default;
+    /// Copy assignment. Shares the storage.
+    SharedSection<C>& operator=(const SharedSection<C>&) = default;
+    /// Move constructor.
+    SharedSection(SharedSection<C>&& other) noexcept = default;
+    /// Move assignment.
+    SharedSection<C>& operator=(SharedSection<C>&& other) noexcept = default;
+
+    /// Destructor.
+    virtual ~SharedSection() = default;
+
+    /**
+     * Check if section has been parsed.
+     *
+     * @returns true if it has, false otherwise.
+     */
+    virtual bool Initialized() const noexcept override;
+
+    /**
+     * Check if section is marked as optional.
+     *
+     * @returns true if has been, false otherwise.
+     */
+    virtual bool Optional() const noexcept override;
+
+    /**
+     * Read the section.
+     *
+     * @returns A const reference to the section.
+     */
+    const C& Get() const noexcept;
+
+    /**
+     * Dereference operator. Read the section.
+     *
+     * @returns A const reference to the section.
+     */
+    const C& operator*() const noexcept;
+
+    /**
+     * Structure dereference operator. Read the section.
+     *
+     * @returns A const pointer to the section.
+     */
+    const C* operator->() const noexcept;
+
+    /**
+     * Get the section to modify. Copies the storage if it is shared with other sections.
+     *
+     * @returns A reference to the section.
+     */
+    C& Mutable();
+
+    /**
+     * Get the storage.
+     *
+     * @returns Storage of the section.
+     */
+    std::shared_ptr<const C> Storage() const noexcept;
+
+protected:
+    bool optional_ = false;
+    bool initialized_ = false;
+    std::shared_ptr<detail::SharedStorage<C>> value_; ///< Stored section.
+    detail::SubtreeMemo memo_;                         ///< Hash of the source the section has been parsed from.
+};
+
+/**
+ * Nested config section converted on the first access.
+ * Parse only records a copy of the source subtree of the section taken by `Capture()` of the format. The section
+ *  is parsed and validated once on the first access or Load(), copies of the section share the result.
+ *
+ * @tparam C Type of the section, derivative of uconfig::Config.
+ *
+ * @note Section is parsed eagerly during a strict or interpolated parse and by formats without `Capture()`, failures
+ *  not thrown by such parse are thrown by the access. Parse budgets and string interning do not apply to the
+ *  deferred parse.
+ */
+template <typename C>
+class LazyConfig: public Object
+{
+public:
+    template <typename F>
+    using iface_type = LazyConfigIface<C, F>;
+
+    template <typename U, typename F>
+    friend class LazyConfigIface;
+
+    /**
+     * Constructor.
+     *
+     * @param[in] optional If section considered to be optional (may be not initialized). Default false.
+     */
+    LazyConfig(bool optional = false);
+    /// Constructor.
+    LazyConfig(C init_value);
+
+    /// Copy constructor. Shares the parsed section.
+    LazyConfig(const LazyConfig<C>&) = default;
+    /// Copy assignment. Shares the parsed section.
+    LazyConfig<C>& operator=(const LazyConfig<C>&) = default;
+    /// Move constructor.
+    LazyConfig(LazyConfig<C>&& other) noexcept = default;
+    /// Move assignment.
+    LazyConfig<C>& operator=(LazyConfig<C>&& other) noexcept = default;
+
+    /// Destructor.
+    virtual ~LazyConfig() = default;
+
+    /**
+     * Check if section has been parsed or recorded to be parsed.
+     *
+     * @returns true if it has, false otherwise.
+     */
+    virtual bool Initialized() const noexcept override;
+
+    /**
+     * Check if section is marked as optional.
+     *
+     * @returns true if has been, false otherwise.
+     */
+    virtual bool Optional() const noexcept override;
+
+    /**
+     * Parse the recorded section unless it has been parsed already. Thread-safe.
+     *
+     * @throws uconfig::ParseError Thrown if the section has failed to parse, on every call.
+     */
+    void Load() const;
+
+    /**
+     * Check if the recorded section has been parsed, successfully or not.
+     *
+     * @returns true if it has or nothing has been recorded, false otherwise.
+     */
+    bool Loaded() const noexcept;
+
+    /**
+     * Read the section, parsing it on the first access. Thread-safe.
+     *
+     * @returns A const reference to the section.
+     * @throws uconfig::ParseError Thrown if the section has failed to parse.
+     */
+    const C& Get() const;
+
+    /**
+     * Dereference operator. Read the section, parsing it on the first access.
+     *
+     * @returns A const reference to the section.
+     * @throws uconfig::ParseError Thrown if the section has failed to parse.
+     */
+    const C& operator*() const;
+
+    /**
+     * Structure dereference operator. Read the section, parsing it on the first access.
+     *
+     * @returns A const pointer to the section.
+     * @throws uconfig::ParseError Thrown if the section has failed to parse.
+     */
+    const C* operator->() const;
+
+protected:
+    /// Section recorded by a parse.
+    struct State
+    {
+        explicit State(const C& init_value);
+
+        std::mutex mutex;
+        std::atomic<bool> loaded{false};
+        std::function<void(C*)> parse; ///< Deferred parse, holds the source until called.
+        C value;
+        std::exception_ptr error;
+    };
+
+    bool optional_ = false;
+    std::shared_ptr<const C> init_value_; ///< Section before the parse.
+    std::shared_ptr<State> state_;        ///< Recorded section or none.
 };
 
 } // namespace uconfig
@@ -0,0 +1,186 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace uconfig {
+
+/**
+ * Opt-in profiler of config parsing.
+ *
+ * While started, the profiler is attached to the calling thread and parsing on that thread records:
+ *  - exclusive time of every phase (registration in `Init()`, vector element path building, source lookup,
+ *    value conversion and validation),
+ *  - inclusive time of every parsed variable or vector path,
+ *  - time of every validator, both of variables and configs.
+ *
+ * Timestamps are taken with TSC where available. When no profiler is started each timer costs a load of
+ *  a thread-local pointer. Elements of vectors parsed on other threads (see uconfig::Vector::SetParallel())
+ *  are not recorded.
+ */
+class ParseProfiler
+{
+public:
+    /// Parse phase.
+    enum class Phase : std::size_t
+    {
+        Init,     ///< Registration of config elements in `Init()`.
+        Path,     ///< Building of vector element paths.
+        Lookup,   ///< Lookup of the value in the source.
+        Convert,  ///< Conversion of the found value into the variable type.
+        Validate, ///< `Validate()` of variables and configs.
+        Other,    ///< Everything else, e.g. bookkeeping of the parser.
+    };
+    /// Number of phases.
+    static constexpr std::size_t kPhases = static_cast<std::size_t>(Phase::Other) + 1;
+
+    /// Time spent on a path.
+    struct Entry
+    {
+        std::string path;
+        std::uint64_t calls;
+        std::chrono::nanoseconds time;
+    };
+
+    /// Timer of a phase, time of nested phases is not counted in the outer one.
+    class PhaseTimer
+    {
+    public:
+        explicit PhaseTimer(Phase phase) noexcept;
+        PhaseTimer(const PhaseTimer&) = delete;
+        PhaseTimer& operator=(const PhaseTimer&) = delete;
+        ~PhaseTimer();
+
+    private:
+        ParseProfiler* profiler_;
+        Phase previous_ = Phase::Other;
+    };
+
+    /// Timer of parsing of a variable or a vector at @p path, nested paths are counted in the outer one.
+    class PathTimer
+    {
+    public:
+        explicit PathTimer(const std::string& path) noexcept;
+        PathTimer(const PathTimer&) = delete;
+        PathTimer& operator=(const PathTimer&) = delete;
+        ~PathTimer();
+
+    private:
+        ParseProfiler* profiler_;
+        const std::string* path_;
+        std::uint64_t start_ = 0;
+    };
+
+    /// Timer of a validator of the element at @p path, counted in uconfig::ParseProfiler::Phase::Validate.
+    class ValidatorTimer
+    {
+    public:
+        explicit ValidatorTimer(const std::string& path) noexcept;
+        ValidatorTimer(const ValidatorTimer&) = delete;
+        ValidatorTimer& operator=(const ValidatorTimer&) = delete;
+        ~ValidatorTimer();
+
+    private:
+        PhaseTimer phase_timer_;
+        ParseProfiler* profiler_;
+        const std::string* path_;
+        std::uint64_t start_ = 0;
+    };
+
+    /// Constructor.
+    ParseProfiler() = default;
+    /// Copy constructor.
+    ParseProfiler(const ParseProfiler&) = delete;
+    /// Copy assignment.
+    ParseProfiler& operator=(const ParseProfiler&) = delete;
+    /// Destructor. Stops the profiler if it is attached to the calling thread.
+    ~ParseProfiler();
+
+    /// Attach the profiler to the calling thread and start recording. Recorded times are accumulated.
+    void Start() noexcept;
+    /// Stop recording and detach the profiler from the calling thread.
+    void Stop() noexcept;
+    /// Drop everything recorded.
+    void Reset() noexcept;
+
+    /// Get exclusive time of the @p phase.
+    std::chrono::nanoseconds PhaseTime(Phase phase) const noexcept;
+
+    /**
+     * Get the slowest parsed paths.
+     *
+     * @param[in] count Maximum number of paths.
+     *
+     * @returns Paths sorted by the time spent.
+     */
+    std::vector<Entry> TopPaths(std::size_t count) const;
+
+    /**
+     * Get the slowest validators.
+     *
+     * @param[in] count Maximum number of validators.
+     *
+     * @returns Paths of the validated elements sorted by the time spent.
+     */
+    std::vector<Entry> TopValidators(std::size_t count) const;
+
+    /**
+     * Print phase times and the slowest paths and validators.
+     *
+     * @param[in] out Stream to print into.
+     * @param[in] count Maximum number of paths and validators to print. Default 10.
+     */
+    void Dump(std::ostream& out, std::size_t count = 10) const;
+
+    /// Get name of the @p phase.
+    static const char* PhaseName(Phase phase) noexcept;
+
+private:
+    /// Cumulative time of a path in ticks.
+    struct Stats
+    {
+        std::uint64_t calls = 0;
+        std::uint64_t ticks = 0;
+    };
+
+    /// Get current timestamp in ticks.
+    static std::uint64_t Ticks() noexcept;
+    /// Profiler attached to the calling thread.
+    static ParseProfiler*& Current() noexcept;
+
+    /// Charge time up to now to the current phase and switch to @p phase. Returns the previous phase.
+    Phase EnterPhase(Phase phase) noexcept;
+    /// Charge time up to now to the current phase and switch back to @p previous.
+    void LeavePhase(Phase previous) noexcept;
+    /// Add @p ticks of @p path into @p table.
+    static void Record(std::unordered_map<std::string, Stats>* table, const std::string& path,
+                       std::uint64_t ticks) noexcept;
+
+    /// Get the slowest entries of @p table.
+    std::vector<Entry> Top(const std::unordered_map<std::string, Stats>& table, std::size_t count) const;
+    /// Convert @p ticks into nanoseconds.
+    std::chrono::nanoseconds ToTime(std::uint64_t ticks) const noexcept;
+
+private:
+    bool started_ = false;
+    Phase phase_ = Phase::Other;
+    std::uint64_t phase_start_ = 0;
+    std::array<std::uint64_t, kPhases> phase_ticks_{};
+    std::unordered_map<std::string, Stats> paths_;
+    std::unordered_map<std::string, Stats> validators_;
+
+    // total recorded time, measured both in ticks and by the steady clock to convert ticks
+    std::uint64_t session_start_ticks_ = 0;
+    std::chrono::steady_clock::time_point session_start_;
+    std::uint64_t total_ticks_ = 0;
+    std::chrono::nanoseconds total_time_{0};
+};
+
+} // namespace uconfig
+
+#include "impl/Profiler.ipp"
@@ -0,0 +1,171 @@
+#pragma once
+
+#include "format/FlatKv.h"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+namespace uconfig {
+namespace detail {
+
+/// Memory mapping of a POSIX shared memory segment.
+class ShmSegment
+{
+public:
+    /// Header at the start of the segment.
+    struct Header
+    {
+        std::uint64_t magic;
+        std::uint64_t slot_capacity;
+        /// Twice the published generation, odd while the next one is being written.
+        std::atomic<std::uint64_t> sequence;
+        std::atomic<std::uint64_t> image_size[2];
+    };
+
+    /// Offset of the first slot, slots are aligned to the cache line.
+    static constexpr std::size_t kSlotsOffset = 64;
+    /// Segment signature, "UCFGSHM1".
+    static constexpr std::uint64_t kMagic = 0x314d485347464355;
+
+    ShmSegment() = default;
+    ShmSegment(const ShmSegment&) = delete;
+    ShmSegment& operator=(const ShmSegment&) = delete;
+    ShmSegment(ShmSegment&& other) noexcept;
+    ShmSegment& operator=(ShmSegment&& other) noexcept;
+    ~ShmSegment();
+
+    /// Open segment @p name, creating one with @p slot_capacity if @p writable.
+    void Open(const std::string& name, bool writable, std::size_t slot_capacity);
+
+    Header& GetHeader() const noexcept;
+    char* Slot(std::uint64_t generation) const noexcept;
+    const std::string& Name() const noexcept;
+
+    [[noreturn]] void Fail(const std::string& what, int error) const;
+
+private:
+    void Unmap() noexcept;
+
+private:
+    std::string name_;
+    void* data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+} // namespace detail
+
+/**
+ * Publisher of configs into a POSIX shared memory segment.
+ *
+ * Config is emitted once into a position-independent image of uconfig::FlatKvTable and written into one of two
+ *  slots of the segment, so readers in other processes parse the previous generation without locks while the
+ *  next one is written. There should be a single publisher per segment.
+ */
+class ShmPublisher
+{
+public:
+    /// Default capacity of a single image slot.
+    static constexpr std::size_t kSlotCapacity = 1024 * 1024;
+
+    /**
+     * Constructor. Opens or creates the segment.
+     *
+     * @param[in] name Name of the segment, e.g. "/app-config".
+     * @param[in] slot_capacity Maximum size of the published image. Should match one of existing segment.
+     *
+     * @throws uconfig::Error Thrown if the segment failed to be opened or created.
+     */
+    explicit ShmPublisher(const std::string& name, std::size_t slot_capacity = kSlotCapacity);
+
+    /**
+     * Publish @p config at @p path as the next generation.
+     *
+     * @tparam ConfigT Type of the config, should support uconfig::FlatKvFormat.
+     *
+     * @param[in] config Config to publish.
+     * @param[in] path Path of the config.
+     *
+     * @returns Published generation.
+     *
+     * @throws uconfig::EmitError Thrown if the config failed to be emitted or its' image exceeds slot capacity.
+     */
+    template <typename ConfigT,
+              typename std::enable_if<!std::is_same<ConfigT, FlatKvTable>::value>::type* = nullptr>
+    std::uint64_t Publish(ConfigT& config, const std::string& path = "");
+
+    /**
+     * Publish built @p table as the next generation.
+     *
+     * @param[in] table Table to publish.
+     *
+     * @returns Published generation.
+     *
+     * @throws uconfig::EmitError Thrown if image of the table exceeds slot capacity.
+     */
+    std::uint64_t Publish(const FlatKvTable& table);
+
+    /// Get last published generation, 0 if nothing has been published.
+    std::uint64_t Generation() const noexcept;
+
+    /**
+     * Remove the segment @p name. Attached readers keep their mappings.
+     *
+     * @param[in] name Name of the segment.
+     */
+    static void Unlink(const std::string& name) noexcept;
+
+private:
+    detail::ShmSegment segment_;
+};
+
+/**
+ * Reader of configs published by uconfig::ShmPublisher.
+ * Values are parsed straight from the mapped image, consistency with concurrent publication is checked by
+ *  the generation number and parsing is retried if the image has been overwritten meanwhile.
+ */
+class ShmReader
+{
+public:
+    /**
+     * Constructor. Attaches to the segment.
+     *
+     * @param[in] name Name of the segment.
+     *
+     * @throws uconfig::Error Thrown if the segment failed to be opened or is not valid.
+     */
+    explicit ShmReader(const std::string& name);
+
+    /**
+     * Parse last published generation of the config at @p path into @p config.
+     * @p config is left untouched if parsing fails.
+     *
+     * @tparam ConfigT Type of the config, should support uconfig::FlatKvFormat.
+     *
+     * @param[out] config Config to parse.
+     * @param[in] path Path of the config.
+     * @param[in] throw_on_fail Will throw an uconfig::ParseError is failed to parse all mandatory children.
+     *  Default true.
+     *
+     * @returns Parsed generation, 0 if parsing failed without @p throw_on_fail.
+     *
+     * @throws uconfig::ParseError Thrown if nothing has been published or @p throw_on_fail.
+     */
+    template <typename ConfigT>
+    std::uint64_t Parse(ConfigT* config, const std::string& path = "", bool throw_on_fail = true) const;
+
+    /// Get last published generation, 0 if nothing has been published. Cheap enough to poll for reloads.
+    std::uint64_t Generation() const noexcept;
+
+private:
+    /// Check if the image of @p sequence has not been overwritten since.
+    bool Consistent(std::uint64_t sequence) const noexcept;
+
+private:
+    detail::ShmSegment segment_;
+};
+
+} // namespace uconfig
+
+#include "impl/Shm.ipp"
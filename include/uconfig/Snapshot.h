@@ -0,0 +1,134 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+namespace uconfig {
+
+// Forward-declared SnapshotReader.
+template <typename T>
+class SnapshotReader;
+
+/**
+ * Publisher of immutable config snapshots for read-mostly access from many threads.
+ *
+ * Each reading thread keeps its own uconfig::SnapshotReader with a cached snapshot pointer, validated against
+ *  the global generation number. Generation is written only on publication, so in the steady state readers
+ *  touch no shared cache line for writing, unlike copying of `std::shared_ptr` on every read.
+ *
+ * Publisher should outlive its readers.
+ *
+ * @tparam T Type of the snapshot, e.g. derivative of uconfig::Config.
+ */
+template <typename T>
+class SnapshotPublisher
+{
+public:
+    /**
+     * Constructor.
+     *
+     * @param[in] value Initial snapshot, published as generation 1.
+     */
+    explicit SnapshotPublisher(T value);
+
+    /**
+     * Constructor.
+     *
+     * @param[in] snapshot Initial snapshot, published as generation 1.
+     */
+    explicit SnapshotPublisher(std::shared_ptr<const T> snapshot);
+
+    /// Copy constructor.
+    SnapshotPublisher(const SnapshotPublisher&) = delete;
+    /// Copy assignment.
+    SnapshotPublisher& operator=(const SnapshotPublisher&) = delete;
+
+    /**
+     * Publish new snapshot. Readers pick it up on their next access.
+     * Previous snapshot is destroyed when the last reader holding it has refreshed.
+     *
+     * @param[in] value New snapshot.
+     *
+     * @returns Published generation.
+     */
+    std::uint64_t Publish(T value);
+
+    /**
+     * Publish new snapshot. Readers pick it up on their next access.
+     *
+     * @param[in] snapshot New snapshot.
+     *
+     * @returns Published generation.
+     */
+    std::uint64_t Publish(std::shared_ptr<const T> snapshot);
+
+    /// Get last published generation.
+    std::uint64_t Generation() const noexcept;
+
+    /// Get last published snapshot. Takes a lock, use uconfig::SnapshotReader for frequent reads.
+    std::shared_ptr<const T> Current() const;
+
+    /// Make a reader to be used by a single thread.
+    SnapshotReader<T> MakeReader() const;
+
+private:
+    friend class SnapshotReader<T>;
+
+    mutable std::mutex mutex_;
+    std::shared_ptr<const T> snapshot_;
+    std::uint64_t snapshot_generation_ = 0;
+    // written only on publication, kept off the line with the mutex
+    alignas(64) std::atomic<std::uint64_t> generation_{0};
+};
+
+/**
+ * Per-thread reader of snapshots published by uconfig::SnapshotPublisher.
+ * Snapshot returned by Get() stays valid until the next Get() from the same reader.
+ * Reader is not thread-safe itself: make one per thread (or per core).
+ *
+ * @tparam T Type of the snapshot.
+ */
+template <typename T>
+class SnapshotReader
+{
+public:
+    /**
+     * Constructor.
+     *
+     * @param[in] publisher Publisher to read from.
+     */
+    explicit SnapshotReader(const SnapshotPublisher<T>& publisher);
+
+    /**
+     * Get last published snapshot. Refreshes cached snapshot if the generation has changed.
+     *
+     * @returns Snapshot valid until the next call.
+     */
+    const T& Get();
+
+    /// Get last published snapshot.
+    const T& operator*();
+    /// Access last published snapshot.
+    const T* operator->();
+
+    /// Get generation of the snapshot held by the reader.
+    std::uint64_t Generation() const noexcept;
+
+    /// Share the snapshot held by the reader, e.g. to keep it beyond the next Get().
+    std::shared_ptr<const T> Share() const noexcept;
+
+private:
+    /// Reload the snapshot from the publisher.
+    void Refresh();
+
+private:
+    const SnapshotPublisher<T>* publisher_;
+    std::uint64_t generation_ = 0;
+    std::shared_ptr<const T> snapshot_;
+};
+
+} // namespace uconfig
+
+#include "impl/Snapshot.ipp"
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_set>
+
+namespace uconfig {
+
+/**
+ * Tracker of source keys consumed by a strict parse, see Config::SetStrict().
+ *
+ * While attached to the calling thread (and workers of parallel vector parsing), formats mark nodes of the source
+ *  they have looked up: nodes on the path to a value are visited, nodes converted into values are consumed with all
+ *  their children. After the parse the format reports keys of the source which have been neither. Nodes are
+ *  identified by format-specific keys, e.g. addresses of JSON values.
+ * Marks cost a load of a thread-local pointer if there is no tracker. Tracker is not synchronized: workers of
+ *  parallel vector parsing mark into trackers of their own, merged into the attached one after the join.
+ */
+class KeyTracker
+{
+public:
+    /// Identifier of a source node.
+    using node_key = std::uintptr_t;
+
+    /// Constructor.
+    KeyTracker() = default;
+    /// Copy constructor.
+    KeyTracker(const KeyTracker&) = delete;
+    /// Copy assignment.
+    KeyTracker& operator=(const KeyTracker&) = delete;
+    /// Move constructor.
+    KeyTracker(KeyTracker&&) = default;
+    /// Move assignment.
+    KeyTracker& operator=(KeyTracker&&) = default;
+
+    /// Mark @p node as visited on the way to a value.
+    void Visit(node_key node);
+    /// Mark @p node as converted into a value with all its' children.
+    void Consume(node_key node);
+    /// Add nodes marked by @p other, leaving it empty.
+    void Merge(KeyTracker& other);
+
+    /// Check if @p node has been visited or consumed.
+    bool Visited(node_key node) const;
+    /// Check if @p node has been consumed.
+    bool Consumed(node_key node) const;
+
+    /// Tracker attached to the calling thread.
+    static KeyTracker* Current() noexcept;
+
+    /// Attachment of a tracker to the calling thread, nested attachments override outer ones.
+    class Scope
+    {
+    public:
+        explicit Scope(KeyTracker* tracker) noexcept;
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+        ~Scope();
+
+    private:
+        KeyTracker* previous_;
+    };
+
+private:
+    /// Tracker attached to the calling thread.
+    static KeyTracker*& CurrentRef() noexcept;
+
+private:
+    std::unordered_set<node_key> visited_;
+    std::unordered_set<node_key> consumed_;
+};
+
+} // namespace uconfig
+
+#include "impl/Strict.ipp"
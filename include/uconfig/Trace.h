@@ -0,0 +1,111 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+
+// Tracing sites are compiled in only with UCONFIG_TRACING defined, otherwise they expand to nothing.
+#ifdef UCONFIG_TRACING
+#define UCONFIG_TRACE_CONCAT_IMPL(lhs, rhs) lhs##rhs
+#define UCONFIG_TRACE_CONCAT(lhs, rhs) UCONFIG_TRACE_CONCAT_IMPL(lhs, rhs)
+#define UCONFIG_TRACE(event, format, path) \
+    ::uconfig::detail::TraceScope UCONFIG_TRACE_CONCAT(uconfig_trace_scope_, __LINE__)(::uconfig::TraceEvent::event, \
+                                                                                     format, path)
+#else
+#define UCONFIG_TRACE(event, format, path)
+#endif
+
+// USDT probes are placed along with the hooks if systemtap headers are available.
+#if defined(UCONFIG_TRACING) && !defined(UCONFIG_NO_USDT) && defined(__linux__) && __has_include(<sys/sdt.h>)
+#define UCONFIG_USDT 1
+#endif
+
+namespace uconfig {
+
+/// Traced event.
+enum class TraceEvent
+{
+    Parse,        ///< Config::Parse() call.
+    Emit,         ///< Config::Emit() call.
+    ParseSection, ///< Parsing of a config section, the root one included.
+    EmitSection,  ///< Emitting of a config section, the root one included.
+    Validate,     ///< `Validate()` of a config, variable or vector.
+};
+
+/**
+ * Hook invoked at begin and end of traced events.
+ * Events are reported only if uconfig is built with `UCONFIG_TRACING` defined.
+ * Hook may be called concurrently from the threads parsing configs.
+ */
+class TraceHook
+{
+public:
+    /// Destructor.
+    virtual ~TraceHook() = default;
+
+    /**
+     * Event has begun.
+     *
+     * @param[in] event Traced event.
+     * @param[in] format Name of the format, e.g. "[JSON]".
+     * @param[in] path Path to the config element.
+     */
+    virtual void Begin(TraceEvent event, const std::string& format, const std::string& path) noexcept = 0;
+
+    /**
+     * Event has ended.
+     *
+     * @param[in] event Traced event.
+     * @param[in] format Name of the format, e.g. "[JSON]".
+     * @param[in] path Path to the config element.
+     * @param[in] failed Whether the event has ended with an exception.
+     */
+    virtual void End(TraceEvent event, const std::string& format, const std::string& path, bool failed) noexcept = 0;
+};
+
+/**
+ * Install global trace hook. Hook should outlive all the parsing and emitting it may be called from.
+ *
+ * @param[in] hook Hook to install, nullptr to remove the installed one.
+ */
+void SetTraceHook(TraceHook* hook) noexcept;
+
+/// Get installed trace hook or nullptr.
+TraceHook* GetTraceHook() noexcept;
+
+/// Get name of the @p event.
+const char* TraceEventName(TraceEvent event) noexcept;
+
+namespace detail {
+
+/// Storage of the installed trace hook.
+inline std::atomic<TraceHook*>& trace_hook() noexcept
+{
+    static std::atomic<TraceHook*> hook{nullptr};
+    return hook;
+}
+
+/// Scope of a traced event, reports its' begin and end to the hook and USDT probes.
+class TraceScope
+{
+public:
+    TraceScope(TraceEvent event, const std::string& format, const std::string& path) noexcept;
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+    ~TraceScope();
+
+private:
+    /// Fire USDT probe of the event begin or end.
+    void Probe(bool begin, bool failed) const noexcept;
+
+private:
+    TraceEvent event_;
+    const std::string& format_;
+    const std::string& path_;
+    TraceHook* hook_;
+    int uncaught_exceptions_;
+};
+
+} // namespace detail
+} // namespace uconfig
+
+#include "impl/Trace.ipp"
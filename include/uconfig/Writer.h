@@ -0,0 +1,121 @@
+#pragma once
+
+#include "Objects.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <sys/types.h>
+
+namespace uconfig {
+
+/**
+ * Crash-safe writer of a config file.
+ *
+ * Output is buffered and written into a temporary file next to the target one. Commit() syncs the temporary file
+ *  to the disk and atomically renames it over the target, so after a crash the target holds either the previous
+ *  or the new contents in full. A writer destroyed without Commit() removes the temporary file.
+ *
+ * Satisfies rapidjson OutputStream concept, so serializers write straight into the file without an intermediate
+ *  string. Formats defining `template <typename StreamT> void Write(const dest_type* dest, StreamT* stream) const`
+ *  serialize their destination with it, see uconfig::EmitFile().
+ */
+class AtomicFileWriter
+{
+public:
+    /// Name of the writer. Used to form nice error-strings.
+    static inline const std::string name = "[WRITER]";
+    /// Type of the character, for rapidjson.
+    using Ch = char;
+
+    /// Default size of the write buffer.
+    static constexpr std::size_t kBufferSize = 1 << 20;
+
+    /**
+     * Constructor. Creates the temporary file.
+     *
+     * @param[in] path Path to the target file.
+     * @param[in] mode Permissions of the target file. Default 0644.
+     * @param[in] buffer_size Size of the write buffer. Default kBufferSize.
+     *
+     * @throws uconfig::EmitError Thrown if the temporary file failed to be created.
+     */
+    explicit AtomicFileWriter(std::string path, mode_t mode = 0644, std::size_t buffer_size = kBufferSize);
+
+    /// Copy constructor.
+    AtomicFileWriter(const AtomicFileWriter&) = delete;
+    /// Copy assignment.
+    AtomicFileWriter& operator=(const AtomicFileWriter&) = delete;
+
+    /// Destructor. Removes the temporary file if not committed.
+    ~AtomicFileWriter();
+
+    /**
+     * Append @p data to the file.
+     *
+     * @throws uconfig::EmitError Thrown if the buffer failed to be written.
+     */
+    void Write(std::string_view data);
+
+    /**
+     * Append @p c to the file.
+     *
+     * @throws uconfig::EmitError Thrown if the buffer failed to be written.
+     */
+    void Put(Ch c);
+
+    /**
+     * Write out the buffer. Does not sync the file, called by rapidjson at the end of the document.
+     *
+     * @throws uconfig::EmitError Thrown if the buffer failed to be written.
+     */
+    void Flush();
+
+    /**
+     * Write out the buffer, sync the temporary file and rename it over the target one.
+     *
+     * @throws uconfig::EmitError Thrown if the file failed to be written, the target is left intact then.
+     */
+    void Commit();
+
+    /// Drop written contents and remove the temporary file, the target is left intact.
+    void Abort() noexcept;
+
+    /// Get path to the target file.
+    const std::string& Path() const noexcept;
+
+private:
+    /// Make uconfig::EmitError for @p action failed with @p error, aborting the write.
+    EmitError Fail(const std::string& action, int error);
+
+private:
+    std::string path_;
+    std::string temp_path_;
+    int fd_ = -1;
+    std::vector<char> buffer_;
+    std::size_t buffered_ = 0;
+};
+
+/**
+ * Emit @p config into a file at @p file_path crash-safely.
+ * Config is emitted into a destination of @p F, which is serialized into the file by the format.
+ *
+ * @tparam F Type of the emitter to use, should define `Write()`, see uconfig::AtomicFileWriter.
+ * @tparam C Type of the config.
+ *
+ * @param[in] emitter Emitter instance to use.
+ * @param[in] config Config to emit.
+ * @param[in] path Path where the config should be in the destination.
+ * @param[in] file_path Path to the file to write.
+ * @param[in] mode Permissions of the file. Default 0644.
+ *
+ * @throws uconfig::EmitError Thrown if failed to emit or to write the file, the file is left intact then.
+ */
+template <typename F, typename C>
+void EmitFile(const F& emitter, C& config, const std::string& path, const std::string& file_path,
+              mode_t mode = 0644);
+
+} // namespace uconfig
+
+#include "impl/Writer.ipp"
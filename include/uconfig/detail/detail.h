@@ -2,6 +2,10 @@
 
 #include "forward.h"
 
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
 #include <utility>
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
@@ -38,6 +42,140 @@ struct deduce_iface<T, F, typename enable_if_type<typename T::template iface_typ
 template <typename T, typename F>
 using deduce_iface_t = typename deduce_iface<T, F>::type;
 
+template <typename F, typename = void>
+struct has_vector_size: std::false_type
+{
+};
+
+template <typename F>
+struct has_vector_size<F, typename enable_if_type<decltype(std::declval<const F&>().VectorSize(
+                              std::declval<const typename F::source_type*>(),
+                              std::declval<const std::string&>()))>::type>: std::true_type
+{
+};
+
+template <typename F, typename = void>
+struct has_subtree_hash: std::false_type
+{
+};
+
+template <typename F>
+struct has_subtree_hash<F, typename enable_if_type<decltype(std::declval<const F&>().SubtreeHash(
+                               std::declval<const typename F::source_type*>(),
+                               std::declval<const std::string&>()))>::type>: std::true_type
+{
+};
+
+template <typename F, typename = void>
+struct has_string_view: std::false_type
+{
+};
+
+template <typename F>
+struct has_string_view<F, typename enable_if_type<decltype(std::declval<const F&>().StringView(
+                              std::declval<const typename F::source_type*>(),
+                              std::declval<const std::string&>()))>::type>: std::true_type
+{
+};
+
+template <typename F, typename = void>
+struct format_state
+{
+    /// Formats without a state of the parse get an empty one.
+    struct type
+    {
+        explicit type(const F& /*format*/) noexcept {}
+    };
+};
+
+template <typename F>
+struct format_state<F, typename enable_if_type<typename F::parse_state>::type>
+{
+    using type = typename F::parse_state;
+};
+
+template <typename F>
+using format_state_t = typename format_state<F>::type;
+
+template <typename F, typename = void>
+struct has_unknown_keys: std::false_type
+{
+};
+
+template <typename F>
+struct has_unknown_keys<F, typename enable_if_type<decltype(std::declval<const F&>().UnknownKeys(
+                               std::declval<const typename F::source_type*>(), std::declval<const std::string&>(),
+                               std::declval<const KeyTracker&>()))>::type>: std::true_type
+{
+};
+
+template <typename F, typename = void>
+struct has_capture: std::false_type
+{
+};
+
+template <typename F>
+struct has_capture<F, typename enable_if_type<decltype(std::declval<const F&>().Capture(
+                          std::declval<const typename F::source_type*>(), std::declval<const std::string&>()))>::type>
+    : std::true_type
+{
+};
+
+template <typename F, typename = void>
+struct has_reference_path: std::false_type
+{
+};
+
+template <typename F>
+struct has_reference_path<F, typename enable_if_type<decltype(std::declval<const F&>().ReferencePath(
+                                 std::declval<const std::string&>()))>::type>: std::true_type
+{
+};
+
+template <typename T, typename = void>
+struct is_equality_comparable: std::false_type
+{
+};
+
+template <typename T>
+struct is_equality_comparable<T, typename enable_if_type<decltype(std::declval<const T&>() ==
+                                                                  std::declval<const T&>())>::type>: std::true_type
+{
+};
+
+template <typename T, typename = void>
+struct is_printable: std::false_type
+{
+};
+
+template <typename T>
+struct is_printable<
+    T, typename enable_if_type<decltype(std::declval<std::ostream&>() << std::declval<const T&>())>::type>
+    : std::true_type
+{
+};
+
+/// Seed of 64-bit FNV-1a hash.
+constexpr std::uint64_t kFnvSeed = 14695981039346656037ull;
+
+/// Continue 64-bit FNV-1a @p hash with @p size bytes at @p data.
+inline std::uint64_t fnv1a(const void* data, std::size_t size, std::uint64_t hash = kFnvSeed) noexcept
+{
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    for (std::size_t index = 0; index < size; ++index) {
+        hash = (hash ^ bytes[index]) * 1099511628211ull;
+    }
+    return hash;
+}
+
+/// Continue 64-bit FNV-1a @p hash with a tag byte and @p size bytes at @p data, so that sequences are unambiguous.
+inline std::uint64_t fnv1a_tagged(char tag, const void* data, std::size_t size, std::uint64_t hash) noexcept
+{
+    hash = fnv1a(&tag, 1, hash);
+    hash = fnv1a(&size, sizeof(size), hash);
+    return fnv1a(data, size, hash);
+}
+
 } // namespace detail
 } // namespace uconfig
 #endif /* DOXYGEN_SHOULD_SKIP_THIS */
@@ -18,6 +18,18 @@ class ValueIface;
 // Forward-declared VectorIface.
 template <typename T, typename Format>
 class VectorIface;
+// Forward-declared SharedVectorIface.
+template <typename T, typename Format>
+class SharedVectorIface;
+// Forward-declared SharedSectionIface.
+template <typename C, typename Format>
+class SharedSectionIface;
+// Forward-declared LazyConfigIface.
+template <typename C, typename Format>
+class LazyConfigIface;
+
+// Forward-declared KeyTracker.
+class KeyTracker;
 
 // Forward-declared Config.
 template <typename... FormatTs>
@@ -28,6 +40,15 @@ class Variable;
 // Forward-declared Vector.
 template <typename T>
 class Vector;
+// Forward-declared SharedVector.
+template <typename T>
+class SharedVector;
+// Forward-declared SharedSection.
+template <typename C>
+class SharedSection;
+// Forward-declared LazyConfig.
+template <typename C>
+class LazyConfig;
 
 } // namespace uconfig
 #endif /* DOXYGEN_SHOULD_SKIP_THIS */
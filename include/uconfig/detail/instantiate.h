@@ -0,0 +1,67 @@
+#pragma once
+
+/*
+ * Lists of explicit instantiations for built-in types, see UCONFIG_COMPILED option.
+ * Headers of the formats declare them as `extern`, uconfig::compiled library defines them.
+ */
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+/*
+ * Instantiations differ with UCONFIG_TRACING, UCONFIG_NO_METRICS and UCONFIG_NO_USDT, so the library and its' users
+ *  have to agree on them. The library exports UCONFIG_COMPILED_FLAGS it has been built with, 0 if not defined.
+ */
+#ifdef UCONFIG_TRACING
+#define UCONFIG_FLAG_TRACING 1
+#else
+#define UCONFIG_FLAG_TRACING 0
+#endif
+#ifdef UCONFIG_NO_METRICS
+#define UCONFIG_FLAG_NO_METRICS 2
+#else
+#define UCONFIG_FLAG_NO_METRICS 0
+#endif
+#ifdef UCONFIG_NO_USDT
+#define UCONFIG_FLAG_NO_USDT 4
+#else
+#define UCONFIG_FLAG_NO_USDT 0
+#endif
+#define UCONFIG_FLAGS (UCONFIG_FLAG_TRACING | UCONFIG_FLAG_NO_METRICS | UCONFIG_FLAG_NO_USDT)
+
+#ifndef UCONFIG_COMPILED_FLAGS
+#define UCONFIG_COMPILED_FLAGS 0
+#endif
+#if UCONFIG_COMPILED_FLAGS != UCONFIG_FLAGS
+#error "uconfig::compiled is built with other UCONFIG_TRACING, UCONFIG_NO_METRICS or UCONFIG_NO_USDT definitions"
+#endif
+
+// Apply macro(prefix, T, F) to the built-in types supported by all the formats, but bool.
+#define UCONFIG_INSTANTIATE_TYPES(macro, prefix, F) \
+    macro(prefix, int, F)                           \
+    macro(prefix, long, F)                          \
+    macro(prefix, unsigned, F)                      \
+    macro(prefix, unsigned long, F)                 \
+    macro(prefix, double, F)                        \
+    macro(prefix, float, F)                         \
+    macro(prefix, std::string, F)
+
+// Conversions of T by the format F.
+#define UCONFIG_INSTANTIATE_CONVERSIONS(prefix, T, F)                                               \
+    prefix template std::optional<T> F::Parse<T>(const F::source_type*, const std::string&) const; \
+    prefix template void F::Emit<T>(F::dest_type*, const std::string&, const T&) const;
+
+// Interfaces of T for the format F. std::vector<bool> has no references to elements, so bool is a variable only.
+#define UCONFIG_INSTANTIATE_IFACES(prefix, T, F) \
+    prefix template class ValueIface<T, F>;      \
+    prefix template class VariableIface<T, F>;   \
+    prefix template class VectorIface<T, F>;
+
+// All the instantiations for the format F.
+#define UCONFIG_INSTANTIATE_FORMAT(prefix, F)                               \
+    prefix template class ConfigIface<F>;                                   \
+    prefix template class VariableIface<bool, F>;                           \
+    UCONFIG_INSTANTIATE_CONVERSIONS(prefix, bool, F)                        \
+    UCONFIG_INSTANTIATE_TYPES(UCONFIG_INSTANTIATE_CONVERSIONS, prefix, F) \
+    UCONFIG_INSTANTIATE_TYPES(UCONFIG_INSTANTIATE_IFACES, prefix, F)
+
+#endif /* DOXYGEN_SHOULD_SKIP_THIS */
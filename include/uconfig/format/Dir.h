@@ -0,0 +1,167 @@
+#pragma once
+
+#include "../Loader.h"
+#include "../Objects.h"
+#include "Format.h"
+
+#include <map>
+#include <string_view>
+#include <vector>
+
+namespace uconfig {
+
+// Forward-declared DirSource.
+class DirSource;
+
+/**
+ * Directory-of-files format, e.g. mounted Kubernetes ConfigMaps and secrets.
+ * Parse values from uconfig::DirSource where each file holds a single value, emit into `std::map`.
+ */
+class DirFormat: public Format
+{
+public:
+    /// Name of the format. Used to form nice error-strings.
+    static inline const std::string name = "[DIR]";
+    /// uconfig::DirSource to parse from.
+    using source_type = DirSource;
+    /// `std::map<std::string, std::string>` of file names to their contents to emit to.
+    using dest_type = std::map<std::string, std::string>;
+
+    /**
+     * Parse the value from the file @p path in @p source directory.
+     *
+     * @tparam T Type to parse.
+     *
+     * @param[in] source Indexed directory to parse from.
+     * @param[in] path Name of the file relative to the directory.
+     *
+     * @returns Value wrapped in std::optional or std::nullopt.
+     */
+    template <typename T>
+    std::optional<T> Parse(const source_type* source, const std::string& path) const;
+
+    /**
+     * Emit the (@p path, @p value) pair into @p dest.
+     *
+     * @tparam T Type to emit.
+     *
+     * @param[in] dest Map to emit to.
+     * @param[in] path Name of the file.
+     * @param[in] value Value to emit.
+     */
+    template <typename T>
+    void Emit(dest_type* dest, const std::string& path, const T& value) const;
+
+    /**
+     * Construct numbered file name of the vector element using '.' as delimiter.
+     *
+     * @param[in] vector_path Name of the vector itself.
+     * @param[in] index Position in the vector to make path to.
+     *
+     * @returns '.' delimited name of the element at @p index, e.g. "hosts.0"
+     *  for @p vector_path = "hosts" and @p index = 0.
+     */
+    inline virtual std::string VectorElementPath(const std::string& vector_path,
+                                                 std::size_t index) const noexcept override;
+
+private:
+    /// Convert file contents into `T`.
+    template <typename T>
+    static std::optional<T> FromString(std::string_view str);
+
+    /// Convert `T` into file contents.
+    template <typename T>
+    static std::string ToString(const T& value);
+};
+
+/**
+ * Indexed contents of a directory.
+ * Directory is enumerated once on construction, small files are read into a single buffer,
+ *  large ones are mapped into memory. Names starting with ".." (Kubernetes internals) are skipped.
+ * Keys linked into `..data` are read from the version of the files `..data` points to at the start, so a
+ *  concurrent Kubernetes update never mixes files of two versions.
+ * Mapped files should not be truncated in place while the source is alive: access to the cut part raises SIGBUS.
+ *  Kubernetes replaces files instead, otherwise pass std::numeric_limits<std::size_t>::max() as `mmap_threshold`
+ *  to read all the files.
+ */
+class DirSource
+{
+public:
+    /// Files of this size and larger are mapped instead of being read.
+    static constexpr std::size_t kMmapThreshold = 64 * 1024;
+
+    /**
+     * Constructor. Enumerates and reads @p root directory.
+     *
+     * @param[in] root Path to the directory.
+     * @param[in] mmap_threshold Files of this size and larger are mapped instead of being read.
+     *
+     * @throws uconfig::ParseError Thrown if directory or some of its' files failed to be read.
+     */
+    explicit DirSource(const std::string& root, std::size_t mmap_threshold = kMmapThreshold);
+
+    /**
+     * Constructor. Enumerates @p root directory and reads all its' small files in a single batch of @p loader,
+     *  e.g. through io_uring, instead of one after another.
+     *
+     * @param[in] root Path to the directory.
+     * @param[in] loader Loader to read the small files with, reused across the reloads.
+     * @param[in] mmap_threshold Files of this size and larger are mapped instead of being read.
+     *
+     * @throws uconfig::ParseError Thrown if directory or some of its' files failed to be read.
+     */
+    DirSource(const std::string& root, FileLoader& loader, std::size_t mmap_threshold = kMmapThreshold);
+
+    /// Copy constructor.
+    DirSource(const DirSource&) = delete;
+    /// Copy assignment.
+    DirSource& operator=(const DirSource&) = delete;
+    /// Move constructor.
+    DirSource(DirSource&& other) noexcept;
+    /// Move assignment.
+    DirSource& operator=(DirSource&& other) noexcept;
+
+    /// Destructor.
+    ~DirSource();
+
+    /**
+     * Get contents of the file @p name.
+     *
+     * @param[in] name Name of the file relative to the directory.
+     *
+     * @returns Contents of the file or std::nullopt if there is no such file.
+     */
+    std::optional<std::string_view> Get(std::string_view name) const noexcept;
+
+    /// Get path to the directory.
+    const std::string& Root() const noexcept;
+    /// Get number of files in the directory.
+    std::size_t Size() const noexcept;
+
+private:
+    /// Indexed file.
+    struct Entry
+    {
+        std::string name;
+        bool in_data = false;  ///< Key is a symlink into `..data`.
+        std::string data_name; ///< Name of the file in `..data` for such keys.
+        std::size_t offset = 0;
+        std::size_t size = 0;
+        void* mapping = nullptr;
+    };
+
+    /// Enumerate and read @p root directory, small files are read with @p loader if any.
+    DirSource(const std::string& root, FileLoader* loader, std::size_t mmap_threshold);
+
+    [[noreturn]] void Fail(const std::string& name, int error) const;
+    void Unmap() noexcept;
+
+private:
+    std::string root_;
+    std::vector<Entry> entries_;
+    std::string buffer_;
+};
+
+} // namespace uconfig
+
+#include "impl/Dir.ipp"
@@ -1,22 +1,32 @@
 #pragma once
 
+#include "../detail/detail.h"
+#include "FlatKv.h"
 #include "Format.h"
 
+#include <cstdint>
 #include <map>
+#include <memory>
+#include <string_view>
+#include <vector>
 
 namespace uconfig {
 
 /**
  * Environment format.
- * Parsed values from env, emit into `std::map`.
+ * Parse values from env, emit into `std::map`.
+ *
+ * Values are parsed from the environment of the process if no source is given. Otherwise they are looked up in
+ *  uconfig::FlatKvTable built from an environment, e.g. the one to be passed to a child process,
+ *  so env-style configs may be parsed concurrently without touching the process environment.
  */
 class EnvFormat: public Format
 {
 public:
     /// Name of the format. Used to form nice error-strings.
     static inline const std::string name = "[ENV]";
-    /// Env does't have a source type.
-    using source_type = void;
+    /// uconfig::FlatKvTable of the variables to parse from, nullptr for the process environment.
+    using source_type = FlatKvTable;
     /// `std::map<std::string, std::string>` to emit to.
     using dest_type = std::map<std::string, std::string>;
 
@@ -25,12 +35,13 @@ public:
      *
      * @tparam T Type to parse.
      *
+     * @param[in] source Variables to parse from, nullptr for the process environment.
      * @param[in] path Name of the value.
      *
      * @returns Value wrapped in std::optional or std::nullopt.
      */
     template <typename T>
-    std::optional<T> Parse(const source_type* /*unused*/, const std::string& path) const;
+    std::optional<T> Parse(const source_type* source, const std::string& path) const;
 
     /**
      * Emit the (@p path, @p value) pair into @p dest.
@@ -44,6 +55,62 @@ public:
     template <typename T>
     void Emit(dest_type* dest, const std::string& path, const T& value) const;
 
+    /**
+     * Serialize emitted variables @p dest into @p stream as "NAME=value" lines, e.g. into uconfig::AtomicFileWriter.
+     *
+     * @tparam StreamT Stream with `Write(std::string_view)`.
+     *
+     * @param[in] dest Map emitted to.
+     * @param[in] stream Stream to write into.
+     *
+     * @throws std::runtime_error Thrown if some name or value contains a line break.
+     */
+    template <typename StreamT>
+    void Write(const dest_type* dest, StreamT* stream) const;
+
+    /**
+     * Get hash of the variable with name @p path and all variables named with "<path>_" prefix.
+     * Used to skip unchanged sections of configs with memoization enabled.
+     *
+     * @param[in] source Variables to parse from, nullptr for the process environment.
+     * @param[in] path Name of the section.
+     *
+     * @returns Hash of the variables.
+     */
+    inline std::optional<std::uint64_t> SubtreeHash(const source_type* source, const std::string& path) const;
+
+    /**
+     * Get names of the variables of the section @p path not consumed by a strict parse.
+     *
+     * @param[in] source Variables parsed from, nullptr for the process environment.
+     * @param[in] path Name of the section.
+     * @param[in] tracker Keys consumed by the parse.
+     *
+     * @returns Names of the variable named @p path and variables named with "<path>_" prefix not consumed.
+     */
+    inline std::vector<std::string> UnknownKeys(const source_type* source, const std::string& path,
+                                                const KeyTracker& tracker) const;
+
+    /**
+     * Copy the variable with name @p path and all variables named with "<path>_" prefix.
+     * Used to parse uconfig::LazyConfig as the environment was at the parse.
+     *
+     * @param[in] source Variables to parse from, nullptr for the process environment.
+     * @param[in] path Name of the section.
+     *
+     * @returns Table of the copied variables.
+     */
+    inline std::shared_ptr<const FlatKvTable> Capture(const source_type* source, const std::string& path) const;
+
+    /**
+     * Map reference of a placeholder to variable name, see uconfig::Interpolation.
+     *
+     * @param[in] reference Dot-delimited names, e.g. "server.host", or variable name, e.g. "SERVER_HOST".
+     *
+     * @returns Upper-cased '_' delimited name of the referenced variable, e.g. "SERVER_HOST".
+     */
+    inline std::string ReferencePath(const std::string& reference) const;
+
     /**
      * Construct array element name using '_' as delimiter.
      *
@@ -57,6 +124,16 @@ public:
                                                  std::size_t index) const noexcept override;
 
 private:
+    /// Check if variable @p name belongs to the section @p path.
+    static inline bool InSection(std::string_view name, const std::string& path) noexcept;
+    /// Continue @p hash with the kind, text and payload of @p value.
+    static inline std::uint64_t HashValue(const FlatKvTable::Scalar& value, std::uint64_t hash) noexcept;
+    /// Find "NAME=value" entry of the process environment for variable @p name, nullptr if there is none.
+    static inline const char* ProcessVariable(const std::string& name) noexcept;
+    /// Call @p visitor with name and value of each variable of @p source or the process environment.
+    template <typename VisitorT>
+    static void ForEachVariable(const source_type* source, const std::string& path, VisitorT&& visitor);
+
     /// Convert std::string to `T`.
     template <typename T>
     static std::optional<T> FromString(const std::string& str);
@@ -69,3 +146,13 @@ private:
 } // namespace uconfig
 
 #include "impl/Env.ipp"
+
+#ifdef UCONFIG_COMPILED
+#include "../Interface.h"
+#include "../detail/instantiate.h"
+
+namespace uconfig {
+// Defined in uconfig::compiled library.
+UCONFIG_INSTANTIATE_FORMAT(extern, EnvFormat)
+} // namespace uconfig
+#endif // UCONFIG_COMPILED
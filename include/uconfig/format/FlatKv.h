@@ -0,0 +1,313 @@
+#pragma once
+
+#include "../Objects.h"
+#include "Format.h"
+
+#include <cstdint>
+#include <map>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace uconfig {
+
+// Forward-declared FlatKvTable.
+class FlatKvTable;
+
+/**
+ * Flat key-value format.
+ * Parse values from uconfig::FlatKvTable, emit into uconfig::FlatKvTable.
+ *
+ * Table is built once from any source (environment, JSON document, key=value file) and then serves all lookups
+ *  with a binary search over contiguous storage. Names of configuration elements are the keys of the table,
+ *  vector elements are looked up by keys delimited with configured delimiter.
+ */
+class FlatKvFormat: public Format
+{
+public:
+    /// Name of the format. Used to form nice error-strings.
+    static inline const std::string name = "[FLATKV]";
+    /// uconfig::FlatKvTable to parse from.
+    using source_type = FlatKvTable;
+    /// uconfig::FlatKvTable to emit to.
+    using dest_type = FlatKvTable;
+
+    /**
+     * Constructor.
+     *
+     * @param[in] vector_delimiter Delimiter between vector and element index. Default "/" matches tables built
+     *  from JSON, use "_" for tables built from environment.
+     */
+    explicit FlatKvFormat(std::string vector_delimiter = "/");
+
+    /**
+     * Parse the value with key @p path from @p source table.
+     *
+     * @tparam T Type to parse.
+     *
+     * @param[in] source Table to parse from.
+     * @param[in] path Key of the value.
+     *
+     * @returns Value wrapped in std::optional or std::nullopt.
+     */
+    template <typename T>
+    std::optional<T> Parse(const source_type* source, const std::string& path) const;
+
+    /**
+     * Emit the (@p path, @p value) pair into @p dest. Call FlatKvTable::Build() on @p dest before lookups.
+     *
+     * @tparam T Type to emit.
+     *
+     * @param[in] dest Table to emit to.
+     * @param[in] path Key of the value.
+     * @param[in] value Value to emit.
+     */
+    template <typename T>
+    void Emit(dest_type* dest, const std::string& path, const T& value) const;
+
+    /**
+     * Construct key of the vector element using configured delimiter.
+     *
+     * @param[in] vector_path Key of the vector itself.
+     * @param[in] index Position in the vector to make path to.
+     *
+     * @returns Delimited key of the element at @p index, e.g. "/hosts/0"
+     *  for @p vector_path = "/hosts" and @p index = 0 with "/" delimiter.
+     */
+    inline virtual std::string VectorElementPath(const std::string& vector_path,
+                                                 std::size_t index) const noexcept override;
+
+private:
+    std::string vector_delimiter_;
+};
+
+/**
+ * Sorted contiguous table of (key, typed scalar) pairs.
+ * Keys and texts are interned into a single buffer, entries are sorted by key to be looked up with binary search.
+ * Entries are added with Add() and become visible to lookups after Build().
+ */
+class FlatKvTable
+{
+public:
+    /// Kind of the stored scalar.
+    enum class Kind : std::uint8_t
+    {
+        Null,     ///< No value.
+        Text,     ///< Untyped text, e.g. from environment, converted on lookup.
+        String,   ///< String only.
+        Bool,     ///< Boolean.
+        Integer,  ///< Signed integer.
+        Unsigned, ///< Unsigned integer not fitting into signed one.
+        Double,   ///< Floating point.
+    };
+
+    /// Typed scalar. Text refers to the table storage and is valid until the table is modified.
+    struct Scalar
+    {
+        Kind kind = Kind::Null;
+        std::string_view text;
+        union
+        {
+            std::int64_t integer = 0;
+            std::uint64_t unsigned_integer;
+            double floating;
+            bool boolean;
+        };
+
+        /// Make null scalar.
+        static Scalar MakeNull() noexcept;
+        /// Make untyped text scalar.
+        static Scalar MakeText(std::string_view value) noexcept;
+        /// Make string scalar.
+        static Scalar MakeString(std::string_view value) noexcept;
+        /// Make boolean scalar.
+        static Scalar MakeBool(bool value) noexcept;
+        /// Make signed integer scalar.
+        static Scalar MakeInteger(std::int64_t value) noexcept;
+        /// Make unsigned integer scalar.
+        static Scalar MakeUnsigned(std::uint64_t value) noexcept;
+        /// Make floating point scalar.
+        static Scalar MakeDouble(double value) noexcept;
+    };
+
+    /**
+     * Build table from environment block.
+     *
+     * @param[in] envp Null-terminated array of "NAME=value" strings, e.g. `environ` or third argument of main().
+     *
+     * @returns Built table of untyped values.
+     */
+    static FlatKvTable FromEnv(const char* const* envp);
+
+    /// Build table from the environment of the process.
+    static FlatKvTable FromEnv();
+
+    /**
+     * Build table from environment variables emitted by uconfig::EnvFormat.
+     *
+     * @param[in] variables Map of variable names to values.
+     *
+     * @returns Built table of untyped values.
+     */
+    static FlatKvTable FromEnv(const std::map<std::string, std::string>& variables);
+
+    /**
+     * Build table from environment block of '\0'-terminated "NAME=value" strings, e.g. `/proc/<pid>/environ`.
+     *
+     * @param[in] block Contents of the block.
+     *
+     * @returns Built table of untyped values.
+     */
+    static FlatKvTable FromEnvBlock(std::string_view block);
+
+    /**
+     * Build table from "key=value" lines. Empty lines and lines starting with '#' are skipped,
+     *  whitespaces around keys are trimmed.
+     *
+     * @param[in] contents Lines to parse.
+     *
+     * @returns Built table of untyped values.
+     *
+     * @throws uconfig::ParseError Thrown if some of the lines are not valid.
+     */
+    static FlatKvTable FromLines(std::string_view contents);
+
+    /**
+     * Build table from "key=value" file.
+     *
+     * @param[in] path Path to the file.
+     *
+     * @returns Built table of untyped values.
+     *
+     * @throws uconfig::ParseError Thrown if the file failed to be read or some of the lines are not valid.
+     */
+    static FlatKvTable FromFile(const std::string& path);
+
+    /**
+     * Build table from rapidjson-like value. Keys are JSON-pointers to the scalars, same as for
+     *  uconfig::RapidjsonFormat.
+     *
+     * @tparam JsonValueT Type of the JSON-value, e.g. rapidjson::Value.
+     *
+     * @param[in] json JSON-value to flatten.
+     *
+     * @returns Built table of typed values.
+     */
+    template <typename JsonValueT>
+    static FlatKvTable FromJson(const JsonValueT& json);
+
+    /**
+     * Add the (@p key, @p value) pair. Added later value wins for the duplicating keys.
+     *
+     * @param[in] key Key of the value.
+     * @param[in] value Value to add, text is copied into the table.
+     */
+    void Add(std::string_view key, const Scalar& value);
+
+    /// Sort and deduplicate added entries, making them visible to lookups.
+    void Build();
+
+    /**
+     * Find the value with @p key.
+     *
+     * @param[in] key Key of the value.
+     *
+     * @returns Value or std::nullopt if there is no such key.
+     */
+    std::optional<Scalar> Find(std::string_view key) const noexcept;
+
+    /**
+     * Find index of the entry with @p key.
+     *
+     * @param[in] key Key of the entry.
+     *
+     * @returns Index of the entry or std::nullopt if there is no such key.
+     */
+    std::optional<std::size_t> Index(std::string_view key) const noexcept;
+
+    /**
+     * Find entries with keys starting with @p prefix.
+     *
+     * @param[in] prefix Prefix of the keys, e.g. path to the vector or nested config.
+     *
+     * @returns Half-open range [first, last) of entry indices.
+     */
+    std::pair<std::size_t, std::size_t> Range(std::string_view prefix) const noexcept;
+
+    /// Get key of the entry at @p index.
+    std::string_view Key(std::size_t index) const noexcept;
+    /// Get value of the entry at @p index.
+    Scalar Value(std::size_t index) const noexcept;
+    /// Get number of entries visible to lookups.
+    std::size_t Size() const noexcept;
+
+    /// Get size of the image written by WriteImage().
+    std::size_t ImageSize() const noexcept;
+
+    /**
+     * Write position-independent image of the built entries.
+     *
+     * @param[out] dest Memory of at least ImageSize() bytes aligned to 8 bytes.
+     */
+    void WriteImage(void* dest) const noexcept;
+
+    /**
+     * Make a table referring to the image written by WriteImage(), without copying it.
+     * Image memory should outlive the table. Lookups never read outside of @p size bytes,
+     *  even if the image is being overwritten concurrently. Table is copied out of the image on Add().
+     *
+     * @param[in] image Image memory aligned to 8 bytes.
+     * @param[in] size Size of the image memory.
+     *
+     * @returns Table referring to the image.
+     *
+     * @throws uconfig::ParseError Thrown if @p image is not a valid image.
+     */
+    static FlatKvTable FromImage(const void* image, std::size_t size);
+
+private:
+    /// Stored entry, refers to the storage by offsets so it may be copied as is.
+    struct Entry
+    {
+        std::uint64_t key_offset = 0;
+        std::uint64_t key_size = 0;
+        std::uint64_t text_offset = 0;
+        std::uint64_t text_size = 0;
+        std::uint64_t payload = 0;
+        std::uint64_t kind = 0;
+    };
+
+    /// Header of the image.
+    struct ImageHeader
+    {
+        std::uint64_t magic = 0;
+        std::uint64_t entries_size = 0;
+        std::uint64_t storage_size = 0;
+        std::uint64_t reserved = 0;
+    };
+
+    /// Image signature, "UCFGKV01".
+    static constexpr std::uint64_t kImageMagic = 0x3130564b47464355;
+
+    /// Flatten JSON-value @p json at @p path.
+    template <typename JsonValueT>
+    void AddJson(const JsonValueT& json, std::string& path);
+
+    /// Get entries either of own or referred image.
+    const Entry* Entries() const noexcept;
+    /// Get @p size bytes of the storage at @p offset, clamped to the storage.
+    std::string_view Slice(std::uint64_t offset, std::uint64_t size) const noexcept;
+    std::string_view KeyOf(const Entry& entry) const noexcept;
+
+private:
+    std::string storage_;
+    std::vector<Entry> entries_;
+    std::size_t built_ = 0;
+
+    const Entry* image_entries_ = nullptr;
+    std::string_view image_storage_;
+};
+
+} // namespace uconfig
+
+#include "impl/FlatKv.ipp"
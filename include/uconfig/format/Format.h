@@ -1,5 +1,9 @@
 #pragma once
 
+#include "../FormatState.h"
+#include "../Profiler.h"
+#include "../Strict.h"
+
 #include <optional>
 #include <string>
 
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "../Diff.h"
+#include "../detail/detail.h"
 #include "Format.h"
 
 // Enable std:string for rapidjson
@@ -16,6 +18,15 @@
 
 #include <rapidjson/document.h>
 #include <rapidjson/pointer.h>
+#include <rapidjson/writer.h>
+
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
 
 namespace uconfig {
 
@@ -44,6 +55,18 @@ public:
     /// rapidjson::Document to emit to.
     using dest_type = json_doc_type;
 
+    /// Default minimum number of members of a JSON-object to look them up by hash.
+    static constexpr std::size_t kIndexThreshold = 32;
+
+    /**
+     * Constructor.
+     *
+     * @param[in] index_threshold Minimum number of members of a JSON-object to look them up by hash instead of
+     *  a linear scan. Index of such object is built on the first lookup during a config parse and dropped at the
+     *  end of it. Default kIndexThreshold, std::numeric_limits<std::size_t>::max() disables indexing.
+     */
+    explicit RapidjsonFormat(std::size_t index_threshold = kIndexThreshold);
+
     /**
      * Parse the value at @p path from @p source JSON.
      *
@@ -69,6 +92,90 @@ public:
     template <typename T>
     void Emit(dest_type* dest, const std::string& path, const T& value) const;
 
+    /**
+     * Serialize JSON @p dest into @p stream, e.g. uconfig::AtomicFileWriter.
+     *
+     * @tparam StreamT rapidjson OutputStream.
+     *
+     * @param[in] dest JSON object emitted to.
+     * @param[in] stream Stream to write into.
+     */
+    template <typename StreamT>
+    void Write(const dest_type* dest, StreamT* stream) const;
+
+    /**
+     * Emit JSON Patch (RFC 6902) applying @p changes, see uconfig::Diff().
+     *
+     * @param[in] changes Changes between two configs.
+     * @param[in] after JSON object the config after the changes has been emitted to, values are copied from it.
+     * @param[out] patch JSON object to emit the array of operations to.
+     *
+     * @throws uconfig::EmitError Thrown if a value added or replaced is absent in @p after.
+     */
+    void EmitPatch(const std::vector<Change>& changes, const dest_type* after, dest_type* patch) const;
+
+    /**
+     * Get size of the JSON-array at @p path. Used to parse large uconfig::Vector in parallel.
+     *
+     * @param[in] source JSON object to parse from.
+     * @param[in] path JSON-path to the array.
+     *
+     * @returns Number of the array elements or std::nullopt if there is no array at @p path.
+     */
+    std::optional<std::size_t> VectorSize(const json_value_type* source, const std::string& path) const;
+
+    /**
+     * Get hash of the JSON-value at @p path with all its' children. Used to skip unchanged sections of configs
+     *  with memoization enabled.
+     *
+     * @param[in] source JSON object to parse from.
+     * @param[in] path JSON-path to the value.
+     *
+     * @returns Hash of the value, absent value has a hash as well.
+     */
+    std::optional<std::uint64_t> SubtreeHash(const json_value_type* source, const std::string& path) const;
+
+    /**
+     * Get view of the JSON-string at @p path. Used to intern strings without a copy.
+     *
+     * @param[in] source JSON object to parse from.
+     * @param[in] path JSON-path to the string.
+     *
+     * @returns View into @p source or std::nullopt if there is no string at @p path.
+     */
+    std::optional<std::string_view> StringView(const json_value_type* source, const std::string& path) const;
+
+    /**
+     * Get paths to the members of the JSON-value at @p path not consumed by a strict parse.
+     *
+     * @param[in] source JSON object parsed from.
+     * @param[in] path JSON-path to the value.
+     * @param[in] tracker Keys consumed by the parse.
+     *
+     * @returns JSON-paths to the members (and array elements) of the value which have not been looked up.
+     */
+    std::vector<std::string> UnknownKeys(const json_value_type* source, const std::string& path,
+                                         const KeyTracker& tracker) const;
+
+    /**
+     * Copy the JSON-value at @p path out of @p source. Used to parse uconfig::LazyConfig after @p source is gone.
+     *
+     * @param[in] source JSON object to parse from.
+     * @param[in] path JSON-path to the value.
+     *
+     * @returns JSON object holding a copy of the value at the same @p path, empty if there is no value.
+     */
+    std::shared_ptr<const json_value_type> Capture(const json_value_type* source, const std::string& path) const;
+
+    /**
+     * Map reference of a placeholder to JSON-path, see uconfig::Interpolation.
+     *
+     * @param[in] reference Dot-delimited names, e.g. "server.host", or JSON-path, e.g. "/server/host".
+     *
+     * @returns JSON-path to the referenced value.
+     */
+    std::string ReferencePath(const std::string& reference) const;
+
     /**
      * Construct JSON-path to a array element at @p index.
      *
@@ -79,11 +186,43 @@ public:
      */
     virtual std::string VectorElementPath(const std::string& vector_path, std::size_t index) const noexcept override;
 
+    /// Hashed index of members of wide JSON-objects, kept for one config parse. Thread-safe.
+    class MemberIndex
+    {
+    public:
+        /// Constructor, takes the threshold of @p format.
+        explicit MemberIndex(const RapidjsonFormat& format) noexcept;
+        /// Copy constructor.
+        MemberIndex(const MemberIndex&) = delete;
+        /// Copy assignment.
+        MemberIndex& operator=(const MemberIndex&) = delete;
+
+        /// Find value of the first member of @p object named @p name, nullptr if there is none.
+        const json_value_type* Find(const json_value_type& object, std::string_view name);
+        /// Get number of indexed objects.
+        std::size_t Size() const;
+
+    private:
+        std::size_t threshold_;
+        mutable std::shared_mutex mutex_;
+        std::unordered_map<const json_value_type*, std::unordered_map<std::string_view, std::size_t>> objects_;
+    };
+
+    /// State of a config parse, see uconfig::FormatState.
+    using parse_state = MemberIndex;
+
 private:
+    /// Find value of the first member of @p object named @p name by a linear scan, nullptr if there is none.
+    static const json_value_type* FindMember(const json_value_type& object, std::string_view name) noexcept;
     /// Get the value from @p source at @p path.
-    static const json_value_type* Get(const json_value_type* source, const std::string& path);
+    const json_value_type* Get(const json_value_type* source, const std::string& path) const;
     /// Set the value int @p dest at @p path.
     static void Set(json_value_type&& value, const std::string& path, dest_type* dest);
+    /// Append paths to the children of @p value at @p path not consumed according to @p tracker to @p keys.
+    static void CollectUnknownKeys(const json_value_type& value, const std::string& path, const KeyTracker& tracker,
+                                   std::vector<std::string>& keys);
+    /// Continue @p hash with JSON-value @p value.
+    static std::uint64_t Hash(const json_value_type& value, std::uint64_t hash) noexcept;
 
     /// Convert JSON-value @p source into a std::string.
     template <typename T, typename std::enable_if<std::is_same<T, std::string>::value>::type* = nullptr>
@@ -132,8 +271,22 @@ private:
     // Helper to make a JSON-value from SrcT.
     template <typename SrcT, typename std::enable_if<std::is_same<SrcT, std::string>::value>::type* = nullptr>
     static json_value_type MakeJson(const SrcT& source, allocator_type& alloc);
+
+private:
+    std::size_t index_threshold_;
 };
 
 } // namespace uconfig
 
 #include "impl/Rapidjson.ipp"
+
+#ifdef UCONFIG_COMPILED_RAPIDJSON
+#include "../Interface.h"
+#include "../detail/instantiate.h"
+
+namespace uconfig {
+// Defined in uconfig::compiled library.
+extern template class RapidjsonFormat<>;
+UCONFIG_INSTANTIATE_FORMAT(extern, RapidjsonFormat<>)
+} // namespace uconfig
+#endif // UCONFIG_COMPILED_RAPIDJSON
@@ -0,0 +1,293 @@
+#pragma once
+
+#include "../Objects.h"
+#include "Format.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace uconfig {
+
+// Forward-declared YamlDocument.
+class YamlDocument;
+
+/**
+ * YAML format.
+ * Parse values from uconfig::YamlDocument, emit into uconfig::YamlDocument.
+ *
+ * Only block subset of YAML is supported: mappings, sequences, plain and quoted scalars and comments.
+ * Names of configuration elements are treated as JSON-pointers, same as for uconfig::RapidjsonFormat.
+ */
+class YamlFormat: public Format
+{
+public:
+    /// Name of the format. Used to form nice error-strings.
+    static inline const std::string name = "[YAML]";
+    /// uconfig::YamlDocument to parse from.
+    using source_type = YamlDocument;
+    /// uconfig::YamlDocument to emit to.
+    using dest_type = YamlDocument;
+
+    /**
+     * Parse the value at @p path from @p source document.
+     *
+     * @tparam T Type to parse.
+     *
+     * @param[in] source YAML document to parse from.
+     * @param[in] path JSON-pointer like path to the value.
+     *
+     * @returns Value wrapped in std::optional or std::nullopt.
+     */
+    template <typename T>
+    std::optional<T> Parse(const source_type* source, const std::string& path) const;
+
+    /**
+     * Emit the value at @p path to @p dest document.
+     *
+     * @tparam T Type to emit.
+     *
+     * @param[in] dest YAML document to emit to.
+     * @param[in] path JSON-pointer like path to the value.
+     * @param[in] value Value to emit.
+     */
+    template <typename T>
+    void Emit(dest_type* dest, const std::string& path, const T& value) const;
+
+    /**
+     * Get size of the sequence at @p path. Used to parse large uconfig::Vector in parallel.
+     *
+     * @param[in] source Document to parse from.
+     * @param[in] path Path to the sequence.
+     *
+     * @returns Number of the sequence elements or std::nullopt if there is no sequence at @p path.
+     */
+    inline std::optional<std::size_t> VectorSize(const source_type* source, const std::string& path) const;
+
+    /**
+     * Get hash of the node at @p path with all its' children. Used to skip unchanged sections of configs
+     *  with memoization enabled.
+     *
+     * @param[in] source Document to parse from.
+     * @param[in] path Path to the node.
+     *
+     * @returns Hash of the node, absent node has a hash as well.
+     */
+    inline std::optional<std::uint64_t> SubtreeHash(const source_type* source, const std::string& path) const;
+
+    /**
+     * Get view of the scalar at @p path. Used to intern strings without a copy.
+     *
+     * @param[in] source Document to parse from.
+     * @param[in] path Path to the scalar.
+     *
+     * @returns View into @p source or std::nullopt if there is no scalar at @p path.
+     */
+    inline std::optional<std::string_view> StringView(const source_type* source, const std::string& path) const;
+
+    /**
+     * Get paths to the mapping members and sequence elements of the node at @p path not consumed by a strict parse.
+     *
+     * @param[in] source Document parsed from.
+     * @param[in] path Path to the node.
+     * @param[in] tracker Keys consumed by the parse.
+     *
+     * @returns Paths to the members and elements of the node which have not been looked up.
+     */
+    inline std::vector<std::string> UnknownKeys(const source_type* source, const std::string& path,
+                                                const KeyTracker& tracker) const;
+
+    /**
+     * Construct path to a sequence element at @p index.
+     *
+     * @param[in] vector_path Path to the sequence itself.
+     * @param[in] index Position in the sequence to make path to.
+     *
+     * @returns Path to the sequence element at @p index, e.g. "/list/0".
+     */
+    inline virtual std::string VectorElementPath(const std::string& vector_path,
+                                                 std::size_t index) const noexcept override;
+
+private:
+    /// Convert YAML scalar @p text into `T`. Quoted scalars are converted only into std::string.
+    template <typename T>
+    static std::optional<T> FromScalar(std::string_view text, bool quoted);
+
+    /// Convert `T` into YAML scalar.
+    template <typename T>
+    static std::string ToScalar(const T& value);
+};
+
+/**
+ * YAML document.
+ * Parsed in a single pass into a compact index of nodes which reference spans of the source text,
+ *  no intermediate DOM of strings is built.
+ */
+class YamlDocument
+{
+public:
+    /// Type of the node identifier.
+    using node_id = std::uint32_t;
+    /// Identifier of the absent node.
+    static constexpr node_id npos = static_cast<node_id>(-1);
+
+    /// Type of the node.
+    enum class NodeType : std::uint8_t
+    {
+        Null,     ///< Empty or null value.
+        Scalar,   ///< Plain or quoted scalar.
+        Mapping,  ///< Block mapping.
+        Sequence, ///< Block sequence.
+    };
+
+    /// Constructor. Creates empty document to emit into.
+    YamlDocument();
+
+    /**
+     * Constructor. Parses @p text.
+     *
+     * @param[in] text YAML text to parse.
+     *
+     * @throws uconfig::ParseError Thrown if @p text is not valid or uses unsupported YAML features.
+     */
+    explicit YamlDocument(std::string text);
+
+    /**
+     * Find node at @p path.
+     *
+     * @param[in] path JSON-pointer like path to the node, empty path means root.
+     * @param[in] tracker Tracker to mark the nodes on the way to the found one as visited in, by their identifiers.
+     *
+     * @returns Identifier of the node or npos if not found.
+     */
+    node_id Find(const std::string& path, KeyTracker* tracker = nullptr) const;
+
+    /// Get type of the node @p id.
+    NodeType Type(node_id id) const noexcept;
+    /// Get text of the scalar node @p id.
+    std::string_view Scalar(node_id id) const noexcept;
+    /// Check if scalar node @p id has been quoted.
+    bool Quoted(node_id id) const noexcept;
+    /// Get key of the mapping member @p id.
+    std::string_view Key(node_id id) const noexcept;
+    /// Get number of children of the node @p id.
+    std::size_t Size(node_id id) const noexcept;
+    /// Get child of the node @p parent at @p index or npos if there is no such child.
+    node_id Child(node_id parent, std::size_t index) const noexcept;
+    /// Get hash of the node @p id with all its' children, equal nodes have equal hashes.
+    std::uint64_t Hash(node_id id) const noexcept;
+
+    /**
+     * Set scalar node at @p path creating all missing parents.
+     *
+     * @param[in] path JSON-pointer like path to the node.
+     * @param[in] scalar Text of the scalar.
+     * @param[in] quoted If scalar should be treated as string only.
+     */
+    void Set(const std::string& path, std::string_view scalar, bool quoted);
+
+    /**
+     * Serialize document into YAML text.
+     *
+     * @returns YAML text.
+     */
+    std::string Dump() const;
+
+    /// Compare documents by structure and values.
+    bool operator==(const YamlDocument& other) const noexcept;
+    /// Compare documents by structure and values.
+    bool operator!=(const YamlDocument& other) const noexcept;
+
+private:
+    /// Reference to a text, either in the source or in the owned storage.
+    struct Span
+    {
+        std::uint32_t offset = 0;
+        std::uint32_t size = 0;
+        bool owned = false;
+    };
+
+    /// Single node of the document.
+    struct Node
+    {
+        NodeType type = NodeType::Null;
+        bool quoted = false;
+        Span key;
+        Span value;
+        std::uint32_t size = 0;
+        node_id first_child = npos;
+        node_id last_child = npos;
+        node_id next_sibling = npos;
+        std::uint32_t children_offset = 0;
+    };
+
+    /// Open container while parsing.
+    struct Frame
+    {
+        std::size_t indent;
+        node_id node;
+    };
+
+    /// State of the single-pass parser.
+    struct ParseState
+    {
+        std::vector<Frame> stack;
+        node_id pending = npos;
+        std::size_t pending_indent = 0;
+        bool pending_from_key = false;
+        std::size_t line_no = 0;
+    };
+
+    /// Slot of the hashed index of mapping members.
+    struct MemberSlot
+    {
+        node_id parent = npos;
+        node_id member = npos;
+    };
+
+    /// Mappings of at least this many members are looked up by the hashed index instead of a scan.
+    static constexpr std::uint32_t kIndexedMembers = 8;
+
+    std::string_view View(const Span& span) const noexcept;
+    Span Own(std::string_view text);
+    Span Source(std::string_view text) const noexcept;
+
+    node_id AddChild(node_id parent, Span key);
+    node_id Member(node_id parent, std::string_view key) const noexcept;
+    void IndexMember(node_id parent, node_id member);
+    void UnindexMembers(node_id parent);
+    static std::uint64_t MemberHash(node_id parent, std::string_view key) noexcept;
+    void Reindex();
+
+    void ParseLine(ParseState& state, std::string_view line);
+    void ParseEntry(ParseState& state, node_id container, std::size_t indent, std::string_view content);
+    void ParseScalar(const ParseState& state, node_id node, std::string_view text);
+    Span ParseQuoted(const ParseState& state, std::string_view text, std::size_t* consumed);
+    [[noreturn]] static void Fail(std::size_t line_no, const std::string& what);
+
+    void DumpBlock(std::string& out, node_id id, std::size_t indent, bool inline_first) const;
+    static void DumpScalar(std::string& out, std::string_view text, bool quoted);
+    bool Equal(node_id id, const YamlDocument& other, node_id other_id) const noexcept;
+
+private:
+    std::string source_;
+    std::string storage_;
+    std::vector<Node> nodes_;
+    std::vector<node_id> children_;
+    bool indexed_ = false;
+    std::vector<MemberSlot> member_index_;
+    std::size_t indexed_members_ = 0;
+};
+
+namespace detail {
+
+/// Append paths to the children of node @p id at @p path not consumed according to @p tracker to @p keys.
+void yaml_collect_unknown_keys(const YamlDocument& source, YamlDocument::node_id id, const std::string& path,
+                               const KeyTracker& tracker, std::vector<std::string>& keys);
+
+} // namespace detail
+
+} // namespace uconfig
+
+#include "impl/Yaml.ipp"
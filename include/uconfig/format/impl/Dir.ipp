@@ -0,0 +1,323 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <climits>
+#include <cstring>
+#include <type_traits>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace uconfig {
+
+template <typename T>
+std::optional<T> DirFormat::Parse(const source_type* source, const std::string& path) const
+{
+    std::optional<std::string_view> contents = source->Get(path);
+    if (!contents) {
+        return std::nullopt;
+    }
+
+    // files are usually written with a trailing newline
+    std::string_view value = *contents;
+    if (!value.empty() && value.back() == '\n') {
+        value.remove_suffix(1);
+        if (!value.empty() && value.back() == '\r') {
+            value.remove_suffix(1);
+        }
+    }
+
+    ParseProfiler::PhaseTimer timer(ParseProfiler::Phase::Convert);
+    return FromString<T>(value);
+}
+
+template <typename T>
+void DirFormat::Emit(dest_type* dest, const std::string& path, const T& value) const
+{
+    dest->emplace(std::make_pair(path, ToString<T>(value)));
+}
+
+std::string DirFormat::VectorElementPath(const std::string& vector_path, std::size_t index) const noexcept
+{
+    return vector_path + "." + std::to_string(index);
+}
+
+template <typename T>
+std::optional<T> DirFormat::FromString(std::string_view str)
+{
+    if constexpr (std::is_same<T, std::string>::value) {
+        return std::string(str);
+    } else if constexpr (std::is_same<T, bool>::value) {
+        if (str == "true") {
+            return true;
+        }
+        if (str == "false") {
+            return false;
+        }
+        return std::nullopt;
+    } else if constexpr (std::is_arithmetic<T>::value) {
+        T result;
+        const char* end = str.data() + str.size();
+        auto [ptr, ec] = std::from_chars(str.data(), end, result);
+        if (ec != std::errc() || ptr != end) {
+            return std::nullopt;
+        }
+        return result;
+    } else {
+        static_assert(std::is_same<T, void>::value, "type is not supported by DirFormat, provide specialization");
+    }
+}
+
+template <typename T>
+std::string DirFormat::ToString(const T& value)
+{
+    if constexpr (std::is_same<T, std::string>::value) {
+        return value;
+    } else if constexpr (std::is_same<T, bool>::value) {
+        return value ? "true" : "false";
+    } else if constexpr (std::is_arithmetic<T>::value) {
+        char buffer[64];
+        auto [ptr, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        if (ec != std::errc()) {
+            throw std::runtime_error("failed to print value");
+        }
+        return std::string(buffer, ptr);
+    } else {
+        static_assert(std::is_same<T, void>::value, "type is not supported by DirFormat, provide specialization");
+    }
+}
+
+inline DirSource::DirSource(const std::string& root, std::size_t mmap_threshold)
+    : DirSource(root, nullptr, mmap_threshold)
+{
+}
+
+inline DirSource::DirSource(const std::string& root, FileLoader& loader, std::size_t mmap_threshold)
+    : DirSource(root, &loader, mmap_threshold)
+{
+}
+
+inline DirSource::DirSource(const std::string& root, FileLoader* loader, std::size_t mmap_threshold)
+    : root_(root)
+{
+    DIR* dir = ::opendir(root_.c_str());
+    if (!dir) {
+        Fail("", errno);
+    }
+    const int dir_fd = ::dirfd(dir);
+
+    // Kubernetes updates all the keys at once by swapping `..data` symlink to a new version of the files, keys are
+    //  symlinks into it: the version is resolved once, so files of two versions are never mixed
+    std::string data_name = "..data";
+    char data_target[PATH_MAX];
+    const ssize_t data_target_size = ::readlinkat(dir_fd, data_name.c_str(), data_target, sizeof(data_target));
+    if (data_target_size > 0 && static_cast<std::size_t>(data_target_size) < sizeof(data_target)) {
+        data_name.assign(data_target, static_cast<std::size_t>(data_target_size));
+    }
+    const int data_fd = ::openat(dir_fd, data_name.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    const std::string data_path = data_name.front() == '/' ? data_name : root_ + "/" + data_name;
+
+    const auto close_dirs = [&]() {
+        if (data_fd >= 0) {
+            ::close(data_fd);
+        }
+        ::closedir(dir);
+    };
+    const auto file_fd = [&](const Entry& entry) { return entry.in_data ? data_fd : dir_fd; };
+    const auto file_name = [](const Entry& entry) -> const std::string& {
+        return entry.in_data ? entry.data_name : entry.name;
+    };
+
+    // single pass over the directory: collect regular files (following symlinks) with their sizes
+    std::size_t buffer_size = 0;
+    while (true) {
+        errno = 0;
+        const dirent* dir_entry = ::readdir(dir);
+        if (!dir_entry) {
+            if (errno != 0) {
+                const int error = errno;
+                close_dirs();
+                Fail("", error);
+            }
+            break;
+        }
+
+        const std::string_view name = dir_entry->d_name;
+        if (name == "." || name.substr(0, 2) == "..") {
+            continue;
+        }
+
+        Entry entry;
+        entry.name = name;
+        if (data_fd >= 0 && (dir_entry->d_type == DT_LNK || dir_entry->d_type == DT_UNKNOWN)) {
+            char target[PATH_MAX];
+            const ssize_t target_size = ::readlinkat(dir_fd, dir_entry->d_name, target, sizeof(target));
+            const std::string_view link(target, target_size > 0 ? static_cast<std::size_t>(target_size) : 0);
+            static constexpr std::string_view kDataPrefix = "..data/";
+            if (link.size() < sizeof(target) && link.substr(0, kDataPrefix.size()) == kDataPrefix) {
+                entry.in_data = true;
+                entry.data_name = link.substr(kDataPrefix.size());
+            }
+        }
+
+        struct stat file_stat;
+        if (::fstatat(file_fd(entry), file_name(entry).c_str(), &file_stat, 0) != 0 || !S_ISREG(file_stat.st_mode)) {
+            continue;
+        }
+
+        entry.size = static_cast<std::size_t>(file_stat.st_size);
+        if (entry.size < mmap_threshold || entry.size == 0) {
+            entry.offset = buffer_size;
+            buffer_size += entry.size;
+        }
+        entries_.emplace_back(std::move(entry));
+    }
+    std::sort(entries_.begin(), entries_.end(),
+              [](const Entry& lhs, const Entry& rhs) { return lhs.name < rhs.name; });
+
+    // small files go into a single buffer allocated once, large ones are mapped
+    buffer_.resize(buffer_size);
+    std::vector<std::size_t> batched;
+    std::vector<std::string> batched_paths;
+    for (std::size_t index = 0; index < entries_.size(); ++index) {
+        Entry& entry = entries_[index];
+        if (loader && entry.size < mmap_threshold) {
+            if (entry.size > 0) {
+                batched.push_back(index);
+                batched_paths.push_back((entry.in_data ? data_path : root_) + "/" + file_name(entry));
+            }
+            continue;
+        }
+
+        const int fd = ::openat(file_fd(entry), file_name(entry).c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            const int error = errno;
+            close_dirs();
+            Unmap();
+            Fail(entry.name, error);
+        }
+
+        int error = 0;
+        if (entry.size >= mmap_threshold && entry.size > 0) {
+            void* mapping = ::mmap(nullptr, entry.size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping == MAP_FAILED) {
+                error = errno;
+            } else {
+                entry.mapping = mapping;
+            }
+        } else {
+            std::size_t read_size = 0;
+            while (read_size < entry.size) {
+                const ssize_t chunk = ::pread(fd, &buffer_[entry.offset + read_size], entry.size - read_size,
+                                              static_cast<off_t>(read_size));
+                if (chunk < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (chunk < 0) {
+                    error = errno;
+                    break;
+                }
+                if (chunk == 0) {
+                    // file has been truncated after enumeration
+                    break;
+                }
+                read_size += static_cast<std::size_t>(chunk);
+            }
+            entry.size = read_size;
+        }
+        ::close(fd);
+
+        if (error != 0) {
+            close_dirs();
+            Unmap();
+            Fail(entry.name, error);
+        }
+    }
+    close_dirs();
+
+    if (batched.empty()) {
+        return;
+    }
+    try {
+        loader->Load(batched_paths, [this, &batched](std::size_t index, std::string&& contents) {
+            // file may have been changed after enumeration, it is cut to the enumerated size
+            Entry& entry = entries_[batched[index]];
+            entry.size = std::min(entry.size, contents.size());
+            std::memcpy(&buffer_[entry.offset], contents.data(), entry.size);
+        });
+    } catch (...) {
+        Unmap();
+        throw;
+    }
+}
+
+inline DirSource::DirSource(DirSource&& other) noexcept
+    : root_(std::move(other.root_))
+    , entries_(std::move(other.entries_))
+    , buffer_(std::move(other.buffer_))
+{
+    other.entries_.clear();
+}
+
+inline DirSource& DirSource::operator=(DirSource&& other) noexcept
+{
+    if (this != &other) {
+        Unmap();
+        root_ = std::move(other.root_);
+        entries_ = std::move(other.entries_);
+        buffer_ = std::move(other.buffer_);
+        other.entries_.clear();
+    }
+    return *this;
+}
+
+inline DirSource::~DirSource()
+{
+    Unmap();
+}
+
+inline std::optional<std::string_view> DirSource::Get(std::string_view name) const noexcept
+{
+    auto entry_it = std::lower_bound(entries_.begin(), entries_.end(), name,
+                                     [](const Entry& entry, std::string_view key) { return entry.name < key; });
+    if (entry_it == entries_.end() || entry_it->name != name) {
+        return std::nullopt;
+    }
+    if (entry_it->mapping) {
+        return std::string_view(static_cast<const char*>(entry_it->mapping), entry_it->size);
+    }
+    return std::string_view(buffer_).substr(entry_it->offset, entry_it->size);
+}
+
+inline const std::string& DirSource::Root() const noexcept
+{
+    return root_;
+}
+
+inline std::size_t DirSource::Size() const noexcept
+{
+    return entries_.size();
+}
+
+inline void DirSource::Fail(const std::string& name, int error) const
+{
+    const std::string path = name.empty() ? root_ : root_ + "/" + name;
+    throw ParseError(DirFormat::name + " '" + path + "' failed to be read: " + std::strerror(error));
+}
+
+inline void DirSource::Unmap() noexcept
+{
+    for (auto& entry : entries_) {
+        if (entry.mapping) {
+            ::munmap(entry.mapping, entry.size);
+            entry.mapping = nullptr;
+        }
+    }
+}
+
+} // namespace uconfig
@@ -1,19 +1,56 @@
 #pragma once
 
+#include <cctype>
 #include <cstdlib>
+#include <cstring>
 #include <limits>
 #include <sstream>
+#include <string_view>
+
+#include <unistd.h>
 
 namespace uconfig {
 
 template <typename T>
-std::optional<T> EnvFormat::Parse(const source_type*, const std::string& path) const
+std::optional<T> EnvFormat::Parse(const source_type* source, const std::string& path) const
 {
-    const char* env_var = std::getenv(path.c_str());
-    if (!env_var) {
+    // name refers to the table storage or the environment, so it identifies the variable
+    std::string_view name;
+    FlatKvTable::Scalar value;
+    if (source) {
+        const std::optional<std::size_t> index = source->Index(path);
+        if (!index) {
+            return std::nullopt;
+        }
+        name = source->Key(*index);
+        value = source->Value(*index);
+    } else if (KeyTracker::Current()) {
+        // getenv() is not guaranteed to point into the entry of the environment, so it is looked up directly
+        const char* process_var = ProcessVariable(path);
+        if (!process_var) {
+            return std::nullopt;
+        }
+        name = std::string_view(process_var, path.size());
+        value = FlatKvTable::Scalar::MakeText(process_var + path.size() + 1);
+    } else if (const char* process_var = std::getenv(path.c_str())) {
+        value = FlatKvTable::Scalar::MakeText(process_var);
+    } else {
+        return std::nullopt;
+    }
+
+    if (KeyTracker* tracker = KeyTracker::Current()) {
+        tracker->Consume(reinterpret_cast<KeyTracker::node_key>(name.data()));
+    }
+    if (value.kind == FlatKvTable::Kind::Null) {
         return std::nullopt;
     }
-    return FromString<T>(env_var);
+
+    ParseProfiler::PhaseTimer timer(ParseProfiler::Phase::Convert);
+    if (value.kind != FlatKvTable::Kind::Text && value.kind != FlatKvTable::Kind::String) {
+        // typed values of tables built from other formats
+        return detail::flatkv_convert<T>(value);
+    }
+    return FromString<T>(std::string(value.text));
 }
 
 template <typename T>
@@ -22,11 +59,134 @@ void EnvFormat::Emit(dest_type* dest, const std::string& path, const T& value) c
     dest->emplace(std::make_pair(path, ToString<T>(value)));
 }
 
+template <typename StreamT>
+void EnvFormat::Write(const dest_type* dest, StreamT* stream) const
+{
+    for (const auto& [name, value] : *dest) {
+        if (name.find('\n') != std::string::npos || value.find('\n') != std::string::npos) {
+            throw std::runtime_error("variable '" + name + "' can not be written on a single line");
+        }
+        stream->Write(name);
+        stream->Write("=");
+        stream->Write(value);
+        stream->Write("\n");
+    }
+}
+
+std::optional<std::uint64_t> EnvFormat::SubtreeHash(const source_type* source, const std::string& path) const
+{
+    // order of the variables is unspecified, so their hashes are summed
+    std::uint64_t variables = 0;
+    ForEachVariable(source, path, [&variables](std::string_view name, const FlatKvTable::Scalar& value) {
+        const std::uint64_t hash = detail::fnv1a(name.data(), name.size());
+        variables += HashValue(value, detail::fnv1a("=", 1, hash));
+    });
+    return variables;
+}
+
+std::vector<std::string> EnvFormat::UnknownKeys(const source_type* source, const std::string& path,
+                                                const KeyTracker& tracker) const
+{
+    std::vector<std::string> keys;
+    ForEachVariable(source, path, [&keys, &tracker](std::string_view name, const FlatKvTable::Scalar&) {
+        if (!tracker.Consumed(reinterpret_cast<KeyTracker::node_key>(name.data()))) {
+            keys.emplace_back(name);
+        }
+    });
+    return keys;
+}
+
+std::shared_ptr<const FlatKvTable> EnvFormat::Capture(const source_type* source, const std::string& path) const
+{
+    auto captured = std::make_shared<FlatKvTable>();
+    ForEachVariable(source, path, [&captured](std::string_view name, const FlatKvTable::Scalar& value) {
+        captured->Add(name, value);
+    });
+    captured->Build();
+    return captured;
+}
+
+std::string EnvFormat::ReferencePath(const std::string& reference) const
+{
+    std::string name;
+    name.reserve(reference.size());
+    for (const char symbol : reference) {
+        name += symbol == '.' ? '_' : static_cast<char>(std::toupper(static_cast<unsigned char>(symbol)));
+    }
+    return name;
+}
+
 std::string EnvFormat::VectorElementPath(const std::string& vector_path, std::size_t index) const noexcept
 {
     return vector_path + "_" + std::to_string(index);
 }
 
+bool EnvFormat::InSection(std::string_view name, const std::string& path) noexcept
+{
+    return path.empty() || name == path ||
+           (name.size() > path.size() && name[path.size()] == '_' && name.compare(0, path.size(), path) == 0);
+}
+
+template <typename VisitorT>
+void EnvFormat::ForEachVariable(const source_type* source, const std::string& path, VisitorT&& visitor)
+{
+    if (source) {
+        // variables of the section share the prefix, so they are adjacent in the table
+        const auto [first, last] = source->Range(path);
+        for (std::size_t index = first; index < last; ++index) {
+            const std::string_view name = source->Key(index);
+            if (InSection(name, path)) {
+                visitor(name, source->Value(index));
+            }
+        }
+        return;
+    }
+
+    for (char** variable = environ; variable && *variable; ++variable) {
+        const std::string_view entry(*variable);
+        const std::size_t name_size = entry.find('=');
+        if (name_size != std::string_view::npos && InSection(entry.substr(0, name_size), path)) {
+            visitor(entry.substr(0, name_size), FlatKvTable::Scalar::MakeText(entry.substr(name_size + 1)));
+        }
+    }
+}
+
+const char* EnvFormat::ProcessVariable(const std::string& name) noexcept
+{
+    for (char** variable = environ; variable && *variable; ++variable) {
+        const std::string_view entry(*variable);
+        if (entry.size() > name.size() && entry[name.size()] == '=' && entry.compare(0, name.size(), name) == 0) {
+            return *variable;
+        }
+    }
+    return nullptr;
+}
+
+std::uint64_t EnvFormat::HashValue(const FlatKvTable::Scalar& value, std::uint64_t hash) noexcept
+{
+    std::uint64_t payload = 0;
+    switch (value.kind) {
+    case FlatKvTable::Kind::Bool:
+        payload = value.boolean ? 1 : 0;
+        break;
+    case FlatKvTable::Kind::Integer:
+        payload = static_cast<std::uint64_t>(value.integer);
+        break;
+    case FlatKvTable::Kind::Unsigned:
+        payload = value.unsigned_integer;
+        break;
+    case FlatKvTable::Kind::Double:
+        std::memcpy(&payload, &value.floating, sizeof(payload));
+        break;
+    default:
+        break;
+    }
+    // typed values have no text, so the kind and the payload are hashed as well
+    const auto kind = static_cast<char>(value.kind);
+    hash = detail::fnv1a_tagged(kind, value.text.data(), value.text.size(), hash);
+    return detail::fnv1a(&payload, sizeof(payload), hash);
+}
+
 template <typename T>
 std::optional<T> EnvFormat::FromString(const std::string& str)
 {
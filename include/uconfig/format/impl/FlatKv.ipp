@@ -0,0 +1,564 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <type_traits>
+
+#if !defined(_WIN32)
+extern "C" char** environ;
+#endif // !defined(_WIN32)
+
+namespace uconfig {
+namespace detail {
+
+/// Convert untyped text @p str into `T`.
+template <typename T>
+std::optional<T> flatkv_from_text(std::string_view str)
+{
+    if constexpr (std::is_same<T, bool>::value) {
+        if (str == "true") {
+            return true;
+        }
+        if (str == "false") {
+            return false;
+        }
+        return std::nullopt;
+    } else {
+        T result;
+        const char* end = str.data() + str.size();
+        auto [ptr, ec] = std::from_chars(str.data(), end, result);
+        if (ec != std::errc() || ptr != end) {
+            return std::nullopt;
+        }
+        return result;
+    }
+}
+
+/// Convert integer @p value into `T` if it fits.
+template <typename T, typename IntT>
+std::optional<T> flatkv_from_integer(IntT value)
+{
+    if constexpr (std::is_floating_point<T>::value) {
+        const T result = static_cast<T>(value);
+        // only exactly representable integers are converted, same as for rapidjson lossless checks
+        if (result != static_cast<T>(std::numeric_limits<IntT>::max()) && static_cast<IntT>(result) == value) {
+            return result;
+        }
+        return std::nullopt;
+    } else {
+        if constexpr (std::is_signed<IntT>::value) {
+            if (value < 0 && (!std::is_signed<T>::value || value < static_cast<IntT>(std::numeric_limits<T>::min()))) {
+                return std::nullopt;
+            }
+        }
+        const auto max = static_cast<std::uint64_t>(std::numeric_limits<T>::max());
+        if (value > 0 && static_cast<std::uint64_t>(value) > max) {
+            return std::nullopt;
+        }
+        return static_cast<T>(value);
+    }
+}
+
+/// Convert typed @p value into `T`.
+template <typename T>
+std::optional<T> flatkv_convert(const FlatKvTable::Scalar& value)
+{
+    using Kind = FlatKvTable::Kind;
+
+    if constexpr (std::is_same<T, std::string>::value) {
+        if (value.kind == Kind::Text || value.kind == Kind::String) {
+            return std::string(value.text);
+        }
+        return std::nullopt;
+    } else if constexpr (std::is_same<T, bool>::value) {
+        if (value.kind == Kind::Text) {
+            return flatkv_from_text<T>(value.text);
+        }
+        if (value.kind == Kind::Bool) {
+            return value.boolean;
+        }
+        return std::nullopt;
+    } else if constexpr (std::is_arithmetic<T>::value) {
+        switch (value.kind) {
+        case Kind::Text:
+            return flatkv_from_text<T>(value.text);
+        case Kind::Integer:
+            return flatkv_from_integer<T>(value.integer);
+        case Kind::Unsigned:
+            return flatkv_from_integer<T>(value.unsigned_integer);
+        case Kind::Double:
+            if constexpr (std::is_floating_point<T>::value) {
+                const T result = static_cast<T>(value.floating);
+                if (static_cast<double>(result) == value.floating) {
+                    return result;
+                }
+            }
+            return std::nullopt;
+        default:
+            return std::nullopt;
+        }
+    } else {
+        static_assert(std::is_same<T, void>::value, "type is not supported by FlatKvFormat, provide specialization");
+    }
+}
+
+} // namespace detail
+
+inline FlatKvFormat::FlatKvFormat(std::string vector_delimiter)
+    : vector_delimiter_(std::move(vector_delimiter))
+{}
+
+template <typename T>
+std::optional<T> FlatKvFormat::Parse(const source_type* source, const std::string& path) const
+{
+    std::optional<FlatKvTable::Scalar> value = source->Find(path);
+    if (!value) {
+        return std::nullopt;
+    }
+
+    ParseProfiler::PhaseTimer timer(ParseProfiler::Phase::Convert);
+    return detail::flatkv_convert<T>(*value);
+}
+
+template <typename T>
+void FlatKvFormat::Emit(dest_type* dest, const std::string& path, const T& value) const
+{
+    using Scalar = FlatKvTable::Scalar;
+
+    if constexpr (std::is_same<T, std::string>::value) {
+        dest->Add(path, Scalar::MakeString(value));
+    } else if constexpr (std::is_same<T, bool>::value) {
+        dest->Add(path, Scalar::MakeBool(value));
+    } else if constexpr (std::is_floating_point<T>::value) {
+        dest->Add(path, Scalar::MakeDouble(value));
+    } else if constexpr (std::is_integral<T>::value && std::is_signed<T>::value) {
+        dest->Add(path, Scalar::MakeInteger(value));
+    } else if constexpr (std::is_integral<T>::value) {
+        dest->Add(path, Scalar::MakeUnsigned(value));
+    } else {
+        static_assert(std::is_same<T, void>::value, "type is not supported by FlatKvFormat, provide specialization");
+    }
+}
+
+std::string FlatKvFormat::VectorElementPath(const std::string& vector_path, std::size_t index) const noexcept
+{
+    return vector_path + vector_delimiter_ + std::to_string(index);
+}
+
+inline FlatKvTable::Scalar FlatKvTable::Scalar::MakeNull() noexcept
+{
+    return Scalar{};
+}
+
+inline FlatKvTable::Scalar FlatKvTable::Scalar::MakeText(std::string_view value) noexcept
+{
+    Scalar result;
+    result.kind = Kind::Text;
+    result.text = value;
+    return result;
+}
+
+inline FlatKvTable::Scalar FlatKvTable::Scalar::MakeString(std::string_view value) noexcept
+{
+    Scalar result;
+    result.kind = Kind::String;
+    result.text = value;
+    return result;
+}
+
+inline FlatKvTable::Scalar FlatKvTable::Scalar::MakeBool(bool value) noexcept
+{
+    Scalar result;
+    result.kind = Kind::Bool;
+    result.boolean = value;
+    return result;
+}
+
+inline FlatKvTable::Scalar FlatKvTable::Scalar::MakeInteger(std::int64_t value) noexcept
+{
+    Scalar result;
+    result.kind = Kind::Integer;
+    result.integer = value;
+    return result;
+}
+
+inline FlatKvTable::Scalar FlatKvTable::Scalar::MakeUnsigned(std::uint64_t value) noexcept
+{
+    // keep single representation for the values fitting into both
+    if (value <= static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max())) {
+        return MakeInteger(static_cast<std::int64_t>(value));
+    }
+
+    Scalar result;
+    result.kind = Kind::Unsigned;
+    result.unsigned_integer = value;
+    return result;
+}
+
+inline FlatKvTable::Scalar FlatKvTable::Scalar::MakeDouble(double value) noexcept
+{
+    Scalar result;
+    result.kind = Kind::Double;
+    result.floating = value;
+    return result;
+}
+
+inline FlatKvTable FlatKvTable::FromEnv(const char* const* envp)
+{
+    FlatKvTable table;
+    for (; envp && *envp; ++envp) {
+        const std::string_view variable = *envp;
+        const std::size_t delimiter = variable.find('=');
+        if (delimiter == std::string_view::npos) {
+            continue;
+        }
+        table.Add(variable.substr(0, delimiter), Scalar::MakeText(variable.substr(delimiter + 1)));
+    }
+    table.Build();
+    return table;
+}
+
+inline FlatKvTable FlatKvTable::FromEnv()
+{
+#if !defined(_WIN32)
+    return FromEnv(::environ);
+#else
+    return FromEnv(_environ);
+#endif // !defined(_WIN32)
+}
+
+inline FlatKvTable FlatKvTable::FromEnv(const std::map<std::string, std::string>& variables)
+{
+    FlatKvTable table;
+    for (const auto& [name, value] : variables) {
+        table.Add(name, Scalar::MakeText(value));
+    }
+    table.Build();
+    return table;
+}
+
+inline FlatKvTable FlatKvTable::FromEnvBlock(std::string_view block)
+{
+    FlatKvTable table;
+    while (!block.empty()) {
+        const std::size_t variable_end = block.find('\0');
+        const std::string_view variable = block.substr(0, variable_end);
+        block.remove_prefix(variable_end == std::string_view::npos ? block.size() : variable_end + 1);
+
+        const std::size_t delimiter = variable.find('=');
+        if (delimiter == std::string_view::npos) {
+            continue;
+        }
+        table.Add(variable.substr(0, delimiter), Scalar::MakeText(variable.substr(delimiter + 1)));
+    }
+    table.Build();
+    return table;
+}
+
+inline FlatKvTable FlatKvTable::FromLines(std::string_view contents)
+{
+    static constexpr std::string_view whitespaces = " \t";
+
+    FlatKvTable table;
+    std::size_t line_number = 0;
+    while (!contents.empty()) {
+        ++line_number;
+        const std::size_t line_end = contents.find('\n');
+        std::string_view line = contents.substr(0, line_end);
+        contents.remove_prefix(line_end == std::string_view::npos ? contents.size() : line_end + 1);
+
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        const std::size_t line_start = line.find_first_not_of(whitespaces);
+        if (line_start == std::string_view::npos || line[line_start] == '#') {
+            continue;
+        }
+
+        const std::size_t delimiter = line.find('=');
+        const std::size_t key_size = delimiter == std::string_view::npos ? 0 : delimiter - line_start;
+        std::string_view key = line.substr(line_start, key_size);
+        key = key.substr(0, key.find_last_not_of(whitespaces) + 1);
+        if (key.empty()) {
+            throw ParseError(FlatKvFormat::name + " line " + std::to_string(line_number) +
+                             " is not valid: expected 'key=value'");
+        }
+        table.Add(key, Scalar::MakeText(line.substr(delimiter + 1)));
+    }
+    table.Build();
+    return table;
+}
+
+inline FlatKvTable FlatKvTable::FromFile(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw ParseError(FlatKvFormat::name + " '" + path + "' failed to be read: " + std::strerror(errno));
+    }
+
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    try {
+        return FromLines(contents.str());
+    } catch (const ParseError& ex) {
+        throw ParseError(std::string(ex.what()) + " in '" + path + "'");
+    }
+}
+
+template <typename JsonValueT>
+FlatKvTable FlatKvTable::FromJson(const JsonValueT& json)
+{
+    FlatKvTable table;
+    std::string path;
+    table.AddJson(json, path);
+    table.Build();
+    return table;
+}
+
+template <typename JsonValueT>
+void FlatKvTable::AddJson(const JsonValueT& json, std::string& path)
+{
+    const std::size_t path_size = path.size();
+    if (json.IsObject()) {
+        for (auto member_it = json.MemberBegin(); member_it != json.MemberEnd(); ++member_it) {
+            // escape the name as JSON-pointer token
+            path += '/';
+            const std::string_view member_name(member_it->name.GetString(), member_it->name.GetStringLength());
+            for (char symbol : member_name) {
+                if (symbol == '~') {
+                    path += "~0";
+                } else if (symbol == '/') {
+                    path += "~1";
+                } else {
+                    path += symbol;
+                }
+            }
+            AddJson(member_it->value, path);
+            path.resize(path_size);
+        }
+    } else if (json.IsArray()) {
+        for (decltype(json.Size()) index = 0; index < json.Size(); ++index) {
+            path += '/';
+            path += std::to_string(index);
+            AddJson(json[index], path);
+            path.resize(path_size);
+        }
+    } else if (json.IsString()) {
+        Add(path, Scalar::MakeString(std::string_view(json.GetString(), json.GetStringLength())));
+    } else if (json.IsBool()) {
+        Add(path, Scalar::MakeBool(json.GetBool()));
+    } else if (json.IsInt64()) {
+        Add(path, Scalar::MakeInteger(json.GetInt64()));
+    } else if (json.IsUint64()) {
+        Add(path, Scalar::MakeUnsigned(json.GetUint64()));
+    } else if (json.IsNumber()) {
+        Add(path, Scalar::MakeDouble(json.GetDouble()));
+    } else {
+        Add(path, Scalar::MakeNull());
+    }
+}
+
+inline void FlatKvTable::Add(std::string_view key, const Scalar& value)
+{
+    if (image_entries_) {
+        // copy out of the image before modification
+        storage_.assign(image_storage_.data(), image_storage_.size());
+        entries_.assign(image_entries_, image_entries_ + built_);
+        image_entries_ = nullptr;
+        image_storage_ = {};
+    }
+
+    Entry entry;
+    entry.key_offset = storage_.size();
+    entry.key_size = key.size();
+    storage_.append(key);
+    entry.text_offset = storage_.size();
+    entry.text_size = value.text.size();
+    storage_.append(value.text);
+    entry.kind = static_cast<std::uint64_t>(value.kind);
+    switch (value.kind) {
+    case Kind::Bool:
+        entry.payload = value.boolean ? 1 : 0;
+        break;
+    case Kind::Integer:
+        entry.payload = static_cast<std::uint64_t>(value.integer);
+        break;
+    case Kind::Unsigned:
+        entry.payload = value.unsigned_integer;
+        break;
+    case Kind::Double:
+        std::memcpy(&entry.payload, &value.floating, sizeof(entry.payload));
+        break;
+    default:
+        break;
+    }
+    entries_.emplace_back(entry);
+}
+
+inline void FlatKvTable::Build()
+{
+    if (image_entries_ || built_ == entries_.size()) {
+        return;
+    }
+
+    // stable sort keeps entries with the same key in order of addition, so the latest one is kept
+    std::stable_sort(entries_.begin(), entries_.end(),
+                     [this](const Entry& lhs, const Entry& rhs) { return KeyOf(lhs) < KeyOf(rhs); });
+    auto unique_end = entries_.begin();
+    for (auto entry_it = entries_.begin(); entry_it != entries_.end(); ++entry_it) {
+        auto next_it = std::next(entry_it);
+        if (next_it != entries_.end() && KeyOf(*next_it) == KeyOf(*entry_it)) {
+            continue;
+        }
+        *unique_end++ = *entry_it;
+    }
+    entries_.erase(unique_end, entries_.end());
+    built_ = entries_.size();
+}
+
+inline std::optional<FlatKvTable::Scalar> FlatKvTable::Find(std::string_view key) const noexcept
+{
+    if (const std::optional<std::size_t> index = Index(key)) {
+        return Value(*index);
+    }
+    return std::nullopt;
+}
+
+inline std::optional<std::size_t> FlatKvTable::Index(std::string_view key) const noexcept
+{
+    const Entry* built_begin = Entries();
+    const Entry* built_end = built_begin + built_;
+    const Entry* entry_it = std::lower_bound(built_begin, built_end, key,
+                                             [this](const Entry& entry, std::string_view target) {
+                                                 return KeyOf(entry) < target;
+                                             });
+    if (entry_it == built_end || KeyOf(*entry_it) != key) {
+        return std::nullopt;
+    }
+    return entry_it - built_begin;
+}
+
+inline std::pair<std::size_t, std::size_t> FlatKvTable::Range(std::string_view prefix) const noexcept
+{
+    const Entry* built_begin = Entries();
+    const Entry* built_end = built_begin + built_;
+    const Entry* first_it = std::lower_bound(built_begin, built_end, prefix,
+                                             [this](const Entry& entry, std::string_view target) {
+                                                 return KeyOf(entry) < target;
+                                             });
+    // keys with the same prefix are adjacent in sorted order
+    const Entry* last_it = std::partition_point(first_it, built_end, [this, prefix](const Entry& entry) {
+        return KeyOf(entry).substr(0, prefix.size()) == prefix;
+    });
+    return {first_it - built_begin, last_it - built_begin};
+}
+
+inline std::string_view FlatKvTable::Key(std::size_t index) const noexcept
+{
+    return KeyOf(Entries()[index]);
+}
+
+inline FlatKvTable::Scalar FlatKvTable::Value(std::size_t index) const noexcept
+{
+    const Entry& entry = Entries()[index];
+
+    Scalar result;
+    result.kind = static_cast<Kind>(entry.kind);
+    result.text = Slice(entry.text_offset, entry.text_size);
+    switch (result.kind) {
+    case Kind::Bool:
+        result.boolean = entry.payload != 0;
+        break;
+    case Kind::Integer:
+        result.integer = static_cast<std::int64_t>(entry.payload);
+        break;
+    case Kind::Unsigned:
+        result.unsigned_integer = entry.payload;
+        break;
+    case Kind::Double:
+        std::memcpy(&result.floating, &entry.payload, sizeof(result.floating));
+        break;
+    default:
+        break;
+    }
+    return result;
+}
+
+inline std::size_t FlatKvTable::Size() const noexcept
+{
+    return built_;
+}
+
+inline std::size_t FlatKvTable::ImageSize() const noexcept
+{
+    const std::size_t storage_size = image_entries_ ? image_storage_.size() : storage_.size();
+    return sizeof(ImageHeader) + built_ * sizeof(Entry) + storage_size;
+}
+
+inline void FlatKvTable::WriteImage(void* dest) const noexcept
+{
+    const std::string_view storage = image_entries_ ? image_storage_ : std::string_view(storage_);
+
+    ImageHeader header;
+    header.magic = kImageMagic;
+    header.entries_size = built_;
+    header.storage_size = storage.size();
+
+    auto* dest_bytes = static_cast<char*>(dest);
+    std::memcpy(dest_bytes, &header, sizeof(header));
+    dest_bytes += sizeof(header);
+    std::memcpy(dest_bytes, Entries(), built_ * sizeof(Entry));
+    dest_bytes += built_ * sizeof(Entry);
+    std::memcpy(dest_bytes, storage.data(), storage.size());
+}
+
+inline FlatKvTable FlatKvTable::FromImage(const void* image, std::size_t size)
+{
+    static_assert(std::is_trivially_copyable<Entry>::value, "image entry should be trivially copyable");
+
+    ImageHeader header;
+    if (!image || reinterpret_cast<std::uintptr_t>(image) % alignof(Entry) != 0 || size < sizeof(header)) {
+        throw ParseError(FlatKvFormat::name + " image is not valid: bad image memory");
+    }
+    std::memcpy(&header, image, sizeof(header));
+
+    const std::size_t entries_capacity = (size - sizeof(header)) / sizeof(Entry);
+    if (header.magic != kImageMagic || header.entries_size > entries_capacity ||
+        header.storage_size > size - sizeof(header) - header.entries_size * sizeof(Entry)) {
+        throw ParseError(FlatKvFormat::name + " image is not valid: bad image header");
+    }
+
+    const auto* image_bytes = static_cast<const char*>(image);
+    FlatKvTable table;
+    table.built_ = header.entries_size;
+    table.image_entries_ = reinterpret_cast<const Entry*>(image_bytes + sizeof(header));
+    table.image_storage_ = std::string_view(image_bytes + sizeof(header) + header.entries_size * sizeof(Entry),
+                                            header.storage_size);
+    return table;
+}
+
+inline const FlatKvTable::Entry* FlatKvTable::Entries() const noexcept
+{
+    return image_entries_ ? image_entries_ : entries_.data();
+}
+
+inline std::string_view FlatKvTable::Slice(std::uint64_t offset, std::uint64_t size) const noexcept
+{
+    const std::string_view storage = image_entries_ ? image_storage_ : std::string_view(storage_);
+    if (offset > storage.size()) {
+        return {};
+    }
+    return storage.substr(offset, size);
+}
+
+inline std::string_view FlatKvTable::KeyOf(const Entry& entry) const noexcept
+{
+    return Slice(entry.key_offset, entry.key_size);
+}
+
+} // namespace uconfig
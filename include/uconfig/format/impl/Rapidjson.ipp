@@ -2,6 +2,12 @@
 
 namespace uconfig {
 
+template <typename AllocatorT>
+RapidjsonFormat<AllocatorT>::RapidjsonFormat(std::size_t index_threshold)
+    : index_threshold_(index_threshold)
+{
+}
+
 template <typename AllocatorT>
 template <typename T>
 std::optional<T> RapidjsonFormat<AllocatorT>::Parse(const json_value_type* source, const std::string& path) const
@@ -10,7 +16,11 @@ std::optional<T> RapidjsonFormat<AllocatorT>::Parse(const json_value_type* sourc
     if (!target) {
         return std::nullopt;
     }
+    if (KeyTracker* tracker = KeyTracker::Current()) {
+        tracker->Consume(reinterpret_cast<KeyTracker::node_key>(target));
+    }
 
+    ParseProfiler::PhaseTimer timer(ParseProfiler::Phase::Convert);
     T result;
     if (!this->Convert<T>(*target, result)) {
         return std::nullopt;
@@ -25,6 +35,133 @@ void RapidjsonFormat<AllocatorT>::Emit(dest_type* dest, const std::string& path,
     Set(MakeJson(value, dest->GetAllocator()), path, dest);
 }
 
+template <typename AllocatorT>
+template <typename StreamT>
+void RapidjsonFormat<AllocatorT>::Write(const dest_type* dest, StreamT* stream) const
+{
+    rapidjson::Writer<StreamT> writer(*stream);
+    dest->Accept(writer);
+    stream->Flush();
+}
+
+template <typename AllocatorT>
+void RapidjsonFormat<AllocatorT>::EmitPatch(const std::vector<Change>& changes, const dest_type* after,
+                                            dest_type* patch) const
+{
+    auto& alloc = patch->GetAllocator();
+    patch->SetArray();
+    patch->Reserve(static_cast<rapidjson::SizeType>(changes.size()), alloc);
+    for (const auto& change : changes) {
+        const char* op = "replace";
+        if (change.kind == Change::Kind::Added) {
+            op = "add";
+        } else if (change.kind == Change::Kind::Removed) {
+            op = "remove";
+        }
+        json_value_type operation(rapidjson::kObjectType);
+        operation.AddMember("op", json_value_type(op, alloc), alloc);
+        operation.AddMember("path", json_value_type(change.path, alloc), alloc);
+
+        if (change.kind != Change::Kind::Removed) {
+            // plain lookup, indexes are kept for the parsed sources only
+            const json_value_type* value = json_pointer_type(change.path).Get(*after);
+            if (!value) {
+                throw EmitError(name + " config '" + change.path + "' is not valid: value is not emitted");
+            }
+            operation.AddMember("value", json_value_type(*value, alloc), alloc);
+        }
+        patch->PushBack(std::move(operation), alloc);
+    }
+}
+
+template <typename AllocatorT>
+std::optional<std::size_t> RapidjsonFormat<AllocatorT>::VectorSize(const json_value_type* source,
+                                                                   const std::string& path) const
+{
+    const auto* target = Get(source, path);
+    if (!target || !target->IsArray()) {
+        return std::nullopt;
+    }
+    return target->Size();
+}
+
+template <typename AllocatorT>
+std::optional<std::uint64_t> RapidjsonFormat<AllocatorT>::SubtreeHash(const json_value_type* source,
+                                                                      const std::string& path) const
+{
+    const auto* target = Get(source, path);
+    if (!target) {
+        return detail::kFnvSeed;
+    }
+    return Hash(*target, detail::kFnvSeed);
+}
+
+template <typename AllocatorT>
+std::optional<std::string_view> RapidjsonFormat<AllocatorT>::StringView(const json_value_type* source,
+                                                                        const std::string& path) const
+{
+    const auto* target = Get(source, path);
+    if (!target || !target->IsString()) {
+        return std::nullopt;
+    }
+    if (KeyTracker* tracker = KeyTracker::Current()) {
+        tracker->Consume(reinterpret_cast<KeyTracker::node_key>(target));
+    }
+    return std::string_view(target->GetString(), target->GetStringLength());
+}
+
+template <typename AllocatorT>
+std::vector<std::string> RapidjsonFormat<AllocatorT>::UnknownKeys(const json_value_type* source,
+                                                                  const std::string& path,
+                                                                  const KeyTracker& tracker) const
+{
+    std::vector<std::string> keys;
+    const auto* target = Get(source, path);
+    if (target) {
+        CollectUnknownKeys(*target, path, tracker, keys);
+    }
+    return keys;
+}
+
+template <typename AllocatorT>
+std::shared_ptr<const typename RapidjsonFormat<AllocatorT>::json_value_type>
+RapidjsonFormat<AllocatorT>::Capture(const json_value_type* source, const std::string& path) const
+{
+    auto captured = std::make_shared<json_doc_type>();
+    const json_value_type* target = source ? Get(source, path) : nullptr;
+    if (target) {
+        Set(json_value_type(*target, captured->GetAllocator()), path, captured.get());
+    }
+    return captured;
+}
+
+template <typename AllocatorT>
+std::string RapidjsonFormat<AllocatorT>::ReferencePath(const std::string& reference) const
+{
+    if (!reference.empty() && reference.front() == '/') {
+        return reference;
+    }
+
+    std::string path = "/";
+    for (const char symbol : reference) {
+        // names are escaped as JSON-pointer tokens
+        switch (symbol) {
+        case '.':
+            path += '/';
+            break;
+        case '~':
+            path += "~0";
+            break;
+        case '/':
+            path += "~1";
+            break;
+        default:
+            path += symbol;
+        }
+    }
+    return path;
+}
+
 template <typename AllocatorT>
 std::string RapidjsonFormat<AllocatorT>::VectorElementPath(const std::string& vector_path,
                                                            std::size_t index) const noexcept
@@ -34,9 +171,182 @@ std::string RapidjsonFormat<AllocatorT>::VectorElementPath(const std::string& ve
 
 template <typename AllocatorT>
 const typename RapidjsonFormat<AllocatorT>::json_value_type*
-RapidjsonFormat<AllocatorT>::Get(const json_value_type* source, const std::string& path)
+RapidjsonFormat<AllocatorT>::Get(const json_value_type* source, const std::string& path) const
 {
-    return json_pointer_type(path).Get(*source);
+    // same as json_pointer_type::Get(), but looks members of wide objects up in the index of the parse
+    const json_pointer_type pointer(path);
+    if (!pointer.IsValid()) {
+        return nullptr;
+    }
+
+    KeyTracker* tracker = KeyTracker::Current();
+    MemberIndex* member_index = FormatState<MemberIndex>::Current();
+    const json_value_type* value = source;
+    const auto* tokens = pointer.GetTokens();
+    for (std::size_t index = 0; index < pointer.GetTokenCount(); ++index) {
+        const auto& token = tokens[index];
+        if (value->IsObject()) {
+            const std::string_view name(token.name, token.length);
+            value = member_index ? member_index->Find(*value, name) : FindMember(*value, name);
+            if (!value) {
+                return nullptr;
+            }
+        } else if (value->IsArray()) {
+            if (token.index == rapidjson::kPointerInvalidIndex || token.index >= value->Size()) {
+                return nullptr;
+            }
+            value = &(*value)[token.index];
+        } else {
+            return nullptr;
+        }
+        if (tracker) {
+            tracker->Visit(reinterpret_cast<KeyTracker::node_key>(value));
+        }
+    }
+    return value;
+}
+
+template <typename AllocatorT>
+void RapidjsonFormat<AllocatorT>::CollectUnknownKeys(const json_value_type& value, const std::string& path,
+                                                     const KeyTracker& tracker, std::vector<std::string>& keys)
+{
+    if (tracker.Consumed(reinterpret_cast<KeyTracker::node_key>(&value))) {
+        return;
+    }
+
+    const auto collect = [&](const json_value_type& child, const std::string& child_path) {
+        if (tracker.Visited(reinterpret_cast<KeyTracker::node_key>(&child))) {
+            CollectUnknownKeys(child, child_path, tracker, keys);
+        } else {
+            keys.push_back(child_path);
+        }
+    };
+
+    if (value.IsObject()) {
+        for (auto member = value.MemberBegin(); member != value.MemberEnd(); ++member) {
+            // name is escaped as a JSON-pointer token
+            std::string child_path = path + "/";
+            for (const char c : std::string_view(member->name.GetString(), member->name.GetStringLength())) {
+                if (c == '~') {
+                    child_path += "~0";
+                } else if (c == '/') {
+                    child_path += "~1";
+                } else {
+                    child_path += c;
+                }
+            }
+            collect(member->value, child_path);
+        }
+    } else if (value.IsArray()) {
+        for (rapidjson::SizeType index = 0; index < value.Size(); ++index) {
+            collect(value[index], path + "/" + std::to_string(index));
+        }
+    }
+}
+
+template <typename AllocatorT>
+const typename RapidjsonFormat<AllocatorT>::json_value_type*
+RapidjsonFormat<AllocatorT>::FindMember(const json_value_type& object, std::string_view name) noexcept
+{
+    for (auto member = object.MemberBegin(); member != object.MemberEnd(); ++member) {
+        if (name == std::string_view(member->name.GetString(), member->name.GetStringLength())) {
+            return &member->value;
+        }
+    }
+    return nullptr;
+}
+
+template <typename AllocatorT>
+RapidjsonFormat<AllocatorT>::MemberIndex::MemberIndex(const RapidjsonFormat& format) noexcept
+    : threshold_(format.index_threshold_)
+{
+}
+
+template <typename AllocatorT>
+const typename RapidjsonFormat<AllocatorT>::json_value_type*
+RapidjsonFormat<AllocatorT>::MemberIndex::Find(const json_value_type& object, std::string_view name)
+{
+    // source is not modified during the parse, so objects are indexed once
+    if (object.MemberCount() < threshold_) {
+        return FindMember(object, name);
+    }
+
+    const auto find = [&](const std::unordered_map<std::string_view, std::size_t>& positions)
+        -> const json_value_type* {
+        const auto position = positions.find(name);
+        if (position == positions.end()) {
+            return nullptr;
+        }
+        return &(object.MemberBegin() + position->second)->value;
+    };
+
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        const auto it = objects_.find(&object);
+        if (it != objects_.end()) {
+            return find(it->second);
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto [it, inserted] = objects_.try_emplace(&object);
+    if (inserted) {
+        it->second.reserve(object.MemberCount());
+        std::size_t position = 0;
+        for (auto member = object.MemberBegin(); member != object.MemberEnd(); ++member, ++position) {
+            // the first of duplicate members is found, same as by a linear scan
+            it->second.emplace(std::string_view(member->name.GetString(), member->name.GetStringLength()),
+                               position);
+        }
+    }
+    return find(it->second);
+}
+
+template <typename AllocatorT>
+std::size_t RapidjsonFormat<AllocatorT>::MemberIndex::Size() const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return objects_.size();
+}
+
+template <typename AllocatorT>
+std::uint64_t RapidjsonFormat<AllocatorT>::Hash(const json_value_type& value, std::uint64_t hash) noexcept
+{
+    const char type = static_cast<char>(value.GetType());
+    if (value.IsString()) {
+        return detail::fnv1a_tagged(type, value.GetString(), value.GetStringLength(), hash);
+    }
+    if (value.IsNumber()) {
+        // integers are hashed exactly, same value may be stored as a different type though
+        if (value.IsInt64()) {
+            const std::int64_t number = value.GetInt64();
+            return detail::fnv1a_tagged('i', &number, sizeof(number), hash);
+        }
+        if (value.IsUint64()) {
+            const std::uint64_t number = value.GetUint64();
+            return detail::fnv1a_tagged('u', &number, sizeof(number), hash);
+        }
+        const double number = value.GetDouble();
+        return detail::fnv1a_tagged('d', &number, sizeof(number), hash);
+    }
+    if (value.IsObject()) {
+        const std::size_t size = value.MemberCount();
+        hash = detail::fnv1a(&size, sizeof(size), detail::fnv1a(&type, 1, hash));
+        for (auto member = value.MemberBegin(); member != value.MemberEnd(); ++member) {
+            hash = Hash(member->name, hash);
+            hash = Hash(member->value, hash);
+        }
+        return hash;
+    }
+    if (value.IsArray()) {
+        const std::size_t size = value.Size();
+        hash = detail::fnv1a(&size, sizeof(size), detail::fnv1a(&type, 1, hash));
+        for (auto element = value.Begin(); element != value.End(); ++element) {
+            hash = Hash(*element, hash);
+        }
+        return hash;
+    }
+    return detail::fnv1a(&type, 1, hash);
 }
 
 template <typename AllocatorT>
@@ -0,0 +1,1070 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <limits>
+#include <type_traits>
+
+namespace uconfig {
+
+template <typename T>
+std::optional<T> YamlFormat::Parse(const source_type* source, const std::string& path) const
+{
+    KeyTracker* tracker = KeyTracker::Current();
+    const YamlDocument::node_id node = source->Find(path, tracker);
+    if (node == YamlDocument::npos || source->Type(node) != YamlDocument::NodeType::Scalar) {
+        return std::nullopt;
+    }
+    if (tracker) {
+        tracker->Consume(node);
+    }
+
+    ParseProfiler::PhaseTimer timer(ParseProfiler::Phase::Convert);
+    return FromScalar<T>(source->Scalar(node), source->Quoted(node));
+}
+
+template <typename T>
+void YamlFormat::Emit(dest_type* dest, const std::string& path, const T& value) const
+{
+    dest->Set(path, ToScalar<T>(value), std::is_same<T, std::string>::value);
+}
+
+std::optional<std::size_t> YamlFormat::VectorSize(const source_type* source, const std::string& path) const
+{
+    const YamlDocument::node_id id = source->Find(path, KeyTracker::Current());
+    if (id == YamlDocument::npos || source->Type(id) != YamlDocument::NodeType::Sequence) {
+        return std::nullopt;
+    }
+    return source->Size(id);
+}
+
+std::optional<std::uint64_t> YamlFormat::SubtreeHash(const source_type* source, const std::string& path) const
+{
+    const YamlDocument::node_id id = source->Find(path);
+    if (id == YamlDocument::npos) {
+        return detail::kFnvSeed;
+    }
+    return source->Hash(id);
+}
+
+std::optional<std::string_view> YamlFormat::StringView(const source_type* source, const std::string& path) const
+{
+    KeyTracker* tracker = KeyTracker::Current();
+    const YamlDocument::node_id id = source->Find(path, tracker);
+    if (id == YamlDocument::npos || source->Type(id) != YamlDocument::NodeType::Scalar) {
+        return std::nullopt;
+    }
+    if (tracker) {
+        tracker->Consume(id);
+    }
+    return source->Scalar(id);
+}
+
+std::vector<std::string> YamlFormat::UnknownKeys(const source_type* source, const std::string& path,
+                                                 const KeyTracker& tracker) const
+{
+    std::vector<std::string> keys;
+    const YamlDocument::node_id id = source->Find(path);
+    if (id != YamlDocument::npos) {
+        detail::yaml_collect_unknown_keys(*source, id, path, tracker, keys);
+    }
+    return keys;
+}
+
+std::string YamlFormat::VectorElementPath(const std::string& vector_path, std::size_t index) const noexcept
+{
+    return vector_path + "/" + std::to_string(index);
+}
+
+template <typename T>
+std::optional<T> YamlFormat::FromScalar(std::string_view text, bool quoted)
+{
+    if constexpr (std::is_same<T, std::string>::value) {
+        return std::string(text);
+    } else if constexpr (std::is_same<T, bool>::value) {
+        if (quoted) {
+            return std::nullopt;
+        }
+        if (text == "true" || text == "True" || text == "TRUE") {
+            return true;
+        }
+        if (text == "false" || text == "False" || text == "FALSE") {
+            return false;
+        }
+        return std::nullopt;
+    } else if constexpr (std::is_arithmetic<T>::value) {
+        if (quoted) {
+            return std::nullopt;
+        }
+
+        T result;
+        const char* end = text.data() + text.size();
+        auto [ptr, ec] = std::from_chars(text.data(), end, result);
+        if (ec != std::errc() || ptr != end) {
+            return std::nullopt;
+        }
+        return result;
+    } else {
+        static_assert(std::is_same<T, void>::value, "type is not supported by YamlFormat, provide specialization");
+    }
+}
+
+template <typename T>
+std::string YamlFormat::ToScalar(const T& value)
+{
+    if constexpr (std::is_same<T, std::string>::value) {
+        return value;
+    } else if constexpr (std::is_same<T, bool>::value) {
+        return value ? "true" : "false";
+    } else if constexpr (std::is_arithmetic<T>::value) {
+        char buffer[64];
+        auto [ptr, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        if (ec != std::errc()) {
+            throw std::runtime_error("failed to print value");
+        }
+        return std::string(buffer, ptr);
+    } else {
+        static_assert(std::is_same<T, void>::value, "type is not supported by YamlFormat, provide specialization");
+    }
+}
+
+namespace detail {
+
+/// Check if @p content is a block sequence entry.
+inline bool yaml_is_sequence_entry(std::string_view content) noexcept
+{
+    return !content.empty() && content[0] == '-' && (content.size() == 1 || content[1] == ' ');
+}
+
+/// Strip trailing spaces from @p text.
+inline std::string_view yaml_rtrim(std::string_view text) noexcept
+{
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t')) {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+/// Strip leading and trailing spaces from @p text.
+inline std::string_view yaml_trim(std::string_view text) noexcept
+{
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) {
+        text.remove_prefix(1);
+    }
+    return yaml_rtrim(text);
+}
+
+/// Find the end of the quoted scalar starting at @p pos or npos if it is not closed.
+inline std::size_t yaml_quoted_end(std::string_view text, std::size_t pos) noexcept
+{
+    const char quote = text[pos];
+    for (std::size_t i = pos + 1; i < text.size(); ++i) {
+        if (quote == '"' && text[i] == '\\') {
+            ++i;
+        } else if (text[i] == quote) {
+            if (quote == '\'' && i + 1 < text.size() && text[i + 1] == '\'') {
+                ++i;
+                continue;
+            }
+            return i;
+        }
+    }
+    return std::string_view::npos;
+}
+
+/// Cut the comment off the @p content.
+inline std::string_view yaml_strip_comment(std::string_view content) noexcept
+{
+    for (std::size_t i = 0; i < content.size(); ++i) {
+        const bool token_start = i == 0 || content[i - 1] == ' ' || content[i - 1] == '\t';
+        if ((content[i] == '"' || content[i] == '\'') && token_start) {
+            const std::size_t end = yaml_quoted_end(content, i);
+            if (end == std::string_view::npos) {
+                return content;
+            }
+            i = end;
+        } else if (content[i] == '#' && token_start) {
+            return content.substr(0, i);
+        }
+    }
+    return content;
+}
+
+/// Find the ':' separating key and value in the mapping entry or npos if @p content is not an entry.
+inline std::size_t yaml_mapping_colon(std::string_view content) noexcept
+{
+    std::size_t i = 0;
+    if (!content.empty() && (content[0] == '"' || content[0] == '\'')) {
+        i = yaml_quoted_end(content, 0);
+        if (i == std::string_view::npos) {
+            return std::string_view::npos;
+        }
+    }
+    for (; i < content.size(); ++i) {
+        if (content[i] == ':' && (i + 1 == content.size() || content[i + 1] == ' ')) {
+            return i;
+        }
+    }
+    return std::string_view::npos;
+}
+
+/// Check if @p token is a valid sequence index and get it.
+inline bool yaml_index(std::string_view token, std::size_t* index) noexcept
+{
+    if (token.empty() || (token.size() > 1 && token[0] == '0')) {
+        return false;
+    }
+    auto [ptr, ec] = std::from_chars(token.data(), token.data() + token.size(), *index);
+    return ec == std::errc() && ptr == token.data() + token.size();
+}
+
+/// Unescape JSON-pointer @p token ("~1" -> "/", "~0" -> "~").
+inline std::string yaml_unescape_token(std::string_view token)
+{
+    std::string result;
+    result.reserve(token.size());
+    for (std::size_t i = 0; i < token.size(); ++i) {
+        if (token[i] == '~' && i + 1 < token.size() && (token[i + 1] == '0' || token[i + 1] == '1')) {
+            result += token[i + 1] == '0' ? '~' : '/';
+            ++i;
+        } else {
+            result += token[i];
+        }
+    }
+    return result;
+}
+
+/// Append UTF-8 encoded @p code_point to @p out.
+inline void yaml_append_utf8(std::string& out, std::uint32_t code_point)
+{
+    if (code_point < 0x80) {
+        out += static_cast<char>(code_point);
+    } else if (code_point < 0x800) {
+        out += static_cast<char>(0xC0 | (code_point >> 6));
+        out += static_cast<char>(0x80 | (code_point & 0x3F));
+    } else if (code_point < 0x10000) {
+        out += static_cast<char>(0xE0 | (code_point >> 12));
+        out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code_point & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (code_point >> 18));
+        out += static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code_point & 0x3F));
+    }
+}
+
+inline void yaml_collect_unknown_keys(const YamlDocument& source, YamlDocument::node_id id, const std::string& path,
+                                      const KeyTracker& tracker, std::vector<std::string>& keys)
+{
+    if (tracker.Consumed(id)) {
+        return;
+    }
+
+    const YamlDocument::NodeType type = source.Type(id);
+    for (std::size_t index = 0; index < source.Size(id); ++index) {
+        const YamlDocument::node_id child = source.Child(id, index);
+        std::string child_path = path + "/";
+        if (type == YamlDocument::NodeType::Mapping) {
+            // key is escaped as a JSON-pointer token
+            for (const char c : source.Key(child)) {
+                if (c == '~') {
+                    child_path += "~0";
+                } else if (c == '/') {
+                    child_path += "~1";
+                } else {
+                    child_path += c;
+                }
+            }
+        } else {
+            child_path += std::to_string(index);
+        }
+
+        if (tracker.Visited(child)) {
+            yaml_collect_unknown_keys(source, child, child_path, tracker, keys);
+        } else {
+            keys.push_back(std::move(child_path));
+        }
+    }
+}
+
+/// Check if plain @p text would be read back as something else than the same string.
+inline bool yaml_needs_quotes(std::string_view text) noexcept
+{
+    if (text.empty() || text.front() == ' ' || text.back() == ' ') {
+        return true;
+    }
+    if (std::string_view("-?:,[]{}#&*!|>'\"%@`~").find(text.front()) != std::string_view::npos) {
+        return true;
+    }
+    if (text == "null" || text == "Null" || text == "NULL" || text == "true" || text == "True" || text == "TRUE" ||
+        text == "false" || text == "False" || text == "FALSE") {
+        return true;
+    }
+    double number;
+    auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), number);
+    if (ec == std::errc() && ptr == text.data() + text.size()) {
+        return true;
+    }
+    for (std::size_t i = 0; i < text.size(); ++i) {
+        const auto c = static_cast<unsigned char>(text[i]);
+        if (c < 0x20 || c == 0x7F) {
+            return true;
+        }
+        if ((text[i] == ':' || text[i] == '#') && (i + 1 == text.size() || text[i + 1] == ' ' || text[i - 1] == ' ')) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace detail
+
+inline YamlDocument::YamlDocument()
+    : nodes_(1)
+{
+}
+
+inline YamlDocument::YamlDocument(std::string text)
+    : source_(std::move(text))
+    , nodes_(1)
+{
+    if (source_.size() >= std::numeric_limits<std::uint32_t>::max()) {
+        Fail(0, "document is too large");
+    }
+
+    ParseState state;
+    const std::string_view source = source_;
+    std::size_t pos = 0;
+    while (pos < source.size()) {
+        std::size_t eol = source.find('\n', pos);
+        if (eol == std::string_view::npos) {
+            eol = source.size();
+        }
+        std::string_view line = source.substr(pos, eol - pos);
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+
+        ++state.line_no;
+        ParseLine(state, line);
+        pos = eol + 1;
+    }
+    Reindex();
+}
+
+inline YamlDocument::node_id YamlDocument::Find(const std::string& path, KeyTracker* tracker) const
+{
+    if (path.empty()) {
+        return 0;
+    }
+    if (path[0] != '/') {
+        return npos;
+    }
+
+    const std::string_view path_view = path;
+    node_id node = 0;
+    std::size_t pos = 1;
+    while (node != npos) {
+        std::size_t end = path_view.find('/', pos);
+        if (end == std::string_view::npos) {
+            end = path_view.size();
+        }
+        const std::string_view token = path_view.substr(pos, end - pos);
+
+        switch (nodes_[node].type) {
+        case NodeType::Mapping:
+            if (token.find('~') == std::string_view::npos) {
+                node = Member(node, token);
+            } else {
+                node = Member(node, detail::yaml_unescape_token(token));
+            }
+            break;
+        case NodeType::Sequence: {
+            std::size_t index = 0;
+            node = detail::yaml_index(token, &index) ? Child(node, index) : npos;
+            break;
+        }
+        default:
+            return npos;
+        }
+        if (tracker && node != npos) {
+            tracker->Visit(node);
+        }
+
+        if (end == path_view.size()) {
+            return node;
+        }
+        pos = end + 1;
+    }
+    return npos;
+}
+
+inline YamlDocument::NodeType YamlDocument::Type(node_id id) const noexcept
+{
+    return nodes_[id].type;
+}
+
+inline std::string_view YamlDocument::Scalar(node_id id) const noexcept
+{
+    return View(nodes_[id].value);
+}
+
+inline bool YamlDocument::Quoted(node_id id) const noexcept
+{
+    return nodes_[id].quoted;
+}
+
+inline std::string_view YamlDocument::Key(node_id id) const noexcept
+{
+    return View(nodes_[id].key);
+}
+
+inline std::size_t YamlDocument::Size(node_id id) const noexcept
+{
+    return nodes_[id].size;
+}
+
+inline std::uint64_t YamlDocument::Hash(node_id id) const noexcept
+{
+    const Node& node = nodes_[id];
+    const std::size_t size = node.size;
+    std::uint64_t hash = detail::fnv1a(&node.type, sizeof(node.type));
+    hash = detail::fnv1a(&size, sizeof(size), hash);
+
+    switch (node.type) {
+    case NodeType::Null:
+        break;
+    case NodeType::Scalar: {
+        // same as for operator==, quotes matter only if the scalar would be read differently without them
+        const std::string_view text = View(node.value);
+        const char quoted = node.quoted && detail::yaml_needs_quotes(text) ? 'q' : 'p';
+        hash = detail::fnv1a_tagged(quoted, text.data(), text.size(), hash);
+        break;
+    }
+    case NodeType::Mapping: {
+        // members are unordered, so their hashes are summed
+        std::uint64_t members = 0;
+        for (node_id child = node.first_child; child != npos; child = nodes_[child].next_sibling) {
+            const std::string_view key = View(nodes_[child].key);
+            const std::uint64_t value_hash = Hash(child);
+            members += detail::fnv1a_tagged('k', key.data(), key.size(), value_hash);
+        }
+        hash = detail::fnv1a(&members, sizeof(members), hash);
+        break;
+    }
+    case NodeType::Sequence:
+        for (std::size_t index = 0; index < node.size; ++index) {
+            const std::uint64_t element_hash = Hash(Child(id, index));
+            hash = detail::fnv1a(&element_hash, sizeof(element_hash), hash);
+        }
+        break;
+    }
+    return hash;
+}
+
+inline void YamlDocument::Set(const std::string& path, std::string_view scalar, bool quoted)
+{
+    if (!path.empty() && path[0] != '/') {
+        throw std::runtime_error("path '" + path + "' is not a valid pointer");
+    }
+
+    indexed_ = false;
+    const std::string_view path_view = path;
+    node_id node = 0;
+    std::size_t pos = 1;
+    while (pos <= path_view.size()) {
+        std::size_t end = path_view.find('/', pos);
+        if (end == std::string_view::npos) {
+            end = path_view.size();
+        }
+        const std::string_view token = path_view.substr(pos, end - pos);
+
+        std::size_t index = 0;
+        const bool is_index = detail::yaml_index(token, &index);
+        if (nodes_[node].type != NodeType::Mapping && nodes_[node].type != NodeType::Sequence) {
+            // scalars on the way are replaced, same as JSON-pointer does
+            nodes_[node].type = is_index ? NodeType::Sequence : NodeType::Mapping;
+            nodes_[node].quoted = false;
+            nodes_[node].value = {};
+        }
+
+        if (nodes_[node].type == NodeType::Mapping) {
+            const std::string key = detail::yaml_unescape_token(token);
+            node_id member = Member(node, key);
+            if (member == npos) {
+                member = AddChild(node, Own(key));
+            }
+            node = member;
+        } else {
+            if (!is_index) {
+                throw std::runtime_error("path '" + path + "' does not point into a sequence");
+            }
+            while (nodes_[node].size <= index) {
+                AddChild(node, {});
+            }
+            node = Child(node, index);
+        }
+        pos = end + 1;
+    }
+
+    UnindexMembers(node);
+    Node& target = nodes_[node];
+    target.type = NodeType::Scalar;
+    target.quoted = quoted;
+    target.value = Own(scalar);
+    target.size = 0;
+    target.first_child = npos;
+    target.last_child = npos;
+}
+
+inline std::string YamlDocument::Dump() const
+{
+    std::string out;
+    const Node& root = nodes_[0];
+    if ((root.type == NodeType::Mapping || root.type == NodeType::Sequence) && root.size > 0) {
+        DumpBlock(out, 0, 0, false);
+    } else {
+        DumpScalar(out, View(root.value), root.quoted);
+        out += '\n';
+    }
+    return out;
+}
+
+inline bool YamlDocument::operator==(const YamlDocument& other) const noexcept
+{
+    return Equal(0, other, 0);
+}
+
+inline bool YamlDocument::operator!=(const YamlDocument& other) const noexcept
+{
+    return !(*this == other);
+}
+
+inline std::string_view YamlDocument::View(const Span& span) const noexcept
+{
+    return std::string_view(span.owned ? storage_ : source_).substr(span.offset, span.size);
+}
+
+inline YamlDocument::Span YamlDocument::Own(std::string_view text)
+{
+    Span span{static_cast<std::uint32_t>(storage_.size()), static_cast<std::uint32_t>(text.size()), true};
+    storage_.append(text);
+    return span;
+}
+
+inline YamlDocument::Span YamlDocument::Source(std::string_view text) const noexcept
+{
+    return Span{static_cast<std::uint32_t>(text.data() - source_.data()), static_cast<std::uint32_t>(text.size()),
+                false};
+}
+
+inline YamlDocument::node_id YamlDocument::AddChild(node_id parent, Span key)
+{
+    const auto child = static_cast<node_id>(nodes_.size());
+    nodes_.emplace_back();
+    nodes_[child].key = key;
+
+    Node& parent_node = nodes_[parent];
+    if (parent_node.last_child == npos) {
+        parent_node.first_child = child;
+    } else {
+        nodes_[parent_node.last_child].next_sibling = child;
+    }
+    parent_node.last_child = child;
+    ++parent_node.size;
+
+    if (parent_node.type == NodeType::Mapping && parent_node.size >= kIndexedMembers) {
+        if (parent_node.size == kIndexedMembers) {
+            for (node_id member = parent_node.first_child; member != npos; member = nodes_[member].next_sibling) {
+                IndexMember(parent, member);
+            }
+        } else {
+            IndexMember(parent, child);
+        }
+    }
+    return child;
+}
+
+inline YamlDocument::node_id YamlDocument::Child(node_id parent, std::size_t index) const noexcept
+{
+    const Node& parent_node = nodes_[parent];
+    if (index >= parent_node.size) {
+        return npos;
+    }
+    if (indexed_) {
+        return children_[parent_node.children_offset + index];
+    }
+    if (index + 1 == parent_node.size) {
+        return parent_node.last_child;
+    }
+
+    node_id child = parent_node.first_child;
+    while (index--) {
+        child = nodes_[child].next_sibling;
+    }
+    return child;
+}
+
+inline YamlDocument::node_id YamlDocument::Member(node_id parent, std::string_view key) const noexcept
+{
+    if (nodes_[parent].type != NodeType::Mapping || nodes_[parent].size < kIndexedMembers) {
+        for (node_id child = nodes_[parent].first_child; child != npos; child = nodes_[child].next_sibling) {
+            if (View(nodes_[child].key) == key) {
+                return child;
+            }
+        }
+        return npos;
+    }
+
+    const std::size_t mask = member_index_.size() - 1;
+    for (std::size_t position = MemberHash(parent, key) & mask; member_index_[position].member != npos;
+         position = (position + 1) & mask) {
+        const MemberSlot& slot = member_index_[position];
+        if (slot.parent == parent && View(nodes_[slot.member].key) == key) {
+            return slot.member;
+        }
+    }
+    return npos;
+}
+
+inline void YamlDocument::IndexMember(node_id parent, node_id member)
+{
+    // open addressing with linear probing, the table is kept at most half full
+    if (2 * (indexed_members_ + 1) > member_index_.size()) {
+        std::vector<MemberSlot> slots(std::max<std::size_t>(64, 2 * member_index_.size()));
+        slots.swap(member_index_);
+        indexed_members_ = 0;
+        for (const MemberSlot& slot : slots) {
+            if (slot.member != npos) {
+                IndexMember(slot.parent, slot.member);
+            }
+        }
+    }
+
+    const std::size_t mask = member_index_.size() - 1;
+    std::size_t position = MemberHash(parent, View(nodes_[member].key)) & mask;
+    while (member_index_[position].member != npos) {
+        position = (position + 1) & mask;
+    }
+    member_index_[position] = MemberSlot{parent, member};
+    ++indexed_members_;
+}
+
+inline void YamlDocument::UnindexMembers(node_id parent)
+{
+    if (nodes_[parent].type != NodeType::Mapping || nodes_[parent].size < kIndexedMembers) {
+        return;
+    }
+
+    // slots can not be just cleared without breaking probing sequences, so the rest is indexed anew
+    std::vector<MemberSlot> slots(member_index_.size());
+    slots.swap(member_index_);
+    indexed_members_ = 0;
+    for (const MemberSlot& slot : slots) {
+        if (slot.member != npos && slot.parent != parent) {
+            IndexMember(slot.parent, slot.member);
+        }
+    }
+}
+
+inline std::uint64_t YamlDocument::MemberHash(node_id parent, std::string_view key) noexcept
+{
+    return detail::fnv1a(key.data(), key.size(), detail::fnv1a(&parent, sizeof(parent)));
+}
+
+inline void YamlDocument::Reindex()
+{
+    children_.resize(nodes_.size() - 1);
+
+    std::uint32_t offset = 0;
+    for (auto& node : nodes_) {
+        node.children_offset = offset;
+        for (node_id child = node.first_child; child != npos; child = nodes_[child].next_sibling) {
+            children_[offset++] = child;
+        }
+    }
+    indexed_ = true;
+}
+
+inline void YamlDocument::ParseLine(ParseState& state, std::string_view line)
+{
+    std::size_t indent = 0;
+    while (indent < line.size() && line[indent] == ' ') {
+        ++indent;
+    }
+
+    std::string_view content = detail::yaml_rtrim(detail::yaml_strip_comment(line.substr(indent)));
+    if (content.empty()) {
+        return;
+    }
+    if (content[0] == '\t') {
+        Fail(state.line_no, "tabs are not allowed for indentation");
+    }
+    if (indent == 0 && (content == "---" || content == "...")) {
+        if (content == "---" && nodes_[0].type != NodeType::Null) {
+            Fail(state.line_no, "multiple documents are not supported");
+        }
+        return;
+    }
+    if (indent == 0 && content[0] == '%') {
+        // directives are ignored
+        return;
+    }
+
+    const bool sequence_entry = detail::yaml_is_sequence_entry(content);
+    if (state.pending != npos) {
+        // value of the previous entry was empty, it may be a block
+        const bool nested = indent > state.pending_indent ||
+                            (indent == state.pending_indent && sequence_entry && state.pending_from_key);
+        if (nested) {
+            nodes_[state.pending].type = sequence_entry ? NodeType::Sequence : NodeType::Mapping;
+            state.stack.push_back({indent, state.pending});
+        }
+        state.pending = npos;
+    } else if (state.stack.empty()) {
+        if (nodes_[0].type != NodeType::Null) {
+            Fail(state.line_no, "unexpected content after the root scalar");
+        }
+        if (!sequence_entry && detail::yaml_mapping_colon(content) == std::string_view::npos) {
+            // document is a single scalar
+            ParseScalar(state, 0, content);
+            return;
+        }
+        nodes_[0].type = sequence_entry ? NodeType::Sequence : NodeType::Mapping;
+        state.stack.push_back({indent, 0});
+    }
+
+    while (!state.stack.empty() && state.stack.back().indent > indent) {
+        state.stack.pop_back();
+    }
+    // sequence may have the same indentation as its' key, mapping entry closes it
+    if (!sequence_entry && state.stack.size() > 1 && nodes_[state.stack.back().node].type == NodeType::Sequence &&
+        state.stack[state.stack.size() - 2].indent == indent) {
+        state.stack.pop_back();
+    }
+    if (state.stack.empty() || state.stack.back().indent != indent) {
+        Fail(state.line_no, "bad indentation");
+    }
+
+    ParseEntry(state, state.stack.back().node, indent, content);
+}
+
+inline void YamlDocument::ParseEntry(ParseState& state, node_id container, std::size_t indent,
+                                     std::string_view content)
+{
+    const bool sequence_entry = detail::yaml_is_sequence_entry(content);
+    if (sequence_entry != (nodes_[container].type == NodeType::Sequence)) {
+        Fail(state.line_no, sequence_entry ? "unexpected sequence entry in a mapping"
+                                           : "unexpected mapping entry in a sequence");
+    }
+
+    if (sequence_entry) {
+        const node_id item = AddChild(container, {});
+
+        std::size_t skip = 1;
+        while (skip < content.size() && content[skip] == ' ') {
+            ++skip;
+        }
+        const std::string_view rest = content.substr(skip);
+        if (rest.empty()) {
+            state.pending = item;
+            state.pending_indent = indent;
+            state.pending_from_key = false;
+            return;
+        }
+
+        const bool nested_sequence = detail::yaml_is_sequence_entry(rest);
+        if (nested_sequence || detail::yaml_mapping_colon(rest) != std::string_view::npos) {
+            // compact nested block: "- key: value" or "- - value"
+            nodes_[item].type = nested_sequence ? NodeType::Sequence : NodeType::Mapping;
+            state.stack.push_back({indent + skip, item});
+            ParseEntry(state, item, indent + skip, rest);
+            return;
+        }
+        ParseScalar(state, item, rest);
+        return;
+    }
+
+    const std::size_t colon = detail::yaml_mapping_colon(content);
+    if (colon == std::string_view::npos) {
+        Fail(state.line_no, "expected 'key: value' entry");
+    }
+
+    const std::string_view raw_key = detail::yaml_trim(content.substr(0, colon));
+    Span key;
+    if (!raw_key.empty() && (raw_key[0] == '"' || raw_key[0] == '\'')) {
+        std::size_t consumed = 0;
+        key = ParseQuoted(state, raw_key, &consumed);
+        if (consumed != raw_key.size()) {
+            Fail(state.line_no, "unexpected characters after the quoted key");
+        }
+    } else {
+        key = Source(raw_key);
+    }
+    if (Member(container, View(key)) != npos) {
+        Fail(state.line_no, "duplicate key '" + std::string(View(key)) + "'");
+    }
+
+    const node_id member = AddChild(container, key);
+    const std::string_view rest = detail::yaml_trim(content.substr(colon + 1));
+    if (rest.empty()) {
+        state.pending = member;
+        state.pending_indent = indent;
+        state.pending_from_key = true;
+        return;
+    }
+    ParseScalar(state, member, rest);
+}
+
+inline void YamlDocument::ParseScalar(const ParseState& state, node_id node, std::string_view text)
+{
+    if (text == "[]") {
+        nodes_[node].type = NodeType::Sequence;
+        return;
+    }
+    if (text == "{}") {
+        nodes_[node].type = NodeType::Mapping;
+        return;
+    }
+
+    switch (text[0]) {
+    case '[':
+    case '{':
+        Fail(state.line_no, "flow collections are not supported");
+    case '|':
+    case '>':
+        Fail(state.line_no, "block scalars are not supported");
+    case '&':
+    case '*':
+    case '!':
+        Fail(state.line_no, "anchors, aliases and tags are not supported");
+    case '"':
+    case '\'': {
+        std::size_t consumed = 0;
+        const Span value = ParseQuoted(state, text, &consumed);
+        if (consumed != text.size()) {
+            Fail(state.line_no, "unexpected characters after the quoted scalar");
+        }
+        nodes_[node].type = NodeType::Scalar;
+        nodes_[node].quoted = true;
+        nodes_[node].value = value;
+        return;
+    }
+    default:
+        break;
+    }
+
+    if (text == "~" || text == "null" || text == "Null" || text == "NULL") {
+        return;
+    }
+    nodes_[node].type = NodeType::Scalar;
+    nodes_[node].value = Source(text);
+}
+
+inline YamlDocument::Span YamlDocument::ParseQuoted(const ParseState& state, std::string_view text,
+                                                    std::size_t* consumed)
+{
+    const std::size_t end = detail::yaml_quoted_end(text, 0);
+    if (end == std::string_view::npos) {
+        Fail(state.line_no, "quoted scalar is not closed");
+    }
+    *consumed = end + 1;
+
+    const std::string_view body = text.substr(1, end - 1);
+    const char escape = text[0] == '"' ? '\\' : '\'';
+    if (body.find(escape) == std::string_view::npos) {
+        return Source(body);
+    }
+
+    std::string result;
+    result.reserve(body.size());
+    for (std::size_t i = 0; i < body.size(); ++i) {
+        if (body[i] != escape) {
+            result += body[i];
+            continue;
+        }
+        ++i;
+        if (escape == '\'') {
+            result += '\'';
+            continue;
+        }
+        switch (body[i]) {
+        case 'n':
+            result += '\n';
+            break;
+        case 't':
+            result += '\t';
+            break;
+        case 'r':
+            result += '\r';
+            break;
+        case '0':
+            result += '\0';
+            break;
+        case 'b':
+            result += '\b';
+            break;
+        case 'f':
+            result += '\f';
+            break;
+        case 'e':
+            result += '\x1B';
+            break;
+        case '"':
+        case '\\':
+        case '/':
+        case ' ':
+            result += body[i];
+            break;
+        case 'x':
+        case 'u':
+        case 'U': {
+            const std::size_t digits = body[i] == 'x' ? 2 : (body[i] == 'u' ? 4 : 8);
+            std::uint32_t code_point = 0;
+            const char* first = body.data() + i + 1;
+            auto [ptr, ec] = std::from_chars(first, first + std::min(digits, body.size() - i - 1), code_point, 16);
+            if (ec != std::errc() || ptr != first + digits) {
+                Fail(state.line_no, "invalid escape sequence");
+            }
+            detail::yaml_append_utf8(result, code_point);
+            i += digits;
+            break;
+        }
+        default:
+            Fail(state.line_no, "invalid escape sequence");
+        }
+    }
+    return Own(result);
+}
+
+inline void YamlDocument::Fail(std::size_t line_no, const std::string& what)
+{
+    throw ParseError(YamlFormat::name + " document is not valid at line " + std::to_string(line_no) + ": " + what);
+}
+
+inline void YamlDocument::DumpBlock(std::string& out, node_id id, std::size_t indent, bool inline_first) const
+{
+    const Node& node = nodes_[id];
+    bool first = true;
+    for (node_id child = node.first_child; child != npos; child = nodes_[child].next_sibling) {
+        if (!(first && inline_first)) {
+            out.append(indent, ' ');
+        }
+        first = false;
+
+        const Node& child_node = nodes_[child];
+        const bool block = (child_node.type == NodeType::Mapping || child_node.type == NodeType::Sequence) &&
+                           child_node.size > 0;
+        if (node.type == NodeType::Mapping) {
+            DumpScalar(out, View(child_node.key), detail::yaml_needs_quotes(View(child_node.key)));
+            out += ':';
+            if (block) {
+                out += '\n';
+                DumpBlock(out, child, indent + 2, false);
+                continue;
+            }
+            out += ' ';
+        } else {
+            out += "- ";
+            if (block) {
+                DumpBlock(out, child, indent + 2, true);
+                continue;
+            }
+        }
+
+        switch (child_node.type) {
+        case NodeType::Mapping:
+            out += "{}";
+            break;
+        case NodeType::Sequence:
+            out += "[]";
+            break;
+        case NodeType::Null:
+            out += "null";
+            break;
+        case NodeType::Scalar:
+            DumpScalar(out, View(child_node.value), child_node.quoted);
+            break;
+        }
+        out += '\n';
+    }
+}
+
+inline void YamlDocument::DumpScalar(std::string& out, std::string_view text, bool quoted)
+{
+    if (!quoted || !detail::yaml_needs_quotes(text)) {
+        out += text;
+        return;
+    }
+
+    static const char* hex = "0123456789ABCDEF";
+    out += '"';
+    for (char c : text) {
+        switch (c) {
+        case '"':
+            out += "\\\"";
+            break;
+        case '\\':
+            out += "\\\\";
+            break;
+        case '\n':
+            out += "\\n";
+            break;
+        case '\t':
+            out += "\\t";
+            break;
+        case '\r':
+            out += "\\r";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20 || c == 0x7F) {
+                out += "\\x";
+                out += hex[(c >> 4) & 0xF];
+                out += hex[c & 0xF];
+            } else {
+                out += c;
+            }
+        }
+    }
+    out += '"';
+}
+
+inline bool YamlDocument::Equal(node_id id, const YamlDocument& other, node_id other_id) const noexcept
+{
+    const Node& node = nodes_[id];
+    const Node& other_node = other.nodes_[other_id];
+    if (node.type != other_node.type || node.size != other_node.size) {
+        return false;
+    }
+
+    switch (node.type) {
+    case NodeType::Null:
+        return true;
+    case NodeType::Scalar: {
+        // quotes matter only if the scalar would be read differently without them
+        const std::string_view text = View(node.value);
+        const bool quoted = node.quoted && detail::yaml_needs_quotes(text);
+        const bool other_quoted = other_node.quoted && detail::yaml_needs_quotes(other.View(other_node.value));
+        return quoted == other_quoted && text == other.View(other_node.value);
+    }
+    case NodeType::Mapping:
+        for (node_id child = node.first_child; child != npos; child = nodes_[child].next_sibling) {
+            const node_id other_child = other.Member(other_id, View(nodes_[child].key));
+            if (other_child == npos || !Equal(child, other, other_child)) {
+                return false;
+            }
+        }
+        return true;
+    case NodeType::Sequence:
+        for (std::size_t index = 0; index < node.size; ++index) {
+            if (!Equal(Child(id, index), other, other.Child(other_id, index))) {
+                return false;
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+} // namespace uconfig
@@ -0,0 +1,151 @@
+#pragma once
+
+namespace uconfig {
+
+inline BudgetError::BudgetError(Limit exceeded, std::string element_path, const std::string& message)
+    : ParseError(message)
+    , limit(exceeded)
+    , path(std::move(element_path))
+{
+}
+
+inline ParseBudget::ParseBudget(const ParseLimits& limits)
+    : limits_(limits)
+    , previous_(Current())
+    , previous_depth_(Depth())
+{
+    const auto now = std::chrono::steady_clock::now();
+    // saturate instead of overflowing for unlimited timeouts
+    if (limits_.timeout >= std::chrono::steady_clock::time_point::max() - now) {
+        deadline_ = std::chrono::steady_clock::time_point::max();
+    } else {
+        deadline_ = now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(limits_.timeout);
+    }
+    Current() = this;
+    Depth() = 0;
+}
+
+inline ParseBudget::~ParseBudget()
+{
+    Current() = previous_;
+    Depth() = previous_depth_;
+}
+
+inline std::size_t ParseBudget::TotalBytes() const noexcept
+{
+    return total_bytes_.load(std::memory_order_relaxed);
+}
+
+inline ParseBudget::DepthGuard::DepthGuard(const std::string& format, const std::string& path)
+    : budget_(Current())
+{
+    if (!budget_) {
+        return;
+    }
+    if (++Depth() > budget_->limits_.max_depth) {
+        --Depth();
+        Fail(BudgetError::Limit::Depth, format, path,
+             "nesting exceeds max depth " + std::to_string(budget_->limits_.max_depth));
+    }
+    try {
+        budget_->CheckDeadline(format, path, true);
+    } catch (...) {
+        --Depth();
+        throw;
+    }
+}
+
+inline ParseBudget::DepthGuard::~DepthGuard()
+{
+    if (budget_) {
+        --Depth();
+    }
+}
+
+inline ParseBudget::WorkerScope::WorkerScope() noexcept
+    : budget_(Current())
+    , depth_(Depth())
+{
+}
+
+inline void ParseBudget::WorkerScope::Attach() const noexcept
+{
+    Current() = budget_;
+    Depth() = depth_;
+}
+
+inline void ParseBudget::CheckVectorSize(const std::string& format, const std::string& path, std::size_t size)
+{
+    const ParseBudget* budget = Current();
+    if (budget && size > budget->limits_.max_vector_size) {
+        Fail(BudgetError::Limit::VectorSize, format, path,
+             "vector exceeds max size " + std::to_string(budget->limits_.max_vector_size));
+    }
+}
+
+template <typename T>
+void ParseBudget::Account(const std::string& format, const std::string& path, const T& value)
+{
+    ParseBudget* budget = Current();
+    if (!budget) {
+        return;
+    }
+    if constexpr (std::is_same_v<T, std::string> || std::is_same_v<T, InternedString>) {
+        budget->Account(format, path, std::string_view(value).size(), true);
+    } else {
+        budget->Account(format, path, sizeof(T), false);
+    }
+}
+
+inline ParseBudget*& ParseBudget::Current() noexcept
+{
+    static thread_local ParseBudget* budget = nullptr;
+    return budget;
+}
+
+inline std::size_t& ParseBudget::Depth() noexcept
+{
+    static thread_local std::size_t depth = 0;
+    return depth;
+}
+
+inline void ParseBudget::Account(const std::string& format, const std::string& path, std::size_t bytes,
+                                 bool is_string)
+{
+    if (is_string && bytes > limits_.max_string_size) {
+        Fail(BudgetError::Limit::StringSize, format, path,
+             "string exceeds max size " + std::to_string(limits_.max_string_size));
+    }
+    const std::size_t total_bytes = total_bytes_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    if (total_bytes > limits_.max_total_bytes) {
+        Fail(BudgetError::Limit::TotalBytes, format, path,
+             "parsed values exceed max total size " + std::to_string(limits_.max_total_bytes));
+    }
+    CheckDeadline(format, path, false);
+}
+
+inline void ParseBudget::CheckDeadline(const std::string& format, const std::string& path, bool force)
+{
+    // reading the clock for every value is too expensive for large vectors
+    constexpr std::size_t kValuesPerCheck = 64;
+
+    if (deadline_ == std::chrono::steady_clock::time_point::max()) {
+        return;
+    }
+    if (!force && checks_.fetch_add(1, std::memory_order_relaxed) % kValuesPerCheck != 0) {
+        return;
+    }
+    if (std::chrono::steady_clock::now() >= deadline_) {
+        const auto timeout = std::chrono::duration_cast<std::chrono::milliseconds>(limits_.timeout);
+        Fail(BudgetError::Limit::Deadline, format, path,
+             "parse exceeds deadline of " + std::to_string(timeout.count()) + "ms");
+    }
+}
+
+inline void ParseBudget::Fail(BudgetError::Limit limit, const std::string& format, const std::string& path,
+                              const std::string& reason)
+{
+    throw BudgetError(limit, path, format + " config '" + path + "' is not valid: " + reason);
+}
+
+} // namespace uconfig
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <algorithm>
+#include <sstream>
+
+namespace uconfig {
+
+template <typename F, typename C>
+std::vector<Change> Diff(const F& format, const C& before, const C& after, const std::string& path)
+{
+    static_assert(detail::is_base_of_template<C, Config>::value, "only configs can be compared");
+
+    std::vector<Change> changes;
+    detail::diff_values(format, path, &before, &after, &changes);
+    return changes;
+}
+
+namespace detail {
+
+template <typename T>
+std::string print_value(const T& value)
+{
+    if constexpr (is_printable<T>::value) {
+        std::ostringstream out;
+        out << value;
+        return out.str();
+    } else {
+        return {};
+    }
+}
+
+template <typename T>
+std::string print_value(const std::vector<T>& values)
+{
+    if constexpr (is_printable<T>::value) {
+        std::ostringstream out;
+        out << "[";
+        for (std::size_t index = 0; index < values.size(); ++index) {
+            out << (index ? ", " : "") << values[index];
+        }
+        out << "]";
+        return out.str();
+    } else {
+        return {};
+    }
+}
+
+template <typename IfaceT, typename F>
+const IfaceT& diff_peer(const IfaceT& iface, const Interface<F>& other)
+{
+    const auto* peer = dynamic_cast<const IfaceT*>(&other);
+    if (!peer || peer->Path() != iface.Path()) {
+        throw Error(F::name + " config '" + iface.Path() + "' can not be compared with '" + other.Path() +
+                    "': different elements");
+    }
+    return *peer;
+}
+
+template <typename T, typename F>
+void diff_values(const F& format, const std::string& path, const T* before, const T* after,
+                 std::vector<Change>* changes)
+{
+    if (!before && !after) {
+        return;
+    }
+    if (!before) {
+        changes->push_back(Change{Change::Kind::Added, path, {}, print_value(*after)});
+        return;
+    }
+    if (!after) {
+        changes->push_back(Change{Change::Kind::Removed, path, print_value(*before), {}});
+        return;
+    }
+
+    if constexpr (is_base_of_template<T, Config>::value) {
+        // registration of the elements does not change their values
+        const ConfigIface<F> before_iface(path, const_cast<T*>(before));
+        const ConfigIface<F> after_iface(path, const_cast<T*>(after));
+        before_iface.Diff(format, after_iface, changes);
+    } else {
+        bool equal;
+        if constexpr (is_equality_comparable<T>::value) {
+            equal = *before == *after;
+        } else {
+            // values which can be neither compared nor printed are considered changed
+            equal = is_printable<T>::value && print_value(*before) == print_value(*after);
+        }
+        if (!equal) {
+            changes->push_back(Change{Change::Kind::Replaced, path, print_value(*before), print_value(*after)});
+        }
+    }
+}
+
+template <typename T, typename F>
+void diff_vectors(const F& format, const std::string& path, const std::vector<T>* before,
+                  const std::vector<T>* after, std::vector<Change>* changes)
+{
+    // vectors of sections can not be compared as a whole
+    if (!before && !after) {
+        return;
+    }
+    if (!before) {
+        changes->push_back(Change{Change::Kind::Added, path, {}, print_value(*after)});
+        return;
+    }
+    if (!after) {
+        changes->push_back(Change{Change::Kind::Removed, path, print_value(*before), {}});
+        return;
+    }
+
+    const std::size_t common = std::min(before->size(), after->size());
+    for (std::size_t index = 0; index < common; ++index) {
+        diff_values(format, format.VectorElementPath(path, index), &(*before)[index], &(*after)[index], changes);
+    }
+    for (std::size_t index = common; index < after->size(); ++index) {
+        diff_values<T>(format, format.VectorElementPath(path, index), nullptr, &(*after)[index], changes);
+    }
+    // removed from the end, so the changes can be applied one by one
+    for (std::size_t index = before->size(); index > common; --index) {
+        diff_values<T>(format, format.VectorElementPath(path, index - 1), &(*before)[index - 1], nullptr, changes);
+    }
+}
+
+} // namespace detail
+
+} // namespace uconfig
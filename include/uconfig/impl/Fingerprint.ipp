@@ -0,0 +1,58 @@
+#pragma once
+
+#include <sstream>
+#include <string_view>
+#include <type_traits>
+
+namespace uconfig {
+namespace detail {
+
+template <typename F, typename T>
+std::uint64_t fingerprint_value(const std::string& path, const T& value, std::uint64_t hash)
+{
+    if constexpr (is_base_of_template<T, Config>::value) {
+        // registration of the elements does not change their values
+        return ConfigIface<F>(path, const_cast<T*>(&value)).Fingerprint(hash);
+    } else if constexpr (std::is_same<T, bool>::value) {
+        return fnv1a_tagged('b', &value, sizeof(value), hash);
+    } else if constexpr (std::is_integral<T>::value && std::is_signed<T>::value) {
+        const auto integer = static_cast<std::int64_t>(value);
+        return fnv1a_tagged('i', &integer, sizeof(integer), hash);
+    } else if constexpr (std::is_integral<T>::value || std::is_enum<T>::value) {
+        const auto integer = static_cast<std::uint64_t>(value);
+        return fnv1a_tagged(std::is_enum<T>::value ? 'e' : 'u', &integer, sizeof(integer), hash);
+    } else if constexpr (std::is_floating_point<T>::value) {
+        // -0.0 and 0.0 are equal values
+        const double number = value == 0 ? 0.0 : static_cast<double>(value);
+        return fnv1a_tagged('f', &number, sizeof(number), hash);
+    } else if constexpr (std::is_convertible<const T&, std::string_view>::value) {
+        const std::string_view string = value;
+        return fnv1a_tagged('s', string.data(), string.size(), hash);
+    } else if constexpr (is_printable<T>::value) {
+        std::ostringstream out;
+        out << value;
+        const std::string printed = out.str();
+        return fnv1a_tagged('p', printed.data(), printed.size(), hash);
+    } else {
+        throw Error(F::name + " config '" + path + "' can not be fingerprinted: value is not printable");
+    }
+}
+
+template <typename F, typename T>
+std::uint64_t fingerprint_value(const std::string& path, const std::vector<T>& values, std::uint64_t hash)
+{
+    const std::size_t size = values.size();
+    hash = fnv1a_tagged('v', &size, sizeof(size), hash);
+    for (const auto& value : values) {
+        hash = fingerprint_value<F>(path, value, hash);
+    }
+    return hash;
+}
+
+inline std::uint64_t fingerprint_absent(std::uint64_t hash) noexcept
+{
+    return fnv1a_tagged('n', nullptr, 0, hash);
+}
+
+} // namespace detail
+} // namespace uconfig
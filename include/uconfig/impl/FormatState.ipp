@@ -0,0 +1,44 @@
+#pragma once
+
+namespace uconfig {
+
+template <typename State>
+State* FormatState<State>::Current() noexcept
+{
+    return CurrentRef();
+}
+
+template <typename State>
+FormatState<State>::Scope::Scope(State* state) noexcept
+    : previous_(CurrentRef())
+{
+    if (state) {
+        CurrentRef() = state;
+    }
+}
+
+template <typename State>
+FormatState<State>::Scope::~Scope()
+{
+    CurrentRef() = previous_;
+}
+
+template <typename State>
+State*& FormatState<State>::CurrentRef() noexcept
+{
+    static thread_local State* state = nullptr;
+    return state;
+}
+
+namespace detail {
+
+template <typename F>
+FormatStateScope<F>::FormatStateScope(const F& format)
+    : state_(format)
+    , scope_(&state_)
+{
+}
+
+} // namespace detail
+
+} // namespace uconfig
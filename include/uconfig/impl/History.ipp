@@ -0,0 +1,107 @@
+#pragma once
+
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace uconfig {
+
+template <typename T>
+ConfigHistory<T>::ConfigHistory(std::size_t capacity)
+    : capacity_(capacity)
+{
+    if (capacity_ == 0) {
+        throw std::invalid_argument("config history capacity should be positive");
+    }
+}
+
+template <typename T>
+std::uint64_t ConfigHistory<T>::Commit(T value)
+{
+    return Commit(std::make_shared<const T>(std::move(value)));
+}
+
+template <typename T>
+std::uint64_t ConfigHistory<T>::Commit(std::shared_ptr<const T> snapshot)
+{
+    if (!snapshot) {
+        throw std::runtime_error("invalid snapshot pointer to commit");
+    }
+
+    // dropped version is destroyed after the lock is released
+    std::shared_ptr<const T> dropped;
+    std::lock_guard<std::mutex> lock(mutex_);
+    dropped = Push(std::move(snapshot));
+    return first_version_ + snapshots_.size() - 1;
+}
+
+template <typename T>
+std::shared_ptr<const T> ConfigHistory<T>::Rollback(std::uint64_t version)
+{
+    std::shared_ptr<const T> dropped;
+    std::lock_guard<std::mutex> lock(mutex_);
+    const std::shared_ptr<const T>* snapshot = Find(version);
+    if (!snapshot) {
+        throw std::out_of_range("config version " + std::to_string(version) + " is not retained");
+    }
+    std::shared_ptr<const T> current = *snapshot;
+    dropped = Push(current);
+    return current;
+}
+
+template <typename T>
+std::shared_ptr<const T> ConfigHistory<T>::Current() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return snapshots_.empty() ? nullptr : snapshots_.back();
+}
+
+template <typename T>
+std::uint64_t ConfigHistory<T>::CurrentVersion() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return first_version_ + snapshots_.size() - 1;
+}
+
+template <typename T>
+std::shared_ptr<const T> ConfigHistory<T>::Get(std::uint64_t version) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const std::shared_ptr<const T>* snapshot = Find(version);
+    return snapshot ? *snapshot : nullptr;
+}
+
+template <typename T>
+std::vector<std::uint64_t> ConfigHistory<T>::Versions() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<std::uint64_t> versions(snapshots_.size());
+    for (std::size_t index = 0; index < versions.size(); ++index) {
+        versions[index] = first_version_ + index;
+    }
+    return versions;
+}
+
+template <typename T>
+const std::shared_ptr<const T>* ConfigHistory<T>::Find(std::uint64_t version) const noexcept
+{
+    if (version < first_version_ || version - first_version_ >= snapshots_.size()) {
+        return nullptr;
+    }
+    return &snapshots_[version - first_version_];
+}
+
+template <typename T>
+std::shared_ptr<const T> ConfigHistory<T>::Push(std::shared_ptr<const T> snapshot)
+{
+    snapshots_.push_back(std::move(snapshot));
+    if (snapshots_.size() <= capacity_) {
+        return nullptr;
+    }
+    std::shared_ptr<const T> dropped = std::move(snapshots_.front());
+    snapshots_.pop_front();
+    ++first_version_;
+    return dropped;
+}
+
+} // namespace uconfig
@@ -1,6 +1,172 @@
 #pragma once
 
 namespace uconfig {
+namespace detail {
+
+inline MemoScope::MemoScope(MemoStats* stats) noexcept
+    : previous_(Current())
+{
+    if (!previous_) {
+        Current() = stats;
+    }
+}
+
+inline MemoScope::~MemoScope()
+{
+    Current() = previous_;
+}
+
+inline bool MemoScope::Active() const noexcept
+{
+    return Current() != nullptr;
+}
+
+inline void MemoScope::Account(bool skipped) noexcept
+{
+    ++(skipped ? Current()->skipped : Current()->parsed);
+}
+
+inline MemoStats*& MemoScope::Current() noexcept
+{
+    static thread_local MemoStats* stats = nullptr;
+    return stats;
+}
+
+inline bool validate_object(const std::string& format_name, const std::string& path, const Object& object,
+                            bool throw_on_fail)
+{
+    try {
+        UCONFIG_TRACE(Validate, format_name, path);
+        ParseProfiler::ValidatorTimer timer(path);
+        object.Validate();
+    } catch (const Error& ex) {
+        if (throw_on_fail) {
+            throw ParseError(ex.what());
+        }
+        return false;
+    } catch (const std::exception& ex) {
+        if (throw_on_fail) {
+            throw_parse_error(format_name, path, ex.what());
+        }
+        return false;
+    }
+    return true;
+}
+
+inline void throw_parse_error(const std::string& format_name, const std::string& path, const char* reason)
+{
+    throw ParseError(format_name + " config '" + path + "' is not valid: " + reason);
+}
+
+inline void throw_emit_error(const std::string& format_name, const std::string& path, const char* reason)
+{
+    throw EmitError(format_name + " config '" + path + "' is not valid: " + reason);
+}
+
+inline bool check_found(const std::string& format_name, const std::string& path, bool found, bool required,
+                        bool throw_on_fail)
+{
+    if (!found && required && throw_on_fail) {
+        throw_parse_error(format_name, path, "variable is not set");
+    }
+    return found;
+}
+
+inline std::size_t parse_elements(ElementThunk parse_element, void* context, std::optional<Error>* error)
+{
+    std::size_t index = 0;
+    while (true) {
+        try {
+            // always stop on fail to prevent looping
+            if (!parse_element(context, index)) {
+                break;
+            }
+        } catch (const BudgetError&) {
+            throw;
+        } catch (const Error& ex) {
+            *error = ex;
+            break;
+        }
+        ++index;
+    }
+    return index;
+}
+
+inline bool complete_vector_parse(const std::string& format_name, const std::string& path, const Object& vector,
+                                  std::size_t parsed_size, const std::optional<Error>& error, bool throw_on_fail)
+{
+    if (!vector.Initialized() && !vector.Optional()) {
+        // notify that mandatory vector was not parsed
+        if (error) {
+            throw ParseError(error->what());
+        }
+        throw_parse_error(format_name, path, "vector is not set");
+    }
+
+    validate_object(format_name, path, vector, throw_on_fail);
+    return parsed_size > 0;
+}
+
+inline void emit_elements(const std::string& format_name, const std::string& first_path, const Object& vector,
+                          std::size_t size, ElementThunk emit_element, void* context, bool throw_on_fail)
+{
+    if (size == 0) {
+        if (!vector.Optional() && throw_on_fail) {
+            const char* reason =
+                vector.Initialized() ? "variable is not set" : "failed to get variable value: it is not set";
+            throw_emit_error(format_name, first_path, reason);
+        }
+        return;
+    }
+    for (std::size_t index = 0; index < size; ++index) {
+        emit_element(context, index);
+    }
+}
+
+template <typename T, typename F>
+bool emit_element(void* context, std::size_t index)
+{
+    const auto& emit = *static_cast<EmitContext<T, F>*>(context);
+    deduce_iface_t<T, F> iface(emit.emitter->VectorElementPath(*emit.path, index), &(*emit.elements)[index]);
+    iface.Emit(*emit.emitter, emit.dest, emit.throw_on_fail);
+    return true;
+}
+
+template <typename T>
+std::pair<std::unique_lock<std::mutex>, std::unique_lock<std::mutex>> lock_storages(SharedStorage<T>* storage,
+                                                                                    SharedStorage<T>* other)
+{
+    if (storage == other) {
+        other = nullptr;
+    }
+    std::unique_lock<std::mutex> lock;
+    std::unique_lock<std::mutex> other_lock;
+    if (storage && other) {
+        lock = std::unique_lock<std::mutex>(storage->mutex, std::defer_lock);
+        other_lock = std::unique_lock<std::mutex>(other->mutex, std::defer_lock);
+        std::lock(lock, other_lock);
+    } else if (storage) {
+        lock = std::unique_lock<std::mutex>(storage->mutex);
+    } else if (other) {
+        other_lock = std::unique_lock<std::mutex>(other->mutex);
+    }
+    return {std::move(lock), std::move(other_lock)};
+}
+
+} // namespace detail
+
+template <typename Format>
+void Interface<Format>::Diff(const format_type& /*format*/, const Interface<Format>& /*other*/,
+                             std::vector<Change>* /*changes*/) const
+{
+    throw Error(format_type::name + " config '" + Path() + "' can not be compared: not supported by the object");
+}
+
+template <typename Format>
+std::uint64_t Interface<Format>::Fingerprint(std::uint64_t /*hash*/) const
+{
+    throw Error(format_type::name + " config '" + Path() + "' can not be fingerprinted: not supported by the object");
+}
 
 template <typename Format>
 template <typename... FormatTs>
@@ -12,23 +178,70 @@ ConfigIface<Format>::ConfigIface(const std::string& parse_path, Config<FormatTs.
     }
     config->Reset();
     config->template SetFormat<Format>();
-    config->Init(Path());
+    {
+        ParseProfiler::PhaseTimer timer(ParseProfiler::Phase::Init);
+        config->Init(Path());
+    }
     cfg_optional_ = config->Optional();
     cfg_interfaces_ = &config->template Interfaces<format_type>();
-    cfg_validate_ = [config]() { config->Validate(); };
+    cfg_object_ = config;
+    cfg_memo_ = &config->memo_;
+    cfg_memo_stats_ = config->memoize_ ? &config->memo_stats_ : nullptr;
+    cfg_fingerprint_ = &config->fingerprint_;
+    cfg_intern_pool_ = config->interning_ ? &config->intern_pool_ : nullptr;
+    cfg_interpolation_ = config->interpolation_;
 }
 
 template <typename Format>
 bool ConfigIface<Format>::Parse(const format_type& parser, const source_type* source, bool throw_on_fail)
 {
+    UCONFIG_TRACE(ParseSection, format_type::name, Path());
+    ParseBudget::DepthGuard depth_guard(format_type::name, Path());
     bool config_parsed = false;
+    bool config_failed = false;
+
+    // references are resolved across the whole section, nested sections join the outer interpolation
+    std::optional<Interpolation> interpolation;
+    if (cfg_interpolation_ && !Interpolation::Current()) {
+        interpolation.emplace();
+    }
+    Interpolation::Scope interpolation_scope(interpolation ? &*interpolation : nullptr);
+
+    detail::MemoScope memo_scope(cfg_memo_stats_);
+    std::optional<std::uint64_t> subtree_hash;
+    if constexpr (detail::has_subtree_hash<Format>::value) {
+        if (memo_scope.Active()) {
+            subtree_hash = parser.SubtreeHash(source, Path());
+            // strict parse has to see all the keys consumed by the section, references may point outside of it
+            if (subtree_hash && !KeyTracker::Current() && !Interpolation::Current() &&
+                cfg_memo_->format == &format_type::name && cfg_memo_->hash == *subtree_hash) {
+                memo_scope.Account(true);
+                return cfg_memo_->parsed;
+            }
+        }
+    }
+    // values are about to change, forget the hash until the parse succeeds, also for formats without hashes
+    if (memo_scope.Active()) {
+        *cfg_memo_ = {};
+    }
+    *cfg_fingerprint_ = {};
+
+    // strings of the previous parse are released with the values holding them
+    if (cfg_intern_pool_) {
+        *cfg_intern_pool_ = InternPool::Create();
+    }
+    InternPool::Scope intern_scope(cfg_intern_pool_ ? cfg_intern_pool_->get() : nullptr);
 
     for (auto& iface : *cfg_interfaces_) {
         bool iface_parsed;
         try {
             iface_parsed = iface->Parse(parser, source, throw_on_fail);
+        } catch (const BudgetError&) {
+            // exceeded budget fails the whole parse, even of optional sections
+            throw;
         } catch (const Error& ex) {
             iface_parsed = false;
+            config_failed = true;
             if (!Optional() && throw_on_fail) {
                 throw ParseError(ex.what());
             }
@@ -37,15 +250,15 @@ bool ConfigIface<Format>::Parse(const format_type& parser, const source_type* so
         config_parsed |= iface_parsed;
     }
 
-    try {
-        cfg_validate_();
-    } catch (const Error& ex) {
-        if (throw_on_fail) {
-            throw ParseError(ex.what());
-        }
-    } catch (const std::exception& ex) {
-        if (throw_on_fail) {
-            throw ParseError(format_type::name + " config '" + Path() + "' is not valid: " + ex.what());
+    if (!detail::validate_object(format_type::name, Path(), *cfg_object_, throw_on_fail)) {
+        config_failed = true;
+    }
+
+    if (memo_scope.Active()) {
+        memo_scope.Account(false);
+        // failed sections are parsed again to report the same errors, errors are swallowed without throw_on_fail
+        if (subtree_hash && !config_failed && throw_on_fail) {
+            *cfg_memo_ = detail::SubtreeMemo{&format_type::name, *subtree_hash, config_parsed};
         }
     }
     return config_parsed;
@@ -54,6 +267,7 @@ bool ConfigIface<Format>::Parse(const format_type& parser, const source_type* so
 template <typename Format>
 void ConfigIface<Format>::Emit(const format_type& emitter, dest_type* dest, bool throw_on_fail)
 {
+    UCONFIG_TRACE(EmitSection, format_type::name, Path());
     for (auto& iface : *cfg_interfaces_) {
         try {
             iface->Emit(emitter, dest, throw_on_fail);
@@ -88,6 +302,32 @@ bool ConfigIface<Format>::Optional() const noexcept
     return cfg_optional_;
 }
 
+template <typename Format>
+void ConfigIface<Format>::Diff(const format_type& format, const Interface<Format>& other,
+                               std::vector<Change>* changes) const
+{
+    const auto& peer = detail::diff_peer(*this, other);
+    if (cfg_interfaces_->size() != peer.cfg_interfaces_->size()) {
+        throw Error(format_type::name + " config '" + Path() + "' can not be compared: different elements");
+    }
+    for (std::size_t index = 0; index < cfg_interfaces_->size(); ++index) {
+        (*cfg_interfaces_)[index]->Diff(format, *(*peer.cfg_interfaces_)[index], changes);
+    }
+}
+
+template <typename Format>
+std::uint64_t ConfigIface<Format>::Fingerprint(std::uint64_t hash) const
+{
+    if (cfg_fingerprint_->format != &format_type::name) {
+        std::uint64_t config_hash = detail::kFnvSeed;
+        for (const auto& iface : *cfg_interfaces_) {
+            config_hash = iface->Fingerprint(config_hash);
+        }
+        *cfg_fingerprint_ = detail::FingerprintMemo{&format_type::name, config_hash};
+    }
+    return detail::fnv1a_tagged('c', &cfg_fingerprint_->hash, sizeof(cfg_fingerprint_->hash), hash);
+}
+
 template <typename T, typename Format>
 ValueIface<T, Format>::ValueIface(const std::string& variable_path, T* value)
     : path_(variable_path)
@@ -102,14 +342,17 @@ ValueIface<T, Format>::ValueIface(const std::string& variable_path, T* value)
 template <typename T, typename Format>
 bool ValueIface<T, Format>::Parse(const format_type& parser, const source_type* source, bool throw_on_fail)
 {
-    std::optional<T> result_opt = parser.template Parse<T>(source, Path());
+    ParseProfiler::PathTimer path_timer(Path());
+    std::optional<T> result_opt;
+    {
+        ParseProfiler::PhaseTimer timer(ParseProfiler::Phase::Lookup);
+        result_opt = detail::parse_interpolated<T>(parser, source, Path());
+    }
 
-    if (!result_opt) {
-        if (!Optional() && throw_on_fail) {
-            throw ParseError(format_type::name + " config '" + Path() + "' is not valid: variable is not set");
-        }
+    if (!detail::check_found(format_type::name, Path(), result_opt.has_value(), !Optional(), throw_on_fail)) {
         return false;
     }
+    ParseBudget::Account(format_type::name, Path(), *result_opt);
     *value_ptr_ = std::move(*result_opt);
     initialized_ = true;
     return true;
@@ -118,7 +361,7 @@ bool ValueIface<T, Format>::Parse(const format_type& parser, const source_type*
 template <typename T, typename Format>
 void ValueIface<T, Format>::Emit(const format_type& emitter, dest_type* dest, bool /*throw_on_fail*/)
 {
-    emitter.Emit(dest, Path(), *value_ptr_);
+    emitter.Emit(dest, Path(), detail::emit_value(*value_ptr_));
 }
 
 template <typename T, typename Format>
@@ -139,6 +382,20 @@ bool ValueIface<T, Format>::Optional() const noexcept
     return false;
 }
 
+template <typename T, typename Format>
+void ValueIface<T, Format>::Diff(const format_type& format, const Interface<Format>& other,
+                                 std::vector<Change>* changes) const
+{
+    const auto& peer = detail::diff_peer(*this, other);
+    detail::diff_values(format, Path(), value_ptr_, peer.value_ptr_, changes);
+}
+
+template <typename T, typename Format>
+std::uint64_t ValueIface<T, Format>::Fingerprint(std::uint64_t hash) const
+{
+    return detail::fingerprint_value<Format>(Path(), *value_ptr_, hash);
+}
+
 template <typename T, typename Format>
 VariableIface<T, Format>::VariableIface(const std::string& variable_path, Variable<T>* variable)
     : path_(variable_path)
@@ -152,27 +409,20 @@ VariableIface<T, Format>::VariableIface(const std::string& variable_path, Variab
 template <typename T, typename Format>
 bool VariableIface<T, Format>::Parse(const format_type& parser, const source_type* source, bool throw_on_fail)
 {
-    std::optional<T> result_opt = parser.template Parse<T>(source, Path());
+    ParseProfiler::PathTimer path_timer(Path());
+    std::optional<T> result_opt;
+    {
+        ParseProfiler::PhaseTimer timer(ParseProfiler::Phase::Lookup);
+        result_opt = detail::parse_interpolated<T>(parser, source, Path());
+    }
 
-    if (!result_opt) {
-        if (!Initialized() && throw_on_fail) {
-            throw ParseError(format_type::name + " config '" + Path() + "' is not valid: variable is not set");
-        }
+    if (!detail::check_found(format_type::name, Path(), result_opt.has_value(), !Initialized(), throw_on_fail)) {
         return false;
     }
 
+    ParseBudget::Account(format_type::name, Path(), *result_opt);
     *variable_ptr_ = std::move(*result_opt);
-    try {
-        variable_ptr_->Validate();
-    } catch (const Error& ex) {
-        if (throw_on_fail) {
-            throw ParseError(ex.what());
-        }
-    } catch (const std::exception& ex) {
-        if (throw_on_fail) {
-            throw ParseError(format_type::name + " config '" + Path() + "' is not valid: " + ex.what());
-        }
-    }
+    detail::validate_object(format_type::name, Path(), *variable_ptr_, throw_on_fail);
     return true;
 }
 
@@ -180,10 +430,10 @@ template <typename T, typename Format>
 void VariableIface<T, Format>::Emit(const format_type& emitter, dest_type* dest, bool throw_on_fail)
 {
     try {
-        emitter.Emit(dest, Path(), variable_ptr_->Get());
+        emitter.Emit(dest, Path(), detail::emit_value(variable_ptr_->Get()));
     } catch (const std::exception& ex) {
         if (throw_on_fail) {
-            throw EmitError(format_type::name + " config '" + Path() + "' is not valid: " + ex.what());
+            detail::throw_emit_error(format_type::name, Path(), ex.what());
         }
         return;
     }
@@ -207,6 +457,24 @@ bool VariableIface<T, Format>::Optional() const noexcept
     return variable_ptr_->Optional();
 }
 
+template <typename T, typename Format>
+void VariableIface<T, Format>::Diff(const format_type& format, const Interface<Format>& other,
+                                    std::vector<Change>* changes) const
+{
+    const auto& peer = detail::diff_peer(*this, other);
+    detail::diff_values(format, Path(), Initialized() ? &variable_ptr_->Get() : nullptr,
+                        peer.Initialized() ? &peer.variable_ptr_->Get() : nullptr, changes);
+}
+
+template <typename T, typename Format>
+std::uint64_t VariableIface<T, Format>::Fingerprint(std::uint64_t hash) const
+{
+    if (!Initialized()) {
+        return detail::fingerprint_absent(hash);
+    }
+    return detail::fingerprint_value<Format>(Path(), variable_ptr_->Get(), hash);
+}
+
 template <typename T, typename Format>
 VectorIface<T, Format>::VectorIface(const std::string& vector_path, Vector<T>* vector)
     : path_(vector_path)
@@ -220,105 +488,542 @@ VectorIface<T, Format>::VectorIface(const std::string& vector_path, Vector<T>* v
 template <typename T, typename Format>
 bool VectorIface<T, Format>::Parse(const format_type& parser, const source_type* source, bool throw_on_fail)
 {
-    using elem_iface_type = detail::deduce_iface_t<T, Format>;
-
+    ParseProfiler::PathTimer path_timer(Path());
+    ParseBudget::DepthGuard depth_guard(format_type::name, Path());
     std::size_t index = 0;
     std::optional<Error> last_error;
-    while (true) {
-        T element;
-        bool elem_parsed = false;
-        elem_iface_type elem_iface(parser.VectorElementPath(Path(), index), &element);
-        try {
-            elem_parsed = elem_iface.Parse(parser, source, true);
-        } catch (const Error& ex) {
-            last_error = ex;
-            break;
-        }
-        // always stop on fail to prevent looping
-        if (!elem_parsed || last_error) {
-            break;
-        }
+    if (!ParseParallel(parser, source, &index, &last_error)) {
+        ParseContext context{this, &parser, source};
+        index = detail::parse_elements(&ParseElement, &context, &last_error);
+    }
+    return detail::complete_vector_parse(format_type::name, Path(), *vector_ptr_, index, last_error, throw_on_fail);
+}
 
-        // we are about to emplace first parsed value, vector should be empty-initialized to do so
-        if (!Initialized() || index == 0) {
-            vector_ptr_->value_ = std::vector<T>();
-        }
-        vector_ptr_->value_->emplace_back(std::move(element));
-        ++index;
+template <typename T, typename Format>
+void VectorIface<T, Format>::Emit(const format_type& emitter, dest_type* dest, bool throw_on_fail)
+{
+    std::vector<T>* elements = Initialized() ? &vector_ptr_->value_.value() : nullptr;
+    detail::EmitContext<T, Format> context{&emitter, dest, &Path(), elements, throw_on_fail};
+    detail::emit_elements(format_type::name, ElementPath(emitter, 0), *vector_ptr_, elements ? elements->size() : 0,
+                          &detail::emit_element<T, Format>, &context, throw_on_fail);
+}
+
+template <typename T, typename Format>
+const std::string& VectorIface<T, Format>::Path() const noexcept
+{
+    return path_;
+}
+
+template <typename T, typename Format>
+bool VectorIface<T, Format>::Initialized() const noexcept
+{
+    return vector_ptr_->Initialized();
+}
+
+template <typename T, typename Format>
+bool VectorIface<T, Format>::Optional() const noexcept
+{
+    return vector_ptr_->Optional();
+}
+
+template <typename T, typename Format>
+void VectorIface<T, Format>::Diff(const format_type& format, const Interface<Format>& other,
+                                  std::vector<Change>* changes) const
+{
+    const auto& peer = detail::diff_peer(*this, other);
+    detail::diff_vectors(format, Path(), Initialized() ? &vector_ptr_->Get() : nullptr,
+                         peer.Initialized() ? &peer.vector_ptr_->Get() : nullptr, changes);
+}
+
+template <typename T, typename Format>
+std::uint64_t VectorIface<T, Format>::Fingerprint(std::uint64_t hash) const
+{
+    if (!Initialized()) {
+        return detail::fingerprint_absent(hash);
     }
+    return detail::fingerprint_value<Format>(Path(), vector_ptr_->Get(), hash);
+}
 
-    if (!Initialized() && !Optional()) {
-        // notify that mandatory vector was not parsed
-        if (last_error) {
-            throw ParseError(last_error->what());
-        } else {
-            throw ParseError(format_type::name + " config '" + Path() + "' is not valid: vector is not set");
-        }
+template <typename T, typename Format>
+std::string VectorIface<T, Format>::ElementPath(const format_type& format, std::size_t index) const
+{
+    ParseProfiler::PhaseTimer timer(ParseProfiler::Phase::Path);
+    return format.VectorElementPath(Path(), index);
+}
+
+template <typename T, typename Format>
+bool VectorIface<T, Format>::ParseElement(void* context, std::size_t index)
+{
+    const auto& parse = *static_cast<ParseContext*>(context);
+    VectorIface<T, Format>& iface = *parse.iface;
+
+    T element;
+    detail::deduce_iface_t<T, Format> elem_iface(iface.ElementPath(*parse.parser, index), &element);
+    if (!elem_iface.Parse(*parse.parser, parse.source, true)) {
+        return false;
     }
+    ParseBudget::CheckVectorSize(format_type::name, iface.Path(), index + 1);
 
-    try {
-        vector_ptr_->Validate();
-    } catch (const Error& ex) {
-        if (throw_on_fail) {
-            throw ParseError(ex.what());
-        }
-    } catch (const std::exception& ex) {
-        if (throw_on_fail) {
-            throw ParseError(format_type::name + " config '" + Path() + "' is not valid: " + ex.what());
-        }
+    // we are about to emplace first parsed value, vector should be empty-initialized to do so
+    if (!iface.Initialized() || index == 0) {
+        iface.vector_ptr_->value_ = std::vector<T>();
     }
-    return index > 0;
+    iface.vector_ptr_->value_->emplace_back(std::move(element));
+    return true;
 }
 
 template <typename T, typename Format>
-void VectorIface<T, Format>::Emit(const format_type& emitter, dest_type* dest, bool throw_on_fail)
+bool VectorIface<T, Format>::ParseParallel(const format_type& parser, const source_type* source,
+                                           std::size_t* parsed_size, std::optional<Error>* error)
 {
-    using elem_iface_type = detail::deduce_iface_t<T, Format>;
+    if constexpr (!detail::has_vector_size<Format>::value) {
+        return false;
+    } else {
+        using elem_iface_type = detail::deduce_iface_t<T, Format>;
 
-    std::size_t index = 0;
-    while (true) {
-        T* elem = nullptr;
-        std::string elem_path = emitter.VectorElementPath(Path(), index);
+        const std::size_t max_threads = vector_ptr_->parallel_threads_;
+        const std::size_t min_chunk_size = std::max<std::size_t>(vector_ptr_->parallel_chunk_size_, 1);
+        if (max_threads < 2) {
+            return false;
+        }
+        const std::optional<std::size_t> size = parser.VectorSize(source, Path());
+        if (!size || *size < 2 * min_chunk_size) {
+            return false;
+        }
+        // check before allocating elements of the whole vector
+        ParseBudget::CheckVectorSize(format_type::name, Path(), *size);
 
-        try {
-            elem = &(*vector_ptr_)->at(index);
-        } catch (const Error& ex) {
-            if (!Optional() && throw_on_fail) {
-                throw EmitError(format_type::name + " config '" + elem_path + "' is not valid: " + ex.what());
+        const std::size_t threads = std::min(max_threads, *size / min_chunk_size);
+        const std::size_t chunk_size = (*size + threads - 1) / threads;
+
+        // first failed element of the chunk
+        struct Failure
+        {
+            std::size_t index;
+            std::optional<Error> error;
+            std::exception_ptr exception;
+        };
+        std::vector<T> elements(*size);
+        std::vector<Failure> failures(threads, Failure{*size, std::nullopt, nullptr});
+        std::atomic<std::size_t> first_failure{*size};
+
+        const ParseBudget::WorkerScope budget_scope;
+        InternPool* intern_pool = InternPool::Current();
+        KeyTracker* key_tracker = KeyTracker::Current();
+        // keys are marked per chunk, so workers do not contend on the tracker
+        std::vector<KeyTracker> chunk_trackers(key_tracker ? threads : 0);
+        Interpolation* interpolation = Interpolation::Current();
+        auto* format_state = detail::format_state_type<Format>::Current();
+        auto parse_chunk = [&](std::size_t chunk) {
+            budget_scope.Attach();
+            InternPool::Scope intern_scope(intern_pool);
+            KeyTracker::Scope tracker_scope(key_tracker ? &chunk_trackers[chunk] : nullptr);
+            Interpolation::Scope interpolation_scope(interpolation);
+            typename detail::format_state_type<Format>::Scope format_state_scope(format_state);
+            const std::size_t chunk_end = std::min(*size, (chunk + 1) * chunk_size);
+            for (std::size_t index = chunk * chunk_size; index < chunk_end; ++index) {
+                // elements after the failed one are dropped anyway
+                if (index > first_failure.load(std::memory_order_relaxed)) {
+                    return;
+                }
+
+                bool elem_parsed = false;
+                try {
+                    elem_iface_type elem_iface(ElementPath(parser, index), &elements[index]);
+                    elem_parsed = elem_iface.Parse(parser, source, true);
+                } catch (const BudgetError&) {
+                    // rethrown as is to keep the structure of the error
+                    failures[chunk].exception = std::current_exception();
+                } catch (const Error& ex) {
+                    failures[chunk].error = ex;
+                } catch (...) {
+                    failures[chunk].exception = std::current_exception();
+                }
+                if (!elem_parsed) {
+                    failures[chunk].index = index;
+                    std::size_t current = first_failure.load(std::memory_order_relaxed);
+                    while (index < current && !first_failure.compare_exchange_weak(current, index)) {
+                    }
+                    return;
+                }
             }
-            return;
-        } catch (const std::out_of_range& ex) {
-            if (!Optional() && throw_on_fail) {
-                throw EmitError(format_type::name + " config '" + elem_path + "' is not valid: variable is not set");
+        };
+
+        std::vector<std::thread> workers;
+        workers.reserve(threads - 1);
+        for (std::size_t chunk = 1; chunk < threads; ++chunk) {
+            try {
+                workers.emplace_back(parse_chunk, chunk);
+            } catch (const std::system_error&) {
+                // no more threads available, parse the chunk here
+                parse_chunk(chunk);
             }
-            return;
+        }
+        parse_chunk(0);
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        for (auto& chunk_tracker : chunk_trackers) {
+            key_tracker->Merge(chunk_tracker);
         }
 
-        elem_iface_type iface(elem_path, elem);
-        iface.Emit(emitter, dest, throw_on_fail);
+        // chunks are ordered, so the first failed chunk holds the first failed element
+        *parsed_size = *size;
+        for (auto& failure : failures) {
+            if (failure.index < *size) {
+                if (failure.exception) {
+                    std::rethrow_exception(failure.exception);
+                }
+                *parsed_size = failure.index;
+                *error = std::move(failure.error);
+                break;
+            }
+        }
 
-        if (++index >= (*vector_ptr_)->size()) {
-            return;
+        if (*parsed_size > 0) {
+            elements.resize(*parsed_size);
+            vector_ptr_->value_ = std::move(elements);
         }
+        return true;
     }
 }
 
 template <typename T, typename Format>
-const std::string& VectorIface<T, Format>::Path() const noexcept
+SharedVectorIface<T, Format>::SharedVectorIface(const std::string& vector_path, SharedVector<T>* vector)
+    : path_(vector_path)
+    , vector_ptr_(vector)
+{
+    if (!vector_ptr_) {
+        throw std::runtime_error("invalid list pointer to parse");
+    }
+}
+
+template <typename T, typename Format>
+bool SharedVectorIface<T, Format>::Parse(const format_type& parser, const source_type* source, bool throw_on_fail)
+{
+    detail::SubtreeMemo& memo = vector_ptr_->memo_;
+    std::optional<std::uint64_t> subtree_hash;
+    if constexpr (detail::has_subtree_hash<Format>::value) {
+        subtree_hash = parser.SubtreeHash(source, Path());
+        if (subtree_hash && Initialized() && !KeyTracker::Current() && !Interpolation::Current() &&
+            memo.format == &format_type::name && memo.hash == *subtree_hash) {
+            return memo.parsed;
+        }
+    }
+
+    // elements are parsed the same way as for the regular vector
+    Vector<T> parsed(Optional());
+    parsed.SetParallel(vector_ptr_->parallel_threads_, vector_ptr_->parallel_chunk_size_);
+    const bool vector_parsed = VectorIface<T, Format>(Path(), &parsed).Parse(parser, source, throw_on_fail);
+    if (!parsed.Initialized()) {
+        return vector_parsed;
+    }
+
+    memo = {};
+    bool unchanged = false;
+    if constexpr (detail::is_equality_comparable<T>::value) {
+        unchanged = Initialized() && vector_ptr_->Get() == *parsed;
+    }
+    if (!unchanged) {
+        vector_ptr_->value_ = std::make_shared<detail::SharedStorage<std::vector<T>>>(std::move(*parsed));
+    }
+
+    if (!detail::validate_object(format_type::name, Path(), *vector_ptr_, throw_on_fail)) {
+        return vector_parsed;
+    }
+
+    if (subtree_hash) {
+        memo = detail::SubtreeMemo{&format_type::name, *subtree_hash, vector_parsed};
+    }
+    return vector_parsed;
+}
+
+template <typename T, typename Format>
+void SharedVectorIface<T, Format>::Emit(const format_type& emitter, dest_type* dest, bool throw_on_fail)
+{
+    // elements are emitted the same way as for the regular vector, but in place: registration of the sections among
+    //  them is serialized with other uses of the storage
+    const auto locks = detail::lock_storages(vector_ptr_->value_.get());
+    std::vector<T>* elements = Initialized() ? &vector_ptr_->value_->value : nullptr;
+    detail::EmitContext<T, Format> context{&emitter, dest, &Path(), elements, throw_on_fail};
+    detail::emit_elements(format_type::name, emitter.VectorElementPath(Path(), 0), *vector_ptr_,
+                          elements ? elements->size() : 0, &detail::emit_element<T, Format>, &context, throw_on_fail);
+}
+
+template <typename T, typename Format>
+const std::string& SharedVectorIface<T, Format>::Path() const noexcept
 {
     return path_;
 }
 
 template <typename T, typename Format>
-bool VectorIface<T, Format>::Initialized() const noexcept
+bool SharedVectorIface<T, Format>::Initialized() const noexcept
 {
     return vector_ptr_->Initialized();
 }
 
 template <typename T, typename Format>
-bool VectorIface<T, Format>::Optional() const noexcept
+bool SharedVectorIface<T, Format>::Optional() const noexcept
 {
     return vector_ptr_->Optional();
 }
 
+template <typename T, typename Format>
+void SharedVectorIface<T, Format>::Diff(const format_type& format, const Interface<Format>& other,
+                                        std::vector<Change>* changes) const
+{
+    const auto& peer = detail::diff_peer(*this, other);
+    // copies of the vector share the storage
+    if (vector_ptr_->Storage() == peer.vector_ptr_->Storage()) {
+        return;
+    }
+    const auto locks = detail::lock_storages(vector_ptr_->value_.get(), peer.vector_ptr_->value_.get());
+    detail::diff_vectors(format, Path(), Initialized() ? &vector_ptr_->Get() : nullptr,
+                         peer.Initialized() ? &peer.vector_ptr_->Get() : nullptr, changes);
+}
+
+template <typename T, typename Format>
+std::uint64_t SharedVectorIface<T, Format>::Fingerprint(std::uint64_t hash) const
+{
+    if (!Initialized()) {
+        return detail::fingerprint_absent(hash);
+    }
+    if constexpr (detail::is_base_of_template<T, Config>::value) {
+        if (vector_ptr_->value_->modified) {
+            // fingerprints cached by the sections do not account modifications, copies do not have them
+            return detail::fingerprint_value<Format>(Path(), std::vector<T>(vector_ptr_->Get()), hash);
+        }
+    }
+    const auto locks = detail::lock_storages(vector_ptr_->value_.get());
+    return detail::fingerprint_value<Format>(Path(), vector_ptr_->Get(), hash);
+}
+
+template <typename C, typename Format>
+SharedSectionIface<C, Format>::SharedSectionIface(const std::string& section_path, SharedSection<C>* section)
+    : path_(section_path)
+    , section_ptr_(section)
+{
+    if (!section_ptr_) {
+        throw std::runtime_error("invalid section pointer to parse");
+    }
+}
+
+template <typename C, typename Format>
+bool SharedSectionIface<C, Format>::Parse(const format_type& parser, const source_type* source, bool throw_on_fail)
+{
+    detail::SubtreeMemo& memo = section_ptr_->memo_;
+    std::optional<std::uint64_t> subtree_hash;
+    if constexpr (detail::has_subtree_hash<Format>::value) {
+        subtree_hash = parser.SubtreeHash(source, Path());
+        if (subtree_hash && Initialized() && !KeyTracker::Current() && !Interpolation::Current() &&
+            memo.format == &format_type::name && memo.hash == *subtree_hash) {
+            return memo.parsed;
+        }
+    }
+
+    // stored section may be shared with other configs, so it is never modified in place
+    auto parsed = std::make_shared<detail::SharedStorage<C>>(section_ptr_->Get());
+    try {
+        if (!typename C::template iface_type<Format>(Path(), &parsed->value).Parse(parser, source, throw_on_fail)) {
+            return false;
+        }
+    } catch (const BudgetError&) {
+        throw;
+    } catch (const Error&) {
+        if (!Optional() && throw_on_fail) {
+            throw;
+        }
+        return false;
+    }
+
+    section_ptr_->value_ = std::move(parsed);
+    section_ptr_->initialized_ = true;
+    memo = {};
+    // errors are swallowed without throw_on_fail, so such parses are not memoized
+    if (subtree_hash && throw_on_fail) {
+        memo = detail::SubtreeMemo{&format_type::name, *subtree_hash, true};
+    }
+    return true;
+}
+
+template <typename C, typename Format>
+void SharedSectionIface<C, Format>::Emit(const format_type& emitter, dest_type* dest, bool throw_on_fail)
+{
+    // registration of the stored section is serialized with other uses of the storage
+    const auto locks = detail::lock_storages(section_ptr_->value_.get());
+    try {
+        C* stored = &section_ptr_->value_->value;
+        typename C::template iface_type<Format>(Path(), stored).Emit(emitter, dest, throw_on_fail);
+    } catch (const Error& ex) {
+        if (!Optional() && throw_on_fail) {
+            throw EmitError(ex.what());
+        }
+    }
+}
+
+template <typename C, typename Format>
+const std::string& SharedSectionIface<C, Format>::Path() const noexcept
+{
+    return path_;
+}
+
+template <typename C, typename Format>
+bool SharedSectionIface<C, Format>::Initialized() const noexcept
+{
+    return section_ptr_->Initialized();
+}
+
+template <typename C, typename Format>
+bool SharedSectionIface<C, Format>::Optional() const noexcept
+{
+    return section_ptr_->Optional();
+}
+
+template <typename C, typename Format>
+void SharedSectionIface<C, Format>::Diff(const format_type& format, const Interface<Format>& other,
+                                         std::vector<Change>* changes) const
+{
+    const auto& peer = detail::diff_peer(*this, other);
+    // copies of the section share the storage
+    if (section_ptr_->Storage() == peer.section_ptr_->Storage()) {
+        return;
+    }
+    const auto locks = detail::lock_storages(section_ptr_->value_.get(), peer.section_ptr_->value_.get());
+    detail::diff_values(format, Path(), Initialized() ? &section_ptr_->Get() : nullptr,
+                        peer.Initialized() ? &peer.section_ptr_->Get() : nullptr, changes);
+}
+
+template <typename C, typename Format>
+std::uint64_t SharedSectionIface<C, Format>::Fingerprint(std::uint64_t hash) const
+{
+    if (!Initialized()) {
+        return detail::fingerprint_absent(hash);
+    }
+    if (section_ptr_->value_->modified) {
+        // fingerprints cached by the section do not account modifications, a copy does not have them
+        return detail::fingerprint_value<Format>(Path(), C(section_ptr_->Get()), hash);
+    }
+    const auto locks = detail::lock_storages(section_ptr_->value_.get());
+    return detail::fingerprint_value<Format>(Path(), section_ptr_->Get(), hash);
+}
+
+template <typename C, typename Format>
+LazyConfigIface<C, Format>::LazyConfigIface(const std::string& section_path, LazyConfig<C>* section)
+    : path_(section_path)
+    , lazy_ptr_(section)
+{
+    if (!lazy_ptr_) {
+        throw std::runtime_error("invalid section pointer to parse");
+    }
+}
+
+template <typename C, typename Format>
+bool LazyConfigIface<C, Format>::Parse(const format_type& parser, const source_type* source, bool throw_on_fail)
+{
+    using section_iface_type = typename C::template iface_type<Format>;
+
+    auto state = std::make_shared<typename LazyConfig<C>::State>(*lazy_ptr_->init_value_);
+    // strict parse has to see all the keys consumed by the section, interpolation has to see the whole source
+    if constexpr (detail::has_capture<Format>::value) {
+        if (!KeyTracker::Current() && !Interpolation::Current()) {
+            // errors of the deferred parse are thrown by Load(), whatever throw_on_fail of the recording parse is
+            state->parse = [parser, captured = parser.Capture(source, Path()), path = Path(),
+                            optional = Optional(), init_value = lazy_ptr_->init_value_](C* section) {
+                // deferred parse is a parse of its' own
+                const detail::FormatStateScope<Format> format_state_scope(parser);
+                try {
+                    section_iface_type(path, section).Parse(parser, captured.get(), true);
+                } catch (const Error&) {
+                    if (!optional) {
+                        throw;
+                    }
+                    // optional section falls back to its' initial value
+                    *section = *init_value;
+                }
+            };
+            lazy_ptr_->state_ = std::move(state);
+            return true;
+        }
+    }
+
+    // formats without Capture() are parsed eagerly, as the source is not guaranteed to outlive the parse
+    bool section_parsed = false;
+    try {
+        section_parsed = section_iface_type(Path(), &state->value).Parse(parser, source, true);
+    } catch (const BudgetError&) {
+        throw;
+    } catch (const Error&) {
+        if (!Optional() && throw_on_fail) {
+            throw;
+        }
+        // failure is thrown by the access instead of handing out partially parsed section
+        if (Optional()) {
+            state->value = *lazy_ptr_->init_value_;
+        } else {
+            state->error = std::current_exception();
+        }
+    }
+    state->loaded = true;
+    lazy_ptr_->state_ = std::move(state);
+    return section_parsed;
+}
+
+template <typename C, typename Format>
+void LazyConfigIface<C, Format>::Emit(const format_type& emitter, dest_type* dest, bool throw_on_fail)
+{
+    try {
+        // emitting initializes the section, so a copy is emitted instead of the shared one
+        C emitted(lazy_ptr_->Get());
+        typename C::template iface_type<Format>(Path(), &emitted).Emit(emitter, dest, throw_on_fail);
+    } catch (const Error& ex) {
+        if (!Optional() && throw_on_fail) {
+            throw EmitError(ex.what());
+        }
+    }
+}
+
+template <typename C, typename Format>
+const std::string& LazyConfigIface<C, Format>::Path() const noexcept
+{
+    return path_;
+}
+
+template <typename C, typename Format>
+bool LazyConfigIface<C, Format>::Initialized() const noexcept
+{
+    return lazy_ptr_->Initialized();
+}
+
+template <typename C, typename Format>
+bool LazyConfigIface<C, Format>::Optional() const noexcept
+{
+    return lazy_ptr_->Optional();
+}
+
+template <typename C, typename Format>
+void LazyConfigIface<C, Format>::Diff(const format_type& format, const Interface<Format>& other,
+                                      std::vector<Change>* changes) const
+{
+    const auto& peer = detail::diff_peer(*this, other);
+    // copies of the section share the parsed one
+    if (lazy_ptr_->state_ == peer.lazy_ptr_->state_) {
+        return;
+    }
+    // comparing registers elements of the sections, so copies are compared instead of the shared ones
+    const C before(lazy_ptr_->Get());
+    const C after(peer.lazy_ptr_->Get());
+    detail::diff_values(format, Path(), Initialized() ? &before : nullptr, peer.Initialized() ? &after : nullptr,
+                        changes);
+}
+
+template <typename C, typename Format>
+std::uint64_t LazyConfigIface<C, Format>::Fingerprint(std::uint64_t hash) const
+{
+    if (!Initialized()) {
+        return detail::fingerprint_absent(hash);
+    }
+    // hashing registers elements of the section, so a copy is hashed instead of the shared one
+    return detail::fingerprint_value<Format>(Path(), C(lazy_ptr_->Get()), hash);
+}
+
 } // namespace uconfig
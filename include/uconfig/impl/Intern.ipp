@@ -0,0 +1,141 @@
+#pragma once
+
+namespace uconfig {
+
+inline InternedString::InternedString() noexcept
+{
+    static const auto empty = std::make_shared<const std::string>();
+    value_ = empty;
+}
+
+inline InternedString::InternedString(std::string value)
+    : value_(std::make_shared<const std::string>(std::move(value)))
+{
+}
+
+inline InternedString::InternedString(std::shared_ptr<const std::string> value) noexcept
+    : value_(std::move(value))
+{
+}
+
+inline const std::string& InternedString::Get() const noexcept
+{
+    return *value_;
+}
+
+inline InternedString::operator const std::string&() const noexcept
+{
+    return *value_;
+}
+
+inline InternedString::operator std::string_view() const noexcept
+{
+    return *value_;
+}
+
+inline bool operator==(const InternedString& lhs, const InternedString& rhs) noexcept
+{
+    return lhs.value_ == rhs.value_ || *lhs.value_ == *rhs.value_;
+}
+
+inline bool operator!=(const InternedString& lhs, const InternedString& rhs) noexcept
+{
+    return !(lhs == rhs);
+}
+
+inline bool operator<(const InternedString& lhs, const InternedString& rhs) noexcept
+{
+    return lhs.value_ != rhs.value_ && *lhs.value_ < *rhs.value_;
+}
+
+inline bool operator==(const InternedString& lhs, std::string_view rhs) noexcept
+{
+    return std::string_view(*lhs.value_) == rhs;
+}
+
+inline bool operator==(std::string_view lhs, const InternedString& rhs) noexcept
+{
+    return rhs == lhs;
+}
+
+inline bool operator!=(const InternedString& lhs, std::string_view rhs) noexcept
+{
+    return !(lhs == rhs);
+}
+
+inline bool operator!=(std::string_view lhs, const InternedString& rhs) noexcept
+{
+    return !(rhs == lhs);
+}
+
+inline std::ostream& operator<<(std::ostream& out, const InternedString& value)
+{
+    return out << value.Get();
+}
+
+inline std::shared_ptr<InternPool> InternPool::Create()
+{
+    return std::shared_ptr<InternPool>(new InternPool());
+}
+
+inline InternedString InternPool::Intern(std::string_view value)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(value);
+    if (it == index_.end()) {
+        // deque never moves stored strings, so views into them stay valid
+        const std::string& stored = storage_.emplace_back(value);
+        it = index_.emplace(stored, &stored).first;
+        bytes_ += stored.size();
+    }
+    // aliasing constructor, the string keeps the whole pool alive
+    return InternedString(std::shared_ptr<const std::string>(shared_from_this(), it->second));
+}
+
+inline std::size_t InternPool::Size() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return storage_.size();
+}
+
+inline std::size_t InternPool::Bytes() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return bytes_;
+}
+
+inline InternPool* InternPool::Current() noexcept
+{
+    return CurrentRef();
+}
+
+inline InternPool::Scope::Scope(InternPool* pool) noexcept
+    : previous_(CurrentRef())
+{
+    if (pool) {
+        CurrentRef() = pool;
+    }
+}
+
+inline InternPool::Scope::~Scope()
+{
+    CurrentRef() = previous_;
+}
+
+inline InternPool*& InternPool::CurrentRef() noexcept
+{
+    static thread_local InternPool* pool = nullptr;
+    return pool;
+}
+
+namespace detail {
+
+inline InternedString intern(std::string_view value)
+{
+    InternPool* pool = InternPool::Current();
+    return pool ? pool->Intern(value) : InternedString(std::string(value));
+}
+
+} // namespace detail
+
+} // namespace uconfig
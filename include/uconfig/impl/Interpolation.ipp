@@ -0,0 +1,180 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+#include <sstream>
+
+namespace uconfig {
+
+template <typename F>
+std::optional<std::string> Interpolation::Resolve(const F& parser, const typename F::source_type* source,
+                                                  const std::string& path)
+{
+    std::vector<std::string> chain;
+    return Resolve(parser, source, path, chain);
+}
+
+template <typename F>
+std::optional<std::string> Interpolation::Resolve(const F& parser, const typename F::source_type* source,
+                                                  const std::string& path, std::vector<std::string>& chain)
+{
+    std::optional<std::string> resolved;
+    if (Find(path, &resolved)) {
+        return resolved;
+    }
+
+    if (std::find(chain.begin(), chain.end(), path) != chain.end()) {
+        std::string cycle;
+        for (auto chain_it = std::find(chain.begin(), chain.end(), path); chain_it != chain.end(); ++chain_it) {
+            cycle += "'" + *chain_it + "' -> ";
+        }
+        detail::throw_interpolation_error(F::name, path, "reference cycle " + cycle + "'" + path + "'");
+    }
+
+    const std::optional<std::string> value = detail::parse_value<std::string>(parser, source, path);
+    if (value) {
+        chain.push_back(path);
+        resolved = Expand(parser, source, *value, chain);
+        chain.pop_back();
+    }
+    Store(path, resolved);
+    return resolved;
+}
+
+template <typename F>
+std::optional<std::string> Interpolation::ResolveReference(const F& parser, const typename F::source_type* source,
+                                                           const std::string& path, std::vector<std::string>& chain)
+{
+    if (std::optional<std::string> value = Resolve(parser, source, path, chain)) {
+        return value;
+    }
+
+    // scalars of other types are substituted as printed
+    if (const std::optional<long> value = parser.template Parse<long>(source, path)) {
+        return std::to_string(*value);
+    }
+    if (const std::optional<double> value = parser.template Parse<double>(source, path)) {
+        std::ostringstream printed;
+        printed.precision(std::numeric_limits<double>::max_digits10 - 1);
+        printed << *value;
+        return printed.str();
+    }
+    if (const std::optional<bool> value = parser.template Parse<bool>(source, path)) {
+        return *value ? "true" : "false";
+    }
+    return std::nullopt;
+}
+
+template <typename F>
+std::string Interpolation::Expand(const F& parser, const typename F::source_type* source, std::string_view value,
+                                  std::vector<std::string>& chain)
+{
+    static constexpr std::string_view kEnvPrefix = "env:";
+
+    std::string expanded;
+    std::size_t position = 0;
+    while (true) {
+        const std::size_t placeholder = value.find("${", position);
+        if (placeholder == std::string_view::npos) {
+            break;
+        }
+        // "$${" is an escaped "${"
+        if (placeholder > 0 && value[placeholder - 1] == '$') {
+            expanded.append(value.substr(position, placeholder - 1 - position));
+            expanded.append("${");
+            position = placeholder + 2;
+            continue;
+        }
+        expanded.append(value.substr(position, placeholder - position));
+
+        const std::size_t placeholder_end = value.find('}', placeholder);
+        if (placeholder_end == std::string_view::npos) {
+            detail::throw_interpolation_error(F::name, chain.back(), "unterminated placeholder");
+        }
+        const std::string reference(value.substr(placeholder + 2, placeholder_end - placeholder - 2));
+        position = placeholder_end + 1;
+
+        if (reference.compare(0, kEnvPrefix.size(), kEnvPrefix) == 0) {
+            const std::string name = reference.substr(kEnvPrefix.size());
+            const char* env_var = std::getenv(name.c_str());
+            if (!env_var) {
+                detail::throw_interpolation_error(F::name, chain.back(),
+                                                  "environment variable '" + name + "' is not set");
+            }
+            expanded.append(env_var);
+            continue;
+        }
+
+        std::string reference_path = reference;
+        if constexpr (detail::has_reference_path<F>::value) {
+            reference_path = parser.ReferencePath(reference);
+        }
+        const std::optional<std::string> referenced = ResolveReference(parser, source, reference_path, chain);
+        if (!referenced) {
+            detail::throw_interpolation_error(F::name, chain.back(), "unresolved reference '" + reference + "'");
+        }
+        expanded.append(*referenced);
+    }
+    expanded.append(value.substr(position));
+    return expanded;
+}
+
+inline std::size_t Interpolation::Size() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return resolved_.size();
+}
+
+inline bool Interpolation::Find(const std::string& path, std::optional<std::string>* value) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto resolved_it = resolved_.find(path);
+    if (resolved_it == resolved_.end()) {
+        return false;
+    }
+    *value = resolved_it->second;
+    return true;
+}
+
+inline void Interpolation::Store(const std::string& path, const std::optional<std::string>& value)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    resolved_.emplace(path, value);
+}
+
+inline Interpolation* Interpolation::Current() noexcept
+{
+    return CurrentRef();
+}
+
+inline Interpolation::Scope::Scope(Interpolation* interpolation) noexcept
+    : previous_(CurrentRef())
+{
+    if (interpolation) {
+        CurrentRef() = interpolation;
+    }
+}
+
+inline Interpolation::Scope::~Scope()
+{
+    CurrentRef() = previous_;
+}
+
+inline Interpolation*& Interpolation::CurrentRef() noexcept
+{
+    static thread_local Interpolation* interpolation = nullptr;
+    return interpolation;
+}
+
+namespace detail {
+
+inline void throw_interpolation_error(const std::string& format_name, const std::string& path,
+                                      const std::string& reason)
+{
+    throw ParseError(format_name + " config '" + path + "' is not valid: " + reason);
+}
+
+} // namespace detail
+
+} // namespace uconfig
@@ -0,0 +1,489 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#ifdef UCONFIG_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+namespace uconfig {
+namespace detail {
+
+#ifdef UCONFIG_IO_URING
+
+inline IoUring::~IoUring()
+{
+    Reset();
+}
+
+inline int IoUring::Setup(unsigned entries) noexcept
+{
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    const long fd = ::syscall(__NR_io_uring_setup, entries, &params);
+    if (fd < 0) {
+        return errno;
+    }
+    fd_ = static_cast<int>(fd);
+
+    sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single_mmap) {
+        sq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+        cq_ring_size_ = 0;
+    }
+
+    auto map = [this](std::size_t size, off_t offset) -> void* {
+        void* mapping = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, offset);
+        return mapping == MAP_FAILED ? nullptr : mapping;
+    };
+    sq_ring_ = map(sq_ring_size_, IORING_OFF_SQ_RING);
+    cq_ring_ = single_mmap ? sq_ring_ : map(cq_ring_size_, IORING_OFF_CQ_RING);
+    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    sqes_ = map(sqes_size_, IORING_OFF_SQES);
+    if (!sq_ring_ || !cq_ring_ || !sqes_) {
+        const int error = errno;
+        Reset();
+        return error;
+    }
+
+    char* sq_ring = static_cast<char*>(sq_ring_);
+    char* cq_ring = static_cast<char*>(cq_ring_);
+    sq_head_ = reinterpret_cast<unsigned*>(sq_ring + params.sq_off.head);
+    sq_tail_ = reinterpret_cast<unsigned*>(sq_ring + params.sq_off.tail);
+    sq_mask_ = reinterpret_cast<unsigned*>(sq_ring + params.sq_off.ring_mask);
+    sq_array_ = reinterpret_cast<unsigned*>(sq_ring + params.sq_off.array);
+    cq_head_ = reinterpret_cast<unsigned*>(cq_ring + params.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned*>(cq_ring + params.cq_off.tail);
+    cq_mask_ = reinterpret_cast<unsigned*>(cq_ring + params.cq_off.ring_mask);
+    cqes_ = cq_ring + params.cq_off.cqes;
+    entries_ = params.sq_entries;
+    queued_ = 0;
+    return 0;
+}
+
+inline unsigned IoUring::Capacity() const noexcept
+{
+    return entries_;
+}
+
+inline void IoUring::PushRead(int fd, const void* iov, std::uint64_t offset, std::uint64_t user_data) noexcept
+{
+    // the ring is written by this thread only, kernel reads it on io_uring_enter
+    const unsigned tail = *sq_tail_;
+    const unsigned index = tail & *sq_mask_;
+    io_uring_sqe* sqe = static_cast<io_uring_sqe*>(sqes_) + index;
+    std::memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = IORING_OP_READV;
+    sqe->fd = fd;
+    sqe->addr = reinterpret_cast<std::uint64_t>(iov);
+    sqe->len = 1;
+    sqe->off = offset;
+    sqe->user_data = user_data;
+    sq_array_[index] = index;
+    __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+    ++queued_;
+}
+
+inline int IoUring::Enter(unsigned min_complete) noexcept
+{
+    while (true) {
+        const long submitted = ::syscall(__NR_io_uring_enter, fd_, queued_, min_complete, IORING_ENTER_GETEVENTS,
+                                         nullptr, 0);
+        if (submitted >= 0) {
+            queued_ -= std::min<unsigned>(queued_, static_cast<unsigned>(submitted));
+            return 0;
+        }
+        if (errno != EINTR && errno != EAGAIN) {
+            return errno;
+        }
+    }
+}
+
+inline int IoUring::Wait(unsigned min_complete) noexcept
+{
+    while (true) {
+        if (::syscall(__NR_io_uring_enter, fd_, 0, min_complete, IORING_ENTER_GETEVENTS, nullptr, 0) >= 0) {
+            return 0;
+        }
+        if (errno != EINTR && errno != EAGAIN) {
+            return errno;
+        }
+    }
+}
+
+inline bool IoUring::PopCompletion(std::uint64_t* user_data, int* result) noexcept
+{
+    const unsigned head = *cq_head_;
+    if (head == __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE)) {
+        return false;
+    }
+
+    const io_uring_cqe* cqe = static_cast<const io_uring_cqe*>(cqes_) + (head & *cq_mask_);
+    *user_data = cqe->user_data;
+    *result = cqe->res;
+    __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+inline unsigned IoUring::Queued() const noexcept
+{
+    return queued_;
+}
+
+inline void IoUring::Reset() noexcept
+{
+    if (sqes_) {
+        ::munmap(sqes_, sqes_size_);
+    }
+    if (cq_ring_ && cq_ring_ != sq_ring_) {
+        ::munmap(cq_ring_, cq_ring_size_);
+    }
+    if (sq_ring_) {
+        ::munmap(sq_ring_, sq_ring_size_);
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+    fd_ = -1;
+    sq_ring_ = cq_ring_ = sqes_ = nullptr;
+    entries_ = queued_ = 0;
+}
+
+#endif
+
+} // namespace detail
+
+inline FileLoader::FileLoader(Backend backend, std::size_t queue_depth, std::size_t threads)
+    : backend_(Backend::Threads)
+    , queue_depth_(std::max<std::size_t>(queue_depth, 1))
+    , threads_(std::max<std::size_t>(threads, 1))
+{
+    if (backend == Backend::Threads) {
+        return;
+    }
+
+#ifdef UCONFIG_IO_URING
+    // io_uring may be disabled by the kernel or seccomp, then threads are used
+    const int error = ring_.Setup(static_cast<unsigned>(std::min<std::size_t>(queue_depth_, 4096)));
+    if (!error) {
+        backend_ = Backend::IoUring;
+        return;
+    }
+#else
+    const int error = ENOSYS;
+#endif
+    if (backend == Backend::IoUring) {
+        throw Error(name + " io_uring is not available: " + std::strerror(error));
+    }
+}
+
+inline void FileLoader::Load(const std::vector<std::string>& paths, const Handler& handler)
+{
+    if (paths.empty()) {
+        return;
+    }
+
+#ifdef UCONFIG_IO_URING
+    if (backend_ == Backend::IoUring) {
+        LoadIoUring(paths, handler);
+        return;
+    }
+#endif
+    LoadThreads(paths, handler);
+}
+
+inline std::vector<std::string> FileLoader::Load(const std::vector<std::string>& paths)
+{
+    std::vector<std::string> contents(paths.size());
+    Load(paths, [&contents](std::size_t index, std::string&& file_contents) {
+        contents[index] = std::move(file_contents);
+    });
+    return contents;
+}
+
+inline FileLoader::Backend FileLoader::Used() const noexcept
+{
+    return backend_;
+}
+
+#ifdef UCONFIG_IO_URING
+
+inline void FileLoader::LoadIoUring(const std::vector<std::string>& paths, const Handler& handler)
+{
+    struct Request
+    {
+        int fd = -1;
+        std::string buffer;
+        std::size_t offset = 0;
+        // size of regular files is known up front, others are read until EOF
+        bool sized = false;
+        iovec iov;
+    };
+    // requests are not released while the kernel may read into their buffers, see AbortIoUring()
+    auto requests_storage = std::make_unique<std::vector<Request>>(paths.size());
+    std::vector<Request>& requests = *requests_storage;
+    std::exception_ptr failure;
+
+    auto submit = [this, &requests](std::size_t index) {
+        Request& request = requests[index];
+        request.iov.iov_base = request.buffer.data() + request.offset;
+        request.iov.iov_len = request.buffer.size() - request.offset;
+        ring_.PushRead(request.fd, &request.iov, request.offset, index);
+    };
+
+    std::size_t next = 0;
+    std::size_t in_flight = 0;
+    try {
+        while (true) {
+            while (!failure && next < paths.size() && in_flight < ring_.Capacity()) {
+                Request& request = requests[next];
+                request.fd = ::open(paths[next].c_str(), O_RDONLY | O_CLOEXEC);
+                struct stat file_stat;
+                if (request.fd < 0 || ::fstat(request.fd, &file_stat) != 0) {
+                    failure = std::make_exception_ptr(ReadError(paths[next], errno));
+                    if (request.fd >= 0) {
+                        ::close(request.fd);
+                        request.fd = -1;
+                    }
+                    break;
+                }
+
+                request.sized = S_ISREG(file_stat.st_mode) && file_stat.st_size > 0;
+                request.buffer.resize(request.sized ? static_cast<std::size_t>(file_stat.st_size) : 4096);
+                submit(next++);
+                ++in_flight;
+            }
+            if (in_flight == 0) {
+                break;
+            }
+
+            if (const int error = ring_.Enter(1)) {
+                throw Error(name + " io_uring failed: " + std::strerror(error));
+            }
+
+            // hand every completed file to the handler while the rest are still read by the kernel
+            std::uint64_t index = 0;
+            int result = 0;
+            while (ring_.PopCompletion(&index, &result)) {
+                --in_flight;
+                Request& request = requests[index];
+                if (result == -EINTR || result == -EAGAIN) {
+                    submit(index);
+                    ++in_flight;
+                    continue;
+                }
+
+                if (result > 0) {
+                    request.offset += static_cast<std::size_t>(result);
+                    const bool full = request.offset == request.buffer.size();
+                    if (!failure && !(request.sized && full)) {
+                        if (full) {
+                            request.buffer.resize(request.buffer.size() * 2);
+                        }
+                        submit(index);
+                        ++in_flight;
+                        continue;
+                    }
+                }
+
+                ::close(request.fd);
+                request.fd = -1;
+                if (result < 0 && !failure) {
+                    failure = std::make_exception_ptr(ReadError(paths[index], -result));
+                }
+                if (failure) {
+                    continue;
+                }
+
+                request.buffer.resize(request.offset);
+                try {
+                    handler(index, std::move(request.buffer));
+                } catch (...) {
+                    failure = std::current_exception();
+                }
+                request.buffer = std::string();
+            }
+        }
+    } catch (...) {
+        if (!AbortIoUring(in_flight)) {
+            // kernel may still complete into the buffers, they are leaked rather than overwritten after release
+            requests_storage.release();
+        }
+        for (auto& request : requests) {
+            if (request.fd >= 0) {
+                ::close(request.fd);
+            }
+        }
+        throw;
+    }
+
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+}
+
+inline bool FileLoader::AbortIoUring(std::size_t in_flight) noexcept
+{
+    // queued requests are dropped with the ring, submitted ones write into the buffers until they complete
+    std::size_t submitted = in_flight - std::min<std::size_t>(in_flight, ring_.Queued());
+    std::uint64_t index = 0;
+    int result = 0;
+    while (submitted > 0) {
+        if (ring_.PopCompletion(&index, &result)) {
+            --submitted;
+        } else if (ring_.Wait(1) != 0) {
+            break;
+        }
+    }
+
+    // the ring may be left unusable by the failure, so it is set up anew
+    const unsigned entries = ring_.Capacity();
+    ring_.Reset();
+    if (ring_.Setup(entries) != 0) {
+        backend_ = Backend::Threads;
+    }
+    return submitted == 0;
+}
+
+#else
+
+inline void FileLoader::LoadIoUring(const std::vector<std::string>& paths, const Handler& handler)
+{
+    LoadThreads(paths, handler);
+}
+
+#endif
+
+inline void FileLoader::LoadThreads(const std::vector<std::string>& paths, const Handler& handler)
+{
+    struct Loaded
+    {
+        std::size_t index;
+        int error;
+        std::string contents;
+    };
+    std::mutex mutex;
+    std::condition_variable loaded_cv;
+    std::deque<Loaded> loaded;
+    std::atomic<std::size_t> next{0};
+    std::atomic<bool> stop{false};
+
+    auto read_files = [&]() {
+        while (!stop.load(std::memory_order_relaxed)) {
+            const std::size_t index = next.fetch_add(1, std::memory_order_relaxed);
+            if (index >= paths.size()) {
+                return;
+            }
+
+            Loaded file{index, 0, {}};
+            try {
+                file.error = ReadFile(paths[index], &file.contents);
+            } catch (const std::bad_alloc&) {
+                file.error = ENOMEM;
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            loaded.push_back(std::move(file));
+            loaded_cv.notify_one();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    const std::size_t threads = std::min(threads_, paths.size());
+    workers.reserve(threads);
+    for (std::size_t worker = 0; worker < threads; ++worker) {
+        try {
+            workers.emplace_back(read_files);
+        } catch (const std::system_error&) {
+            break;
+        }
+    }
+    if (workers.empty()) {
+        read_files();
+    }
+
+    std::exception_ptr failure;
+    for (std::size_t handled = 0; handled < paths.size() && !failure; ++handled) {
+        Loaded file;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            loaded_cv.wait(lock, [&loaded]() { return !loaded.empty(); });
+            file = std::move(loaded.front());
+            loaded.pop_front();
+        }
+
+        try {
+            if (file.error) {
+                throw ReadError(paths[file.index], file.error);
+            }
+            handler(file.index, std::move(file.contents));
+        } catch (...) {
+            failure = std::current_exception();
+        }
+    }
+
+    stop.store(true, std::memory_order_relaxed);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+}
+
+inline int FileLoader::ReadFile(const std::string& path, std::string* contents)
+{
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return errno;
+    }
+
+    struct stat file_stat;
+    if (::fstat(fd, &file_stat) == 0 && S_ISREG(file_stat.st_mode)) {
+        contents->reserve(static_cast<std::size_t>(file_stat.st_size));
+    }
+
+    char chunk[4096];
+    while (true) {
+        const ssize_t bytes = ::read(fd, chunk, sizeof(chunk));
+        if (bytes == 0) {
+            break;
+        }
+        if (bytes < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            const int error = errno;
+            ::close(fd);
+            return error;
+        }
+        contents->append(chunk, static_cast<std::size_t>(bytes));
+    }
+    ::close(fd);
+    return 0;
+}
+
+inline ParseError FileLoader::ReadError(const std::string& path, int error)
+{
+    return ParseError(name + " '" + path + "' failed to be read: " + std::strerror(error));
+}
+
+} // namespace uconfig
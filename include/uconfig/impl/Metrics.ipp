@@ -0,0 +1,272 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <thread>
+
+#if __has_include(<cxxabi.h>)
+#include <cxxabi.h>
+#endif
+
+namespace uconfig {
+namespace detail {
+
+inline ParseObserver::ParseObserver(const std::type_info& type, const std::string& format) noexcept
+    : series_(ParseMetrics::Global().Series(type, format))
+    , start_(std::chrono::steady_clock::now())
+{
+}
+
+inline ParseObserver::~ParseObserver()
+{
+    ParseMetrics::Observe(series_, std::chrono::steady_clock::now() - start_, failed_);
+}
+
+inline bool ParseObserver::Complete(bool parsed) noexcept
+{
+    failed_ = !parsed;
+    return parsed;
+}
+
+/// Appender into a fixed buffer, counting the length of the whole output.
+class MetricsWriter
+{
+public:
+    MetricsWriter(char* buffer, std::size_t size) noexcept
+        : buffer_(buffer)
+        , size_(size)
+    {
+        if (size_ > 0) {
+            buffer_[0] = '\0';
+        }
+    }
+
+    /// Append formatted string.
+    void Print(const char* format, ...) noexcept
+    {
+        std::va_list args;
+        va_start(args, format);
+        const bool fits = length_ < size_;
+        const int printed = std::vsnprintf(fits ? buffer_ + length_ : nullptr, fits ? size_ - length_ : 0, format,
+                                           args);
+        va_end(args);
+        if (printed > 0) {
+            length_ += static_cast<std::size_t>(printed);
+        }
+    }
+
+    /// Append a character.
+    void Put(char symbol) noexcept
+    {
+        if (length_ + 1 < size_) {
+            buffer_[length_] = symbol;
+            buffer_[length_ + 1] = '\0';
+        }
+        ++length_;
+    }
+
+    /// Append label value with `\`, `"` and newline escaped.
+    void PutLabel(const char* value, std::size_t value_size) noexcept
+    {
+        for (std::size_t index = 0; index < value_size && value[index]; ++index) {
+            const char symbol = value[index];
+            if (symbol == '\\' || symbol == '"') {
+                Put('\\');
+                Put(symbol);
+            } else if (symbol == '\n') {
+                Put('\\');
+                Put('n');
+            } else {
+                Put(symbol);
+            }
+        }
+    }
+
+    /// Append labels of the @p series with an optional extra label.
+    void PutLabels(const MetricSeries& series, const char* extra = nullptr) noexcept
+    {
+        // format names are bracketed, e.g. "[JSON]"
+        const std::string& format = *series.format;
+        const bool bracketed = format.size() >= 2 && format.front() == '[' && format.back() == ']';
+
+        Print("{config=\"");
+        PutLabel(series.type_name, sizeof(series.type_name));
+        Print("\",format=\"");
+        PutLabel(format.data() + (bracketed ? 1 : 0), format.size() - (bracketed ? 2 : 0));
+        Put('"');
+        if (extra) {
+            Print(",%s", extra);
+        }
+        Put('}');
+    }
+
+    /// Length of the whole output.
+    std::size_t Length() const noexcept
+    {
+        return length_;
+    }
+
+private:
+    char* buffer_;
+    std::size_t size_;
+    std::size_t length_ = 0;
+};
+
+} // namespace detail
+
+inline ParseMetrics& ParseMetrics::Global() noexcept
+{
+    static ParseMetrics metrics;
+    return metrics;
+}
+
+inline detail::MetricSeries* ParseMetrics::Series(const std::type_info& type, const std::string& format) noexcept
+{
+    using detail::MetricSeries;
+
+    // open addressing, series are never removed
+    const std::size_t hash = type.hash_code() ^ (std::hash<const void*>{}(&format) << 1);
+    for (std::size_t probe = 0; probe < kCapacity; ++probe) {
+        MetricSeries& series = series_[(hash + probe) % kCapacity];
+
+        int state = series.state.load(std::memory_order_acquire);
+        if (state == MetricSeries::kEmpty &&
+            series.state.compare_exchange_strong(state, MetricSeries::kClaimed, std::memory_order_acquire)) {
+            series.type = &type;
+            series.format = &format;
+            SetTypeName(&series, type);
+            series.state.store(MetricSeries::kReady, std::memory_order_release);
+            return &series;
+        }
+        // the slot is being claimed by another thread, it may be claimed for the same series
+        while (state == MetricSeries::kClaimed) {
+            std::this_thread::yield();
+            state = series.state.load(std::memory_order_acquire);
+        }
+        if (*series.type == type && series.format == &format) {
+            return &series;
+        }
+    }
+    return nullptr;
+}
+
+inline void ParseMetrics::Observe(detail::MetricSeries* series, std::chrono::nanoseconds duration,
+                                  bool failed) noexcept
+{
+    if (!series) {
+        return;
+    }
+
+    const auto duration_ns = static_cast<std::uint64_t>(std::max<std::int64_t>(duration.count(), 0));
+    std::size_t bucket = 0;
+    while (bucket < kBucketBoundsUs.size() && duration_ns > kBucketBoundsUs[bucket] * 1000) {
+        ++bucket;
+    }
+
+    series->parses.fetch_add(1, std::memory_order_relaxed);
+    series->duration_ns.fetch_add(duration_ns, std::memory_order_relaxed);
+    series->buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    if (failed) {
+        series->failures.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        const auto now = std::chrono::system_clock::now().time_since_epoch();
+        series->last_success_ms.store(std::chrono::duration_cast<std::chrono::milliseconds>(now).count(),
+                                      std::memory_order_relaxed);
+    }
+}
+
+inline std::size_t ParseMetrics::Render(char* buffer, std::size_t size) const noexcept
+{
+    using detail::MetricSeries;
+
+    detail::MetricsWriter writer(buffer, size);
+    auto for_each_series = [this](auto&& render) {
+        for (const auto& series : series_) {
+            if (series.state.load(std::memory_order_acquire) == MetricSeries::kReady) {
+                render(series);
+            }
+        }
+    };
+    auto print_header = [&writer](const char* metric, const char* type, const char* help) {
+        writer.Print("# HELP %s %s\n# TYPE %s %s\n", metric, help, metric, type);
+    };
+
+    print_header("uconfig_parse_total", "counter", "Number of Config::Parse() calls.");
+    for_each_series([&writer](const MetricSeries& series) {
+        writer.Print("uconfig_parse_total");
+        writer.PutLabels(series);
+        writer.Print(" %llu\n", static_cast<unsigned long long>(series.parses.load(std::memory_order_relaxed)));
+    });
+
+    print_header("uconfig_parse_failures_total", "counter", "Number of failed Config::Parse() calls.");
+    for_each_series([&writer](const MetricSeries& series) {
+        writer.Print("uconfig_parse_failures_total");
+        writer.PutLabels(series);
+        writer.Print(" %llu\n", static_cast<unsigned long long>(series.failures.load(std::memory_order_relaxed)));
+    });
+
+    print_header("uconfig_parse_duration_seconds", "histogram", "Duration of Config::Parse() calls.");
+    for_each_series([&writer](const MetricSeries& series) {
+        // count is summed from the buckets to keep the histogram consistent under concurrent updates
+        std::uint64_t cumulative = 0;
+        char le[32];
+        for (std::size_t bucket = 0; bucket < series.buckets.size(); ++bucket) {
+            cumulative += series.buckets[bucket].load(std::memory_order_relaxed);
+            if (bucket < kBucketBoundsUs.size()) {
+                std::snprintf(le, sizeof(le), "le=\"%g\"", kBucketBoundsUs[bucket] / 1e6);
+            } else {
+                std::snprintf(le, sizeof(le), "le=\"+Inf\"");
+            }
+            writer.Print("uconfig_parse_duration_seconds_bucket");
+            writer.PutLabels(series, le);
+            writer.Print(" %llu\n", static_cast<unsigned long long>(cumulative));
+        }
+        writer.Print("uconfig_parse_duration_seconds_sum");
+        writer.PutLabels(series);
+        writer.Print(" %.9f\n", series.duration_ns.load(std::memory_order_relaxed) / 1e9);
+        writer.Print("uconfig_parse_duration_seconds_count");
+        writer.PutLabels(series);
+        writer.Print(" %llu\n", static_cast<unsigned long long>(cumulative));
+    });
+
+    print_header("uconfig_config_generation", "gauge", "Number of successful Config::Parse() calls.");
+    for_each_series([&writer](const MetricSeries& series) {
+        const std::uint64_t parses = series.parses.load(std::memory_order_relaxed);
+        const std::uint64_t failures = series.failures.load(std::memory_order_relaxed);
+        writer.Print("uconfig_config_generation");
+        writer.PutLabels(series);
+        writer.Print(" %llu\n", static_cast<unsigned long long>(parses > failures ? parses - failures : 0));
+    });
+
+    print_header("uconfig_config_last_success_timestamp_seconds", "gauge",
+                 "Unix time of the last successful Config::Parse() call.");
+    for_each_series([&writer](const MetricSeries& series) {
+        writer.Print("uconfig_config_last_success_timestamp_seconds");
+        writer.PutLabels(series);
+        writer.Print(" %.3f\n", series.last_success_ms.load(std::memory_order_relaxed) / 1e3);
+    });
+
+    return writer.Length();
+}
+
+inline void ParseMetrics::SetTypeName(detail::MetricSeries* series, const std::type_info& type) noexcept
+{
+    const char* name = type.name();
+#if __has_include(<cxxabi.h>)
+    int status = 0;
+    char* demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+    if (status == 0 && demangled) {
+        name = demangled;
+    }
+#endif
+    std::strncpy(series->type_name, name, sizeof(series->type_name) - 1);
+#if __has_include(<cxxabi.h>)
+    std::free(demangled);
+#endif
+}
+
+} // namespace uconfig
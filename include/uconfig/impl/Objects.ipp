@@ -13,6 +13,10 @@ Config<FormatTs...>::Config(bool optional)
 template <typename... FormatTs>
 Config<FormatTs...>::Config(const Config<FormatTs...>& other)
     : optional_(other.optional_)
+    , memoize_(other.memoize_)
+    , interning_(other.interning_)
+    , strict_(other.strict_)
+    , interpolation_(other.interpolation_)
 {
 }
 
@@ -22,6 +26,12 @@ Config<FormatTs...>& Config<FormatTs...>::operator=(const Config<FormatTs...>& o
     if (this != &other) {
         Reset();
         optional_ = other.optional_;
+        memoize_ = other.memoize_;
+        memo_ = {};
+        fingerprint_ = {};
+        interning_ = other.interning_;
+        strict_ = other.strict_;
+        interpolation_ = other.interpolation_;
     }
     return *this;
 }
@@ -29,6 +39,10 @@ Config<FormatTs...>& Config<FormatTs...>::operator=(const Config<FormatTs...>& o
 template <typename... FormatTs>
 Config<FormatTs...>::Config(Config<FormatTs...>&& other) noexcept
     : optional_(std::move(other.optional_))
+    , memoize_(other.memoize_)
+    , interning_(other.interning_)
+    , strict_(other.strict_)
+    , interpolation_(other.interpolation_)
 {
 }
 
@@ -38,6 +52,12 @@ Config<FormatTs...>& Config<FormatTs...>::operator=(Config<FormatTs...>&& other)
     if (this != &other) {
         Reset();
         optional_ = std::move(other.optional_);
+        memoize_ = other.memoize_;
+        memo_ = {};
+        fingerprint_ = {};
+        interning_ = other.interning_;
+        strict_ = other.strict_;
+        interpolation_ = other.interpolation_;
     }
     return *this;
 }
@@ -47,7 +67,39 @@ template <typename F>
 bool Config<FormatTs...>::Parse(const F& parser, const std::string& path, const typename F::source_type* source,
                                 bool throw_on_fail)
 {
-    return iface_type<F>{path, this}.Parse(parser, source, throw_on_fail);
+    UCONFIG_TRACE(Parse, F::name, path);
+    UCONFIG_PARSE_METRICS(parse_observer, typeid(*this), F::name);
+    // lookup caches of the format live for this parse only
+    const detail::FormatStateScope<F> format_state_scope(parser);
+    if constexpr (detail::has_unknown_keys<F>::value) {
+        if (strict_) {
+            unknown_keys_.clear();
+            KeyTracker tracker;
+            bool config_parsed;
+            {
+                KeyTracker::Scope tracker_scope(&tracker);
+                config_parsed = iface_type<F>{path, this}.Parse(parser, source, throw_on_fail);
+            }
+
+            unknown_keys_ = parser.UnknownKeys(source, path, tracker);
+            if (!unknown_keys_.empty() && throw_on_fail) {
+                std::string keys;
+                for (const auto& key : unknown_keys_) {
+                    keys += (keys.empty() ? "'" : ", '") + key + "'";
+                }
+                throw ParseError(F::name + " config '" + path + "' has unknown keys: " + keys);
+            }
+            return UCONFIG_PARSE_RESULT(parse_observer, config_parsed);
+        }
+    } else if (strict_) {
+        // unknown keys would pass unnoticed
+        if (throw_on_fail) {
+            throw ParseError(F::name + " config '" + path + "' can not be parsed strictly: format reports no keys");
+        }
+        return UCONFIG_PARSE_RESULT(parse_observer, false);
+    }
+    const bool config_parsed = iface_type<F>{path, this}.Parse(parser, source, throw_on_fail);
+    return UCONFIG_PARSE_RESULT(parse_observer, config_parsed);
 }
 
 template <typename... FormatTs>
@@ -55,6 +107,7 @@ template <typename F>
 void Config<FormatTs...>::Emit(const F& emitter, const std::string& path, typename F::dest_type* destination,
                                bool throw_on_fail)
 {
+    UCONFIG_TRACE(Emit, F::name, path);
     return iface_type<F>{path, this}.Emit(emitter, destination, throw_on_fail);
 }
 
@@ -79,6 +132,63 @@ bool Config<FormatTs...>::Optional() const noexcept
     return optional_;
 }
 
+template <typename... FormatTs>
+void Config<FormatTs...>::SetMemoize(bool enable) noexcept
+{
+    memoize_ = enable;
+    memo_ = {};
+}
+
+template <typename... FormatTs>
+const MemoStats& Config<FormatTs...>::Memo() const noexcept
+{
+    return memo_stats_;
+}
+
+template <typename... FormatTs>
+void Config<FormatTs...>::SetInterning(bool enable) noexcept
+{
+    interning_ = enable;
+    if (!interning_) {
+        intern_pool_.reset();
+    }
+}
+
+template <typename... FormatTs>
+const std::shared_ptr<InternPool>& Config<FormatTs...>::StringPool() const noexcept
+{
+    return intern_pool_;
+}
+
+template <typename... FormatTs>
+void Config<FormatTs...>::SetStrict(bool enable) noexcept
+{
+    strict_ = enable;
+}
+
+template <typename... FormatTs>
+const std::vector<std::string>& Config<FormatTs...>::UnknownKeys() const noexcept
+{
+    return unknown_keys_;
+}
+
+template <typename... FormatTs>
+void Config<FormatTs...>::SetInterpolation(bool enable) noexcept
+{
+    interpolation_ = enable;
+}
+
+template <typename... FormatTs>
+template <typename F>
+std::uint64_t Config<FormatTs...>::Fingerprint() const
+{
+    if (fingerprint_.format != &F::name) {
+        // registration of the elements does not change their values
+        iface_type<F>{"", const_cast<Config<FormatTs...>*>(this)}.Fingerprint(detail::kFnvSeed);
+    }
+    return fingerprint_.hash;
+}
+
 template <typename... FormatTs>
 template <typename F, typename T>
 void Config<FormatTs...>::Register(const std::string& element_path, T* element) noexcept
@@ -249,6 +359,243 @@ const T& Vector<T>::operator[](std::size_t pos) const
     return this->Get()[pos];
 }
 
+template <typename T>
+void Vector<T>::SetParallel(std::size_t threads, std::size_t min_chunk_size) noexcept
+{
+    parallel_threads_ = threads;
+    parallel_chunk_size_ = min_chunk_size;
+}
+
+template <typename T>
+SharedVector<T>::SharedVector(bool optional)
+    : optional_(optional)
+{
+}
+
+template <typename T>
+SharedVector<T>::SharedVector(std::vector<T> init_value)
+    : optional_(true)
+    , value_(std::make_shared<detail::SharedStorage<std::vector<T>>>(std::move(init_value)))
+{
+}
+
+template <typename T>
+bool SharedVector<T>::Initialized() const noexcept
+{
+    return value_ != nullptr;
+}
+
+template <typename T>
+bool SharedVector<T>::Optional() const noexcept
+{
+    return optional_;
+}
+
+template <typename T>
+const std::vector<T>& SharedVector<T>::Get() const
+{
+    if (!value_) {
+        throw Error("failed to get vector value: it is not set");
+    }
+    return value_->value;
+}
+
+template <typename T>
+const std::vector<T>& SharedVector<T>::operator*() const
+{
+    return Get();
+}
+
+template <typename T>
+const std::vector<T>* SharedVector<T>::operator->() const
+{
+    return &Get();
+}
+
+template <typename T>
+const T& SharedVector<T>::operator[](std::size_t pos) const
+{
+    return Get()[pos];
+}
+
+template <typename T>
+std::vector<T>& SharedVector<T>::Mutable()
+{
+    if (!value_) {
+        throw Error("failed to get vector value: it is not set");
+    }
+    if (value_.use_count() > 1) {
+        value_ = std::make_shared<detail::SharedStorage<std::vector<T>>>(value_->value);
+    }
+    value_->modified = true;
+    // the value no longer matches the source it has been parsed from
+    memo_ = {};
+    return value_->value;
+}
+
+template <typename T>
+std::shared_ptr<const std::vector<T>> SharedVector<T>::Storage() const noexcept
+{
+    if (!value_) {
+        return nullptr;
+    }
+    return std::shared_ptr<const std::vector<T>>(value_, &value_->value);
+}
+
+template <typename T>
+void SharedVector<T>::SetParallel(std::size_t threads, std::size_t min_chunk_size) noexcept
+{
+    parallel_threads_ = threads;
+    parallel_chunk_size_ = min_chunk_size;
+}
+
+template <typename C>
+SharedSection<C>::SharedSection(bool optional)
+    : optional_(optional)
+    , value_(std::make_shared<detail::SharedStorage<C>>())
+{
+}
+
+template <typename C>
+SharedSection<C>::SharedSection(C init_value)
+    : optional_(true)
+    , initialized_(true)
+    , value_(std::make_shared<detail::SharedStorage<C>>(std::move(init_value)))
+{
+}
+
+template <typename C>
+bool SharedSection<C>::Initialized() const noexcept
+{
+    return initialized_;
+}
+
+template <typename C>
+bool SharedSection<C>::Optional() const noexcept
+{
+    return optional_;
+}
+
+template <typename C>
+const C& SharedSection<C>::Get() const noexcept
+{
+    return value_->value;
+}
+
+template <typename C>
+const C& SharedSection<C>::operator*() const noexcept
+{
+    return Get();
+}
+
+template <typename C>
+const C* SharedSection<C>::operator->() const noexcept
+{
+    return &Get();
+}
+
+template <typename C>
+C& SharedSection<C>::Mutable()
+{
+    if (value_.use_count() > 1) {
+        value_ = std::make_shared<detail::SharedStorage<C>>(value_->value);
+    }
+    value_->modified = true;
+    // the section no longer matches the source it has been parsed from
+    memo_ = {};
+    return value_->value;
+}
+
+template <typename C>
+std::shared_ptr<const C> SharedSection<C>::Storage() const noexcept
+{
+    return std::shared_ptr<const C>(value_, &value_->value);
+}
+
+template <typename C>
+LazyConfig<C>::State::State(const C& init_value)
+    : value(init_value)
+{
+}
+
+template <typename C>
+LazyConfig<C>::LazyConfig(bool optional)
+    : optional_(optional)
+    , init_value_(std::make_shared<C>())
+{
+}
+
+template <typename C>
+LazyConfig<C>::LazyConfig(C init_value)
+    : optional_(true)
+    , init_value_(std::make_shared<C>(std::move(init_value)))
+{
+}
+
+template <typename C>
+bool LazyConfig<C>::Initialized() const noexcept
+{
+    return state_ != nullptr;
+}
+
+template <typename C>
+bool LazyConfig<C>::Optional() const noexcept
+{
+    return optional_;
+}
+
+template <typename C>
+void LazyConfig<C>::Load() const
+{
+    if (!state_) {
+        return;
+    }
+    if (!state_->loaded.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        if (!state_->loaded.load(std::memory_order_relaxed)) {
+            try {
+                state_->parse(&state_->value);
+            } catch (...) {
+                state_->error = std::current_exception();
+            }
+            // releases the source
+            state_->parse = nullptr;
+            state_->loaded.store(true, std::memory_order_release);
+        }
+    }
+    if (state_->error) {
+        std::rethrow_exception(state_->error);
+    }
+}
+
+template <typename C>
+bool LazyConfig<C>::Loaded() const noexcept
+{
+    return !state_ || state_->loaded.load(std::memory_order_acquire);
+}
+
+template <typename C>
+const C& LazyConfig<C>::Get() const
+{
+    if (!state_) {
+        return *init_value_;
+    }
+    Load();
+    return state_->value;
+}
+
+template <typename C>
+const C& LazyConfig<C>::operator*() const
+{
+    return Get();
+}
+
+template <typename C>
+const C* LazyConfig<C>::operator->() const
+{
+    return &Get();
+}
+
 /// If variable has value insert it into the stream, otherwise insert "[not set]".
 template <typename V, std::enable_if_t<!detail::is_base_of_template<V, std::vector>::value, bool> = true>
 std::ostream& operator<<(std::ostream& out, const Variable<V>& var)
@@ -0,0 +1,245 @@
+#pragma once
+
+#include <algorithm>
+#include <iomanip>
+#include <utility>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace uconfig {
+
+inline ParseProfiler::PhaseTimer::PhaseTimer(Phase phase) noexcept
+    : profiler_(Current())
+{
+    if (profiler_) {
+        previous_ = profiler_->EnterPhase(phase);
+    }
+}
+
+inline ParseProfiler::PhaseTimer::~PhaseTimer()
+{
+    if (profiler_) {
+        profiler_->LeavePhase(previous_);
+    }
+}
+
+inline ParseProfiler::PathTimer::PathTimer(const std::string& path) noexcept
+    : profiler_(Current())
+    , path_(&path)
+{
+    if (profiler_) {
+        start_ = Ticks();
+    }
+}
+
+inline ParseProfiler::PathTimer::~PathTimer()
+{
+    if (profiler_) {
+        Record(&profiler_->paths_, *path_, Ticks() - start_);
+    }
+}
+
+inline ParseProfiler::ValidatorTimer::ValidatorTimer(const std::string& path) noexcept
+    : phase_timer_(Phase::Validate)
+    , profiler_(Current())
+    , path_(&path)
+{
+    if (profiler_) {
+        start_ = Ticks();
+    }
+}
+
+inline ParseProfiler::ValidatorTimer::~ValidatorTimer()
+{
+    if (profiler_) {
+        Record(&profiler_->validators_, *path_, Ticks() - start_);
+    }
+}
+
+inline ParseProfiler::~ParseProfiler()
+{
+    if (Current() == this) {
+        Stop();
+    }
+}
+
+inline void ParseProfiler::Start() noexcept
+{
+    if (started_) {
+        return;
+    }
+    started_ = true;
+    Current() = this;
+    phase_ = Phase::Other;
+    session_start_ = std::chrono::steady_clock::now();
+    session_start_ticks_ = Ticks();
+    phase_start_ = session_start_ticks_;
+}
+
+inline void ParseProfiler::Stop() noexcept
+{
+    if (!started_) {
+        return;
+    }
+    const std::uint64_t now = Ticks();
+    phase_ticks_[static_cast<std::size_t>(phase_)] += now - phase_start_;
+    total_ticks_ += now - session_start_ticks_;
+    total_time_ += std::chrono::steady_clock::now() - session_start_;
+    started_ = false;
+    if (Current() == this) {
+        Current() = nullptr;
+    }
+}
+
+inline void ParseProfiler::Reset() noexcept
+{
+    phase_ticks_.fill(0);
+    paths_.clear();
+    validators_.clear();
+    total_ticks_ = 0;
+    total_time_ = std::chrono::nanoseconds(0);
+    if (started_) {
+        session_start_ = std::chrono::steady_clock::now();
+        session_start_ticks_ = Ticks();
+        phase_start_ = session_start_ticks_;
+    }
+}
+
+inline std::chrono::nanoseconds ParseProfiler::PhaseTime(Phase phase) const noexcept
+{
+    return ToTime(phase_ticks_[static_cast<std::size_t>(phase)]);
+}
+
+inline std::vector<ParseProfiler::Entry> ParseProfiler::TopPaths(std::size_t count) const
+{
+    return Top(paths_, count);
+}
+
+inline std::vector<ParseProfiler::Entry> ParseProfiler::TopValidators(std::size_t count) const
+{
+    return Top(validators_, count);
+}
+
+inline void ParseProfiler::Dump(std::ostream& out, std::size_t count) const
+{
+    auto print_us = [&out](std::chrono::nanoseconds time) -> std::ostream& {
+        return out << std::fixed << std::setprecision(3) << std::setw(12) << time.count() / 1000.0 << " us";
+    };
+
+    out << "phases:\n";
+    for (std::size_t phase = 0; phase < kPhases; ++phase) {
+        print_us(PhaseTime(static_cast<Phase>(phase))) << "  " << PhaseName(static_cast<Phase>(phase)) << "\n";
+    }
+    out << "slowest paths:\n";
+    for (const auto& entry : TopPaths(count)) {
+        print_us(entry.time) << "  " << std::setw(8) << entry.calls << " calls  '" << entry.path << "'\n";
+    }
+    out << "slowest validators:\n";
+    for (const auto& entry : TopValidators(count)) {
+        print_us(entry.time) << "  " << std::setw(8) << entry.calls << " calls  '" << entry.path << "'\n";
+    }
+}
+
+inline const char* ParseProfiler::PhaseName(Phase phase) noexcept
+{
+    switch (phase) {
+    case Phase::Init:
+        return "init";
+    case Phase::Path:
+        return "path";
+    case Phase::Lookup:
+        return "lookup";
+    case Phase::Convert:
+        return "convert";
+    case Phase::Validate:
+        return "validate";
+    case Phase::Other:
+        return "other";
+    }
+    return "unknown";
+}
+
+inline std::uint64_t ParseProfiler::Ticks() noexcept
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+#endif
+}
+
+inline ParseProfiler*& ParseProfiler::Current() noexcept
+{
+    thread_local ParseProfiler* profiler = nullptr;
+    return profiler;
+}
+
+inline ParseProfiler::Phase ParseProfiler::EnterPhase(Phase phase) noexcept
+{
+    if (!started_) {
+        return phase_;
+    }
+    const std::uint64_t now = Ticks();
+    phase_ticks_[static_cast<std::size_t>(phase_)] += now - phase_start_;
+    phase_start_ = now;
+    return std::exchange(phase_, phase);
+}
+
+inline void ParseProfiler::LeavePhase(Phase previous) noexcept
+{
+    EnterPhase(previous);
+}
+
+inline void ParseProfiler::Record(std::unordered_map<std::string, Stats>* table, const std::string& path,
+                                  std::uint64_t ticks) noexcept
+{
+    try {
+        Stats& stats = (*table)[path];
+        ++stats.calls;
+        stats.ticks += ticks;
+    } catch (...) {
+        // profiling never fails the parsing
+    }
+}
+
+inline std::vector<ParseProfiler::Entry> ParseProfiler::Top(const std::unordered_map<std::string, Stats>& table,
+                                                           std::size_t count) const
+{
+    std::vector<std::pair<const std::string*, Stats>> sorted;
+    sorted.reserve(table.size());
+    for (const auto& [path, stats] : table) {
+        sorted.emplace_back(&path, stats);
+    }
+
+    count = std::min(count, sorted.size());
+    std::partial_sort(sorted.begin(), sorted.begin() + count, sorted.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.second.ticks != rhs.second.ticks ? lhs.second.ticks > rhs.second.ticks : *lhs.first < *rhs.first;
+    });
+
+    std::vector<Entry> top;
+    top.reserve(count);
+    for (std::size_t index = 0; index < count; ++index) {
+        top.push_back(Entry{*sorted[index].first, sorted[index].second.calls, ToTime(sorted[index].second.ticks)});
+    }
+    return top;
+}
+
+inline std::chrono::nanoseconds ParseProfiler::ToTime(std::uint64_t ticks) const noexcept
+{
+    std::uint64_t total_ticks = total_ticks_;
+    std::chrono::nanoseconds total_time = total_time_;
+    if (started_) {
+        total_ticks += Ticks() - session_start_ticks_;
+        total_time += std::chrono::steady_clock::now() - session_start_;
+    }
+
+    // ticks are calibrated against the steady clock over the recorded time
+    const double ns_per_tick = total_ticks > 0 ? static_cast<double>(total_time.count()) / total_ticks : 1.0;
+    return std::chrono::nanoseconds(static_cast<std::int64_t>(ticks * ns_per_tick));
+}
+
+} // namespace uconfig
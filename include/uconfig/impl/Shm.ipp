@@ -0,0 +1,235 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace uconfig {
+namespace detail {
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "shared atomics should be lock-free");
+static_assert(sizeof(ShmSegment::Header) <= ShmSegment::kSlotsOffset, "header should fit before the slots");
+
+inline ShmSegment::ShmSegment(ShmSegment&& other) noexcept
+    : name_(std::move(other.name_))
+    , data_(other.data_)
+    , size_(other.size_)
+{
+    other.data_ = nullptr;
+    other.size_ = 0;
+}
+
+inline ShmSegment& ShmSegment::operator=(ShmSegment&& other) noexcept
+{
+    if (this != &other) {
+        Unmap();
+        name_ = std::move(other.name_);
+        data_ = other.data_;
+        size_ = other.size_;
+        other.data_ = nullptr;
+        other.size_ = 0;
+    }
+    return *this;
+}
+
+inline ShmSegment::~ShmSegment()
+{
+    Unmap();
+}
+
+inline void ShmSegment::Open(const std::string& name, bool writable, std::size_t slot_capacity)
+{
+    name_ = name;
+    // keep slots aligned to the cache line
+    slot_capacity = (slot_capacity + kSlotsOffset - 1) / kSlotsOffset * kSlotsOffset;
+
+    const int fd = ::shm_open(name_.c_str(), writable ? O_RDWR | O_CREAT : O_RDONLY, 0644);
+    if (fd < 0) {
+        Fail("opened", errno);
+    }
+
+    struct stat segment_stat;
+    if (::fstat(fd, &segment_stat) != 0) {
+        const int error = errno;
+        ::close(fd);
+        Fail("opened", error);
+    }
+    size_ = static_cast<std::size_t>(segment_stat.st_size);
+
+    const bool created = writable && size_ == 0;
+    if (created) {
+        size_ = kSlotsOffset + 2 * slot_capacity;
+        if (::ftruncate(fd, static_cast<off_t>(size_)) != 0) {
+            const int error = errno;
+            ::close(fd);
+            Fail("created", error);
+        }
+    }
+    if (size_ < kSlotsOffset) {
+        ::close(fd);
+        throw Error("[SHM] '" + name_ + "' is not valid: segment is too small");
+    }
+
+    data_ = ::mmap(nullptr, size_, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+    const int error = errno;
+    ::close(fd);
+    if (data_ == MAP_FAILED) {
+        data_ = nullptr;
+        Fail("mapped", error);
+    }
+
+    Header& header = GetHeader();
+    if (created) {
+        // fresh segment is zero-filled, so atomics are already zero
+        header.slot_capacity = slot_capacity;
+        header.magic = kMagic;
+        return;
+    }
+    if (header.magic != kMagic || size_ < kSlotsOffset + 2 * header.slot_capacity) {
+        throw Error("[SHM] '" + name_ + "' is not valid: bad segment header");
+    }
+    if (writable && header.slot_capacity != slot_capacity) {
+        throw Error("[SHM] '" + name_ + "' is not valid: segment has slot capacity of " +
+                    std::to_string(header.slot_capacity) + " bytes");
+    }
+}
+
+inline ShmSegment::Header& ShmSegment::GetHeader() const noexcept
+{
+    return *static_cast<Header*>(data_);
+}
+
+inline char* ShmSegment::Slot(std::uint64_t generation) const noexcept
+{
+    return static_cast<char*>(data_) + kSlotsOffset + (generation % 2) * GetHeader().slot_capacity;
+}
+
+inline const std::string& ShmSegment::Name() const noexcept
+{
+    return name_;
+}
+
+inline void ShmSegment::Fail(const std::string& what, int error) const
+{
+    throw Error("[SHM] '" + name_ + "' failed to be " + what + ": " + std::strerror(error));
+}
+
+inline void ShmSegment::Unmap() noexcept
+{
+    if (data_) {
+        ::munmap(data_, size_);
+        data_ = nullptr;
+    }
+}
+
+} // namespace detail
+
+inline ShmPublisher::ShmPublisher(const std::string& name, std::size_t slot_capacity)
+{
+    segment_.Open(name, true, slot_capacity);
+}
+
+template <typename ConfigT, typename std::enable_if<!std::is_same<ConfigT, FlatKvTable>::value>::type*>
+std::uint64_t ShmPublisher::Publish(ConfigT& config, const std::string& path)
+{
+    FlatKvTable table;
+    config.Emit(FlatKvFormat{}, path, &table);
+    table.Build();
+    return Publish(table);
+}
+
+inline std::uint64_t ShmPublisher::Publish(const FlatKvTable& table)
+{
+    auto& header = segment_.GetHeader();
+
+    const std::size_t image_size = table.ImageSize();
+    if (image_size > header.slot_capacity) {
+        throw EmitError("[SHM] '" + segment_.Name() + "' is not valid: image of " + std::to_string(image_size) +
+                        " bytes exceeds slot capacity of " + std::to_string(header.slot_capacity) + " bytes");
+    }
+
+    // odd sequence is left by a publisher crashed while writing, its' slot is rewritten
+    const std::uint64_t sequence = header.sequence.load(std::memory_order_relaxed) & ~std::uint64_t(1);
+    const std::uint64_t generation = sequence / 2 + 1;
+
+    // readers of the previous generation are not affected, since the other slot is written
+    header.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    table.WriteImage(segment_.Slot(generation));
+    header.image_size[generation % 2].store(image_size, std::memory_order_relaxed);
+    header.sequence.store(sequence + 2, std::memory_order_release);
+    return generation;
+}
+
+inline std::uint64_t ShmPublisher::Generation() const noexcept
+{
+    return segment_.GetHeader().sequence.load(std::memory_order_acquire) / 2;
+}
+
+inline void ShmPublisher::Unlink(const std::string& name) noexcept
+{
+    ::shm_unlink(name.c_str());
+}
+
+inline ShmReader::ShmReader(const std::string& name)
+{
+    segment_.Open(name, false, 0);
+}
+
+template <typename ConfigT>
+std::uint64_t ShmReader::Parse(ConfigT* config, const std::string& path, bool throw_on_fail) const
+{
+    const auto& header = segment_.GetHeader();
+
+    while (true) {
+        const std::uint64_t sequence = header.sequence.load(std::memory_order_acquire);
+        const std::uint64_t generation = sequence / 2;
+        if (generation == 0) {
+            throw ParseError("[SHM] '" + segment_.Name() + "' is not valid: nothing has been published");
+        }
+
+        // parse into a copy, so torn image never leaks into the config
+        ConfigT candidate(*config);
+        bool candidate_parsed = false;
+        try {
+            const std::size_t image_size = header.image_size[generation % 2].load(std::memory_order_relaxed);
+            const FlatKvTable table = FlatKvTable::FromImage(segment_.Slot(generation),
+                                                             std::min<std::size_t>(image_size, header.slot_capacity));
+            candidate_parsed = candidate.Parse(FlatKvFormat{}, path, &table, throw_on_fail);
+        } catch (const Error&) {
+            if (Consistent(sequence)) {
+                throw;
+            }
+            continue;
+        }
+
+        if (Consistent(sequence)) {
+            // failure swallowed without throw_on_fail leaves the config as is
+            if (!candidate_parsed) {
+                return 0;
+            }
+            *config = std::move(candidate);
+            return generation;
+        }
+    }
+}
+
+inline std::uint64_t ShmReader::Generation() const noexcept
+{
+    return segment_.GetHeader().sequence.load(std::memory_order_acquire) / 2;
+}
+
+inline bool ShmReader::Consistent(std::uint64_t sequence) const noexcept
+{
+    // slot of the generation is rewritten only when the one after the next starts to be written
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const std::uint64_t current = segment_.GetHeader().sequence.load(std::memory_order_relaxed);
+    return current < (sequence & ~std::uint64_t(1)) + 3;
+}
+
+} // namespace uconfig
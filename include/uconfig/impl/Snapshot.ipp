@@ -0,0 +1,113 @@
+#pragma once
+
+#include <stdexcept>
+#include <utility>
+
+namespace uconfig {
+
+template <typename T>
+SnapshotPublisher<T>::SnapshotPublisher(T value)
+    : SnapshotPublisher(std::make_shared<const T>(std::move(value)))
+{
+}
+
+template <typename T>
+SnapshotPublisher<T>::SnapshotPublisher(std::shared_ptr<const T> snapshot)
+{
+    Publish(std::move(snapshot));
+}
+
+template <typename T>
+std::uint64_t SnapshotPublisher<T>::Publish(T value)
+{
+    return Publish(std::make_shared<const T>(std::move(value)));
+}
+
+template <typename T>
+std::uint64_t SnapshotPublisher<T>::Publish(std::shared_ptr<const T> snapshot)
+{
+    if (!snapshot) {
+        throw std::runtime_error("invalid snapshot pointer to publish");
+    }
+
+    // previous snapshot is destroyed after the lock is released
+    std::shared_ptr<const T> previous;
+    std::lock_guard<std::mutex> lock(mutex_);
+    previous = std::exchange(snapshot_, std::move(snapshot));
+    generation_.store(++snapshot_generation_, std::memory_order_release);
+    return snapshot_generation_;
+}
+
+template <typename T>
+std::uint64_t SnapshotPublisher<T>::Generation() const noexcept
+{
+    return generation_.load(std::memory_order_acquire);
+}
+
+template <typename T>
+std::shared_ptr<const T> SnapshotPublisher<T>::Current() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return snapshot_;
+}
+
+template <typename T>
+SnapshotReader<T> SnapshotPublisher<T>::MakeReader() const
+{
+    return SnapshotReader<T>(*this);
+}
+
+template <typename T>
+SnapshotReader<T>::SnapshotReader(const SnapshotPublisher<T>& publisher)
+    : publisher_(&publisher)
+{
+    Refresh();
+}
+
+template <typename T>
+const T& SnapshotReader<T>::Get()
+{
+    // the only shared access on the common path is a load of rarely written generation
+    if (publisher_->generation_.load(std::memory_order_acquire) != generation_) {
+        Refresh();
+    }
+    return *snapshot_;
+}
+
+template <typename T>
+const T& SnapshotReader<T>::operator*()
+{
+    return Get();
+}
+
+template <typename T>
+const T* SnapshotReader<T>::operator->()
+{
+    return &Get();
+}
+
+template <typename T>
+std::uint64_t SnapshotReader<T>::Generation() const noexcept
+{
+    return generation_;
+}
+
+template <typename T>
+std::shared_ptr<const T> SnapshotReader<T>::Share() const noexcept
+{
+    return snapshot_;
+}
+
+template <typename T>
+void SnapshotReader<T>::Refresh()
+{
+    std::shared_ptr<const T> previous;
+    {
+        std::lock_guard<std::mutex> lock(publisher_->mutex_);
+        previous = std::exchange(snapshot_, publisher_->snapshot_);
+        generation_ = publisher_->snapshot_generation_;
+    }
+    // previous snapshot may be the last reference, so it is destroyed out of the lock
+}
+
+} // namespace uconfig
@@ -0,0 +1,57 @@
+#pragma once
+
+namespace uconfig {
+
+inline void KeyTracker::Visit(node_key node)
+{
+    visited_.insert(node);
+}
+
+inline void KeyTracker::Consume(node_key node)
+{
+    consumed_.insert(node);
+}
+
+inline void KeyTracker::Merge(KeyTracker& other)
+{
+    visited_.merge(other.visited_);
+    consumed_.merge(other.consumed_);
+    other.visited_.clear();
+    other.consumed_.clear();
+}
+
+inline bool KeyTracker::Visited(node_key node) const
+{
+    return visited_.count(node) > 0 || consumed_.count(node) > 0;
+}
+
+inline bool KeyTracker::Consumed(node_key node) const
+{
+    return consumed_.count(node) > 0;
+}
+
+inline KeyTracker* KeyTracker::Current() noexcept
+{
+    return CurrentRef();
+}
+
+inline KeyTracker::Scope::Scope(KeyTracker* tracker) noexcept
+    : previous_(CurrentRef())
+{
+    if (tracker) {
+        CurrentRef() = tracker;
+    }
+}
+
+inline KeyTracker::Scope::~Scope()
+{
+    CurrentRef() = previous_;
+}
+
+inline KeyTracker*& KeyTracker::CurrentRef() noexcept
+{
+    static thread_local KeyTracker* tracker = nullptr;
+    return tracker;
+}
+
+} // namespace uconfig
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <exception>
+
+#ifdef UCONFIG_USDT
+#include <sys/sdt.h>
+#endif
+
+namespace uconfig {
+
+inline void SetTraceHook(TraceHook* hook) noexcept
+{
+    detail::trace_hook().store(hook, std::memory_order_release);
+}
+
+inline TraceHook* GetTraceHook() noexcept
+{
+    return detail::trace_hook().load(std::memory_order_acquire);
+}
+
+inline const char* TraceEventName(TraceEvent event) noexcept
+{
+    switch (event) {
+    case TraceEvent::Parse:
+        return "parse";
+    case TraceEvent::Emit:
+        return "emit";
+    case TraceEvent::ParseSection:
+        return "parse_section";
+    case TraceEvent::EmitSection:
+        return "emit_section";
+    case TraceEvent::Validate:
+        return "validate";
+    }
+    return "unknown";
+}
+
+namespace detail {
+
+inline TraceScope::TraceScope(TraceEvent event, const std::string& format, const std::string& path) noexcept
+    : event_(event)
+    , format_(format)
+    , path_(path)
+    , hook_(GetTraceHook())
+    , uncaught_exceptions_(std::uncaught_exceptions())
+{
+    Probe(true, false);
+    if (hook_) {
+        hook_->Begin(event_, format_, path_);
+    }
+}
+
+inline TraceScope::~TraceScope()
+{
+    const bool failed = std::uncaught_exceptions() > uncaught_exceptions_;
+    if (hook_) {
+        hook_->End(event_, format_, path_, failed);
+    }
+    Probe(false, failed);
+}
+
+inline void TraceScope::Probe(bool begin, bool failed) const noexcept
+{
+#ifdef UCONFIG_USDT
+    // probe names have to be literals: uconfig:<event>__begin(format, path), uconfig:<event>__end(format, path, failed)
+    const char* format = format_.c_str();
+    const char* path = path_.c_str();
+    const int failed_arg = failed ? 1 : 0;
+    switch (event_) {
+    case TraceEvent::Parse:
+        if (begin) {
+            DTRACE_PROBE2(uconfig, parse__begin, format, path);
+        } else {
+            DTRACE_PROBE3(uconfig, parse__end, format, path, failed_arg);
+        }
+        break;
+    case TraceEvent::Emit:
+        if (begin) {
+            DTRACE_PROBE2(uconfig, emit__begin, format, path);
+        } else {
+            DTRACE_PROBE3(uconfig, emit__end, format, path, failed_arg);
+        }
+        break;
+    case TraceEvent::ParseSection:
+        if (begin) {
+            DTRACE_PROBE2(uconfig, parse_section__begin, format, path);
+        } else {
+            DTRACE_PROBE3(uconfig, parse_section__end, format, path, failed_arg);
+        }
+        break;
+    case TraceEvent::EmitSection:
+        if (begin) {
+            DTRACE_PROBE2(uconfig, emit_section__begin, format, path);
+        } else {
+            DTRACE_PROBE3(uconfig, emit_section__end, format, path, failed_arg);
+        }
+        break;
+    case TraceEvent::Validate:
+        if (begin) {
+            DTRACE_PROBE2(uconfig, validate__begin, format, path);
+        } else {
+            DTRACE_PROBE3(uconfig, validate__end, format, path, failed_arg);
+        }
+        break;
+    }
+#else
+    (void)begin;
+    (void)failed;
+#endif
+}
+
+} // namespace detail
+} // namespace uconfig
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <exception>
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace uconfig {
+
+inline AtomicFileWriter::AtomicFileWriter(std::string path, mode_t mode, std::size_t buffer_size)
+    : path_(std::move(path))
+    , temp_path_(path_ + ".XXXXXX")
+    , buffer_(buffer_size > 0 ? buffer_size : 1)
+{
+    // temporary file is created in the same directory, so it is renamed within the same filesystem
+    fd_ = ::mkstemp(temp_path_.data());
+    if (fd_ < 0) {
+        temp_path_.clear();
+        throw Fail("create", errno);
+    }
+    ::fcntl(fd_, F_SETFD, FD_CLOEXEC);
+    if (::fchmod(fd_, mode) != 0) {
+        throw Fail("chmod", errno);
+    }
+}
+
+inline AtomicFileWriter::~AtomicFileWriter()
+{
+    Abort();
+}
+
+inline void AtomicFileWriter::Write(std::string_view data)
+{
+    while (!data.empty()) {
+        if (buffered_ == buffer_.size()) {
+            Flush();
+        }
+        const std::size_t chunk = std::min(data.size(), buffer_.size() - buffered_);
+        std::memcpy(buffer_.data() + buffered_, data.data(), chunk);
+        buffered_ += chunk;
+        data.remove_prefix(chunk);
+    }
+}
+
+inline void AtomicFileWriter::Put(Ch c)
+{
+    if (buffered_ == buffer_.size()) {
+        Flush();
+    }
+    buffer_[buffered_++] = c;
+}
+
+inline void AtomicFileWriter::Flush()
+{
+    if (fd_ < 0) {
+        throw EmitError(name + " file '" + path_ + "' failed to be written: writer is closed");
+    }
+
+    std::size_t written = 0;
+    while (written < buffered_) {
+        const ssize_t bytes = ::write(fd_, buffer_.data() + written, buffered_ - written);
+        if (bytes < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw Fail("write", errno);
+        }
+        written += static_cast<std::size_t>(bytes);
+    }
+    buffered_ = 0;
+}
+
+inline void AtomicFileWriter::Commit()
+{
+    Flush();
+    if (::fsync(fd_) != 0) {
+        throw Fail("sync", errno);
+    }
+    const int fd = fd_;
+    fd_ = -1;
+    if (::close(fd) != 0) {
+        throw Fail("close", errno);
+    }
+    if (::rename(temp_path_.c_str(), path_.c_str()) != 0) {
+        throw Fail("rename", errno);
+    }
+    temp_path_.clear();
+
+    // rename is durable once the directory is synced
+    const std::size_t slash = path_.rfind('/');
+    const std::string dir = slash == std::string::npos ? "." : slash == 0 ? "/" : path_.substr(0, slash);
+    const int dir_fd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dir_fd >= 0) {
+        ::fsync(dir_fd);
+        ::close(dir_fd);
+    }
+}
+
+inline void AtomicFileWriter::Abort() noexcept
+{
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    if (!temp_path_.empty()) {
+        ::unlink(temp_path_.c_str());
+        temp_path_.clear();
+    }
+    buffered_ = 0;
+}
+
+inline const std::string& AtomicFileWriter::Path() const noexcept
+{
+    return path_;
+}
+
+inline EmitError AtomicFileWriter::Fail(const std::string& action, int error)
+{
+    Abort();
+    return EmitError(name + " file '" + path_ + "' failed to " + action + ": " + std::strerror(error));
+}
+
+template <typename F, typename C>
+void EmitFile(const F& emitter, C& config, const std::string& path, const std::string& file_path, mode_t mode)
+{
+    typename F::dest_type dest;
+    config.Emit(emitter, path, &dest);
+
+    AtomicFileWriter file(file_path, mode);
+    try {
+        emitter.Write(&dest, &file);
+    } catch (const Error&) {
+        throw;
+    } catch (const std::exception& ex) {
+        throw EmitError(F::name + " file '" + file_path + "' failed to be written: " + ex.what());
+    }
+    file.Commit();
+}
+
+} // namespace uconfig
@@ -0,0 +1,17 @@
+// Explicit instantiations of uconfig templates for built-in types, see UCONFIG_COMPILED option.
+
+#include "uconfig/format/Env.h"
+#ifdef UCONFIG_COMPILED_RAPIDJSON
+#include "uconfig/format/Rapidjson.h"
+#endif
+
+namespace uconfig {
+
+UCONFIG_INSTANTIATE_FORMAT(, EnvFormat)
+
+#ifdef UCONFIG_COMPILED_RAPIDJSON
+template class RapidjsonFormat<>;
+UCONFIG_INSTANTIATE_FORMAT(, RapidjsonFormat<>)
+#endif
+
+} // namespace uconfig
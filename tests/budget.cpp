@@ -0,0 +1,162 @@
+#include "uconfig/format/Rapidjson.h"
+#include "uconfig/uconfig.h"
+#include "gtest/gtest.h"
+
+/* Parse exceeding its' budget fails with a structured error */
+
+struct Upstream: public uconfig::Config<uconfig::RapidjsonFormat<>>
+{
+    uconfig::Variable<std::string> host;
+    uconfig::Vector<unsigned> ports{true};
+
+    using uconfig::Config<uconfig::RapidjsonFormat<>>::Config;
+
+    virtual void Init(const std::string& config_path) override
+    {
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/host", &host);
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/ports", &ports);
+    }
+};
+
+struct ProxyConfig: public uconfig::Config<uconfig::RapidjsonFormat<>>
+{
+    uconfig::Variable<std::string> name;
+    Upstream upstream{true};
+
+    using uconfig::Config<uconfig::RapidjsonFormat<>>::Config;
+
+    virtual void Init(const std::string& config_path) override
+    {
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/name", &name);
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/upstream", &upstream);
+    }
+};
+
+rapidjson::Document MakeProxy(std::size_t ports)
+{
+    rapidjson::Document json{rapidjson::kObjectType};
+    auto& allocator = json.GetAllocator();
+    rapidjson::Value upstream{rapidjson::kObjectType};
+    rapidjson::Value ports_json{rapidjson::kArrayType};
+    for (std::size_t index = 0; index < ports; ++index) {
+        ports_json.PushBack(static_cast<unsigned>(index), allocator);
+    }
+    upstream.AddMember("host", "localhost", allocator);
+    upstream.AddMember("ports", ports_json, allocator);
+    json.AddMember("name", "proxy", allocator);
+    json.AddMember("upstream", upstream, allocator);
+    return json;
+}
+
+uconfig::BudgetError ParseWithLimits(const rapidjson::Document& json, const uconfig::ParseLimits& limits)
+{
+    uconfig::ParseBudget budget(limits);
+    ProxyConfig config;
+    try {
+        config.Parse(uconfig::RapidjsonFormat<>{}, "", &json, false);
+    } catch (const uconfig::BudgetError& ex) {
+        return ex;
+    }
+    ADD_FAILURE() << "parse has not exceeded the budget";
+    return uconfig::BudgetError(uconfig::BudgetError::Limit::Depth, "", "");
+}
+
+TEST(Budget, Unlimited)
+{
+    const auto json = MakeProxy(100);
+    {
+        uconfig::ParseBudget budget(uconfig::ParseLimits{});
+        ProxyConfig config;
+        ASSERT_TRUE(config.Parse(uconfig::RapidjsonFormat<>{}, "", &json));
+        ASSERT_EQ(config.upstream.ports->size(), 100);
+        ASSERT_EQ(budget.TotalBytes(), 5 + 9 + 100 * sizeof(unsigned));
+    }
+
+    // limits are not applied outside of the budget scope
+    ProxyConfig config;
+    ASSERT_TRUE(config.Parse(uconfig::RapidjsonFormat<>{}, "", &json));
+}
+
+TEST(Budget, Limits)
+{
+    using Limit = uconfig::BudgetError::Limit;
+
+    const auto json = MakeProxy(100);
+
+    uconfig::ParseLimits limits;
+    limits.max_vector_size = 10;
+    auto error = ParseWithLimits(json, limits);
+    // optional vector of the optional section is not skipped
+    ASSERT_EQ(error.limit, Limit::VectorSize);
+    ASSERT_EQ(error.path, "/upstream/ports");
+    ASSERT_STREQ(error.what(), "[JSON] config '/upstream/ports' is not valid: vector exceeds max size 10");
+
+    limits = uconfig::ParseLimits{};
+    limits.max_depth = 2;
+    error = ParseWithLimits(json, limits);
+    ASSERT_EQ(error.limit, Limit::Depth);
+    ASSERT_EQ(error.path, "/upstream/ports");
+
+    limits = uconfig::ParseLimits{};
+    limits.max_string_size = 5;
+    error = ParseWithLimits(json, limits);
+    ASSERT_EQ(error.limit, Limit::StringSize);
+    ASSERT_EQ(error.path, "/upstream/host");
+
+    limits = uconfig::ParseLimits{};
+    limits.max_total_bytes = 5 + 9 + 10 * sizeof(unsigned);
+    error = ParseWithLimits(json, limits);
+    ASSERT_EQ(error.limit, Limit::TotalBytes);
+    ASSERT_EQ(error.path, "/upstream/ports/10");
+
+    limits = uconfig::ParseLimits{};
+    limits.timeout = std::chrono::nanoseconds(0);
+    error = ParseWithLimits(json, limits);
+    ASSERT_EQ(error.limit, Limit::Deadline);
+    ASSERT_EQ(error.path, "");
+}
+
+TEST(Budget, ParallelVector)
+{
+    using Limit = uconfig::BudgetError::Limit;
+
+    const auto json = MakeProxy(1000);
+
+    uconfig::ParseLimits limits;
+    limits.max_vector_size = 999;
+    uconfig::ParseBudget budget(limits);
+    ProxyConfig config;
+    config.upstream.ports.SetParallel(4, 16);
+    try {
+        config.Parse(uconfig::RapidjsonFormat<>{}, "", &json);
+        FAIL() << "parse has not exceeded the budget";
+    } catch (const uconfig::BudgetError& ex) {
+        ASSERT_EQ(ex.limit, Limit::VectorSize);
+    }
+}
+
+TEST(Budget, ParallelTotalBytes)
+{
+    using Limit = uconfig::BudgetError::Limit;
+
+    const auto json = MakeProxy(1000);
+
+    // elements are accounted by the worker threads
+    uconfig::ParseLimits limits;
+    limits.max_total_bytes = 500 * sizeof(unsigned);
+    uconfig::ParseBudget budget(limits);
+    ProxyConfig config;
+    config.upstream.ports.SetParallel(4, 16);
+    try {
+        config.Parse(uconfig::RapidjsonFormat<>{}, "", &json);
+        FAIL() << "parse has not exceeded the budget";
+    } catch (const uconfig::BudgetError& ex) {
+        ASSERT_EQ(ex.limit, Limit::TotalBytes);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,181 @@
+#include "uconfig/format/Env.h"
+#include "uconfig/format/Rapidjson.h"
+#include "uconfig/uconfig.h"
+#include "gtest/gtest.h"
+
+/* Changes between two instances of a config are found without emitting them */
+
+struct Endpoint
+{
+    std::string host;
+    unsigned port;
+};
+
+struct Upstream: public uconfig::Config<uconfig::RapidjsonFormat<>>
+{
+    uconfig::Variable<std::string> host;
+    uconfig::Variable<unsigned> weight{1};
+
+    using uconfig::Config<uconfig::RapidjsonFormat<>>::Config;
+
+    virtual void Init(const std::string& config_path) override
+    {
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/host", &host);
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/weight", &weight);
+    }
+};
+
+struct Limits: public uconfig::Config<uconfig::RapidjsonFormat<>>
+{
+    uconfig::Variable<int> rps{100};
+
+    using uconfig::Config<uconfig::RapidjsonFormat<>>::Config;
+
+    virtual void Init(const std::string& config_path) override
+    {
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/rps", &rps);
+    }
+};
+
+struct ProxyConfig: public uconfig::Config<uconfig::RapidjsonFormat<>>
+{
+    uconfig::Variable<std::string> name;
+    uconfig::Variable<double> timeout{1.0};
+    uconfig::Vector<int> ports;
+    uconfig::Vector<Upstream> upstreams{true};
+    uconfig::SharedVector<std::string> tags{true};
+    uconfig::SharedSection<Limits> limits;
+
+    using uconfig::Config<uconfig::RapidjsonFormat<>>::Config;
+
+    virtual void Init(const std::string& config_path) override
+    {
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/name", &name);
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/timeout", &timeout);
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/ports", &ports);
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/upstreams", &upstreams);
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/tags", &tags);
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/limits", &limits);
+    }
+};
+
+rapidjson::Document MakeJson(const char* text)
+{
+    rapidjson::Document json;
+    json.Parse(text);
+    return json;
+}
+
+ProxyConfig MakeConfig(const char* text)
+{
+    const auto json = MakeJson(text);
+    ProxyConfig config;
+    config.Parse(uconfig::RapidjsonFormat<>{}, "", &json);
+    return config;
+}
+
+TEST(Diff, Equal)
+{
+    const char* text = R"({"name": "proxy", "ports": [80, 443], "upstreams": [{"host": "a"}], "tags": ["x"]})";
+    const ProxyConfig before = MakeConfig(text);
+    const ProxyConfig after = MakeConfig(text);
+    ASSERT_TRUE(uconfig::Diff(uconfig::RapidjsonFormat<>{}, before, after).empty());
+
+    // copies share the storage of shared objects
+    const ProxyConfig copy = before;
+    ASSERT_TRUE(uconfig::Diff(uconfig::RapidjsonFormat<>{}, before, copy).empty());
+}
+
+TEST(Diff, Changes)
+{
+    using Kind = uconfig::Change::Kind;
+
+    const ProxyConfig before = MakeConfig(
+        R"({"name": "proxy", "timeout": 1.5, "ports": [80, 443, 8080], "upstreams": [{"host": "a"}],)"
+        R"( "tags": ["x", "y"], "limits": {"rps": 10}})");
+    const ProxyConfig after = MakeConfig(
+        R"({"name": "proxy", "timeout": 2, "ports": [80, 8443], "upstreams": [{"host": "a", "weight": 2},)"
+        R"( {"host": "b"}], "limits": {"rps": 20}})");
+
+    const auto changes = uconfig::Diff(uconfig::RapidjsonFormat<>{}, before, after);
+    ASSERT_EQ(changes.size(), 7);
+
+    const auto expect = [&](std::size_t index, Kind kind, const char* path, const char* old_value,
+                            const char* new_value) {
+        SCOPED_TRACE(path);
+        ASSERT_EQ(changes[index].kind, kind);
+        ASSERT_EQ(changes[index].path, path);
+        ASSERT_EQ(changes[index].old_value, old_value);
+        ASSERT_EQ(changes[index].new_value, new_value);
+    };
+    expect(0, Kind::Replaced, "/timeout", "1.5", "2");
+    expect(1, Kind::Replaced, "/ports/1", "443", "8443");
+    expect(2, Kind::Removed, "/ports/2", "8080", "");
+    expect(3, Kind::Replaced, "/upstreams/0/weight", "1", "2");
+    // sections are not printable
+    expect(4, Kind::Added, "/upstreams/1", "", "");
+    expect(5, Kind::Removed, "/tags", "[x, y]", "");
+    expect(6, Kind::Replaced, "/limits/rps", "10", "20");
+
+    // configs are not changed by the comparison
+    ASSERT_EQ(after.upstreams[0].weight, 2u);
+    ASSERT_EQ(after.limits->rps, 20);
+}
+
+TEST(Diff, Path)
+{
+    const ProxyConfig before = MakeConfig(R"({"name": "a", "ports": [80]})");
+    const ProxyConfig after = MakeConfig(R"({"name": "b", "ports": [80]})");
+
+    const auto changes = uconfig::Diff(uconfig::RapidjsonFormat<>{}, before, after, "/proxy");
+    ASSERT_EQ(changes.size(), 1);
+    ASSERT_EQ(changes[0].path, "/proxy/name");
+}
+
+TEST(Diff, Patch)
+{
+    const ProxyConfig before = MakeConfig(R"({"name": "proxy", "ports": [80, 443], "upstreams": [{"host": "a"}]})");
+    const ProxyConfig after =
+        MakeConfig(R"({"name": "proxy", "ports": [80], "upstreams": [{"host": "b"}, {"host": "c"}]})");
+
+    uconfig::RapidjsonFormat<> format;
+    const auto changes = uconfig::Diff(format, before, after);
+    ProxyConfig emitted_config = after;
+    rapidjson::Document emitted;
+    emitted_config.Emit(format, "", &emitted);
+
+    rapidjson::Document patch;
+    format.EmitPatch(changes, &emitted, &patch);
+    ASSERT_TRUE(patch.IsArray());
+    ASSERT_EQ(patch.Size(), 3);
+
+    ASSERT_STREQ(patch[0]["op"].GetString(), "remove");
+    ASSERT_STREQ(patch[0]["path"].GetString(), "/ports/1");
+    ASSERT_FALSE(patch[0].HasMember("value"));
+
+    ASSERT_STREQ(patch[1]["op"].GetString(), "replace");
+    ASSERT_STREQ(patch[1]["path"].GetString(), "/upstreams/0/host");
+    ASSERT_STREQ(patch[1]["value"].GetString(), "b");
+
+    ASSERT_STREQ(patch[2]["op"].GetString(), "add");
+    ASSERT_STREQ(patch[2]["path"].GetString(), "/upstreams/1");
+    ASSERT_STREQ(patch[2]["value"]["host"].GetString(), "c");
+    ASSERT_EQ(patch[2]["value"]["weight"].GetUint(), 1u);
+}
+
+TEST(Diff, NotComparable)
+{
+    // values which can be neither compared nor printed are always reported
+    const Endpoint endpoint{"localhost", 80};
+    std::vector<uconfig::Change> changes;
+    uconfig::detail::diff_values(uconfig::EnvFormat{}, "ENDPOINT", &endpoint, &endpoint, &changes);
+    ASSERT_EQ(changes.size(), 1);
+    ASSERT_EQ(changes[0].kind, uconfig::Change::Kind::Replaced);
+    ASSERT_TRUE(changes[0].old_value.empty());
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,233 @@
+#include "uconfig/format/Dir.h"
+#include "uconfig/uconfig.h"
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* Each file holds a single value, as in mounted ConfigMaps */
+
+static std::string root;
+
+void WriteFile(const std::string& name, const std::string& contents)
+{
+    std::ofstream(root + "/" + name, std::ios::binary) << contents;
+}
+
+void SetDir()
+{
+    char root_template[] = "/tmp/uconfig_dir_XXXXXX";
+    root = ::mkdtemp(root_template);
+
+    // Kubernetes-like layout: keys are symlinks into the hidden data folder
+    ::mkdir((root + "/..data").c_str(), 0700);
+    std::ofstream(root + "/..data/db.host") << "localhost\n";
+    ::symlink("..data/db.host", (root + "/db.host").c_str());
+
+    WriteFile("db.port", "5432\n");
+    WriteFile("string", "value");
+    WriteFile("posinteger", "123");
+    WriteFile("neginteger", "-123");
+    WriteFile("posdouble", "123456.789");
+    WriteFile("boolean", "true");
+    WriteFile("empty", "");
+    WriteFile("hosts.0", "a.example.com\n");
+    WriteFile("hosts.1", "b.example.com\n");
+    WriteFile("large", std::string(100, 'x'));
+    ::mkdir((root + "/subdir").c_str(), 0700);
+}
+
+void ClearDir()
+{
+    for (const auto* name : {"db.port", "string", "posinteger", "neginteger", "posdouble", "boolean", "empty",
+                             "hosts.0", "hosts.1", "large", "db.host", "..data/db.host"}) {
+        std::remove((root + "/" + name).c_str());
+    }
+    ::rmdir((root + "/..data").c_str());
+    ::rmdir((root + "/subdir").c_str());
+    ::rmdir(root.c_str());
+}
+
+template <typename T>
+testing::AssertionResult Parsed(const uconfig::DirSource& dir, const std::string& name, const T& expected_value)
+{
+    std::optional<T> value = uconfig::DirFormat{}.Parse<T>(&dir, name);
+    if (!value.has_value()) {
+        return ::testing::AssertionFailure() << "'" << name << "' file was not parsed";
+    }
+
+    if (*value != expected_value) {
+        return ::testing::AssertionFailure() << "'" << name << "' file value '" << *value
+                                             << "' differs from expected '" << expected_value << "'";
+    }
+
+    return testing::AssertionSuccess();
+}
+
+template <typename T>
+testing::AssertionResult NotParsed(const uconfig::DirSource& dir, const std::string& name)
+{
+    std::optional<T> value = uconfig::DirFormat{}.Parse<T>(&dir, name);
+    if (value.has_value()) {
+        return ::testing::AssertionFailure() << "'" << name << "' file was parsed";
+    }
+
+    return testing::AssertionSuccess();
+}
+
+struct DbConfig: public uconfig::Config<uconfig::DirFormat>
+{
+    uconfig::Variable<std::string> host;
+    uconfig::Variable<unsigned> port;
+    uconfig::Vector<std::string> hosts;
+    uconfig::Variable<unsigned> timeout_ms{100};
+
+    using uconfig::Config<uconfig::DirFormat>::Config;
+
+    virtual void Init(const std::string& config_path) override
+    {
+        Register<uconfig::DirFormat>(config_path + ".host", &host);
+        Register<uconfig::DirFormat>(config_path + ".port", &port);
+        Register<uconfig::DirFormat>("hosts", &hosts);
+        Register<uconfig::DirFormat>(config_path + ".timeout_ms", &timeout_ms);
+    }
+};
+
+TEST(Dir, Index)
+{
+    const uconfig::DirSource dir{root};
+
+    ASSERT_EQ(dir.Root(), root);
+    ASSERT_EQ(dir.Size(), 11);
+    ASSERT_FALSE(dir.Get("..data"));
+    ASSERT_FALSE(dir.Get("subdir"));
+    ASSERT_EQ(dir.Get("empty"), std::string_view(""));
+    ASSERT_THROW(uconfig::DirSource{root + "/absent"}, uconfig::ParseError);
+}
+
+TEST(Dir, ParseValue)
+{
+    const uconfig::DirSource dir{root};
+
+    ASSERT_TRUE(Parsed<std::string>(dir, "db.host", "localhost"));
+    ASSERT_TRUE(Parsed<std::string>(dir, "string", "value"));
+    ASSERT_TRUE(Parsed<std::string>(dir, "empty", ""));
+    ASSERT_TRUE(Parsed<int>(dir, "posinteger", 123));
+    ASSERT_TRUE(Parsed<int>(dir, "neginteger", -123));
+    ASSERT_TRUE(Parsed<unsigned>(dir, "db.port", 5432));
+    ASSERT_TRUE(Parsed<double>(dir, "posdouble", 123456.789));
+    ASSERT_TRUE(Parsed<bool>(dir, "boolean", true));
+
+    ASSERT_TRUE(NotParsed<std::string>(dir, "absent"));
+    ASSERT_TRUE(NotParsed<int>(dir, "string"));
+    ASSERT_TRUE(NotParsed<int>(dir, "posdouble"));
+    ASSERT_TRUE(NotParsed<unsigned>(dir, "neginteger"));
+    ASSERT_TRUE(NotParsed<bool>(dir, "posinteger"));
+}
+
+TEST(Dir, ParseMapped)
+{
+    uconfig::DirSource mapped{root, 10};
+    const uconfig::DirSource read{root};
+
+    ASSERT_TRUE(Parsed<std::string>(mapped, "large", std::string(100, 'x')));
+    ASSERT_TRUE(Parsed<std::string>(mapped, "string", "value"));
+    ASSERT_TRUE(Parsed<std::string>(read, "large", std::string(100, 'x')));
+
+    uconfig::DirSource moved{std::move(mapped)};
+    ASSERT_TRUE(Parsed<std::string>(moved, "large", std::string(100, 'x')));
+}
+
+TEST(Dir, ParseLoaded)
+{
+    // small files are read in a single batch, large ones are still mapped
+    uconfig::FileLoader loader;
+    const uconfig::DirSource dir{root, loader, 10};
+
+    ASSERT_EQ(dir.Size(), 11);
+    ASSERT_TRUE(Parsed<std::string>(dir, "db.host", "localhost"));
+    ASSERT_TRUE(Parsed<std::string>(dir, "empty", ""));
+    ASSERT_TRUE(Parsed<unsigned>(dir, "db.port", 5432));
+    ASSERT_TRUE(Parsed<std::string>(dir, "large", std::string(100, 'x')));
+    ASSERT_TRUE(Parsed<std::string>(dir, "hosts.1", "b.example.com"));
+
+    uconfig::FileLoader threads_loader(uconfig::FileLoader::Backend::Threads);
+    const uconfig::DirSource threads_dir{root, threads_loader};
+    ASSERT_TRUE(Parsed<bool>(threads_dir, "boolean", true));
+    ASSERT_TRUE(Parsed<std::string>(threads_dir, "large", std::string(100, 'x')));
+}
+
+TEST(Dir, ParseVersioned)
+{
+    // Kubernetes layout: `..data` is swapped to a new version of all the files at once
+    char root_template[] = "/tmp/uconfig_dir_XXXXXX";
+    const std::string versioned_root = ::mkdtemp(root_template);
+    for (const std::string version : {"1", "2"}) {
+        ::mkdir((versioned_root + "/..v" + version).c_str(), 0700);
+        std::ofstream(versioned_root + "/..v" + version + "/db.port") << version << "\n";
+        std::ofstream(versioned_root + "/..v" + version + "/large") << std::string(100, version[0]);
+    }
+    ::symlink("..v1", (versioned_root + "/..data").c_str());
+    ::symlink("..data/db.port", (versioned_root + "/db.port").c_str());
+    ::symlink("..data/large", (versioned_root + "/large").c_str());
+
+    const uconfig::DirSource dir{versioned_root, 10};
+    ASSERT_EQ(dir.Size(), 2);
+
+    ::symlink("..v2", (versioned_root + "/..data_tmp").c_str());
+    std::rename((versioned_root + "/..data_tmp").c_str(), (versioned_root + "/..data").c_str());
+    // old version is removed, but its' files are already read or mapped
+    std::remove((versioned_root + "/..v1/db.port").c_str());
+    std::remove((versioned_root + "/..v1/large").c_str());
+    ::rmdir((versioned_root + "/..v1").c_str());
+    ASSERT_TRUE(Parsed<unsigned>(dir, "db.port", 1));
+    ASSERT_TRUE(Parsed<std::string>(dir, "large", std::string(100, '1')));
+
+    uconfig::FileLoader loader;
+    const uconfig::DirSource updated_dir{versioned_root, loader, 10};
+    ASSERT_TRUE(Parsed<unsigned>(updated_dir, "db.port", 2));
+    ASSERT_TRUE(Parsed<std::string>(updated_dir, "large", std::string(100, '2')));
+
+    for (const auto* name : {"db.port", "large", "..data", "..v2/db.port", "..v2/large"}) {
+        std::remove((versioned_root + "/" + name).c_str());
+    }
+    ::rmdir((versioned_root + "/..v2").c_str());
+    ::rmdir(versioned_root.c_str());
+}
+
+TEST(Dir, ParseEmitConfig)
+{
+    const uconfig::DirSource dir{root};
+    uconfig::DirFormat format;
+
+    DbConfig config;
+    ASSERT_TRUE(config.Parse(format, "db", &dir));
+    ASSERT_TRUE(config.Initialized());
+
+    ASSERT_EQ(config.host, "localhost");
+    ASSERT_EQ(config.port, 5432);
+    ASSERT_EQ(config.hosts, std::vector<std::string>({"a.example.com", "b.example.com"}));
+    ASSERT_EQ(config.timeout_ms, 100);
+
+    std::map<std::string, std::string> dir_dest;
+    ASSERT_NO_THROW(config.Emit(format, "db", &dir_dest));
+    ASSERT_EQ(dir_dest, (std::map<std::string, std::string>{{"db.host", "localhost"},
+                                                             {"db.port", "5432"},
+                                                             {"db.timeout_ms", "100"},
+                                                             {"hosts.0", "a.example.com"},
+                                                             {"hosts.1", "b.example.com"}}));
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    SetDir();
+    auto result = RUN_ALL_TESTS();
+    ClearDir();
+
+    return result;
+}
@@ -1,6 +1,9 @@
 #include "uconfig/format/Env.h"
+#include "uconfig/uconfig.h"
 #include "gtest/gtest.h"
 
+#include <thread>
+
 /* Since env values are just string we try to convert if possible */
 
 static const std::map<std::string, std::string> env_source = {
@@ -190,6 +193,152 @@ TEST(Env, ParseEmitValue)
     ASSERT_EQ(env_dest, env_source);
 }
 
+struct ServerConfig: public uconfig::Config<uconfig::EnvFormat>
+{
+    uconfig::Variable<std::string> host;
+    uconfig::Variable<int> port{80};
+    uconfig::Vector<int> ports{true};
+
+    using uconfig::Config<uconfig::EnvFormat>::Config;
+
+    virtual void Init(const std::string& config_path) override
+    {
+        Register<uconfig::EnvFormat>(config_path + "_HOST", &host);
+        Register<uconfig::EnvFormat>(config_path + "_PORT", &port);
+        Register<uconfig::EnvFormat>(config_path + "_PORTS", &ports);
+    }
+};
+
+TEST(Env, ParseTable)
+{
+    ClearEnv();
+
+    // emitted variables are parsed back without touching the process environment
+    const auto table = uconfig::FlatKvTable::FromEnv(env_source);
+    uconfig::EnvFormat format;
+    ASSERT_EQ(format.Parse<std::string>(&table, "STRING"), "value");
+    ASSERT_EQ(format.Parse<long int>(&table, "NEGLONGINTEGER"), -123456789000);
+    ASSERT_EQ(format.Parse<double>(&table, "POSDOUBLE"), 123456.789);
+    ASSERT_FALSE(format.Parse<int>(&table, "POSDOUBLE").has_value());
+    ASSERT_FALSE(format.Parse<int>(&table, "ABSENT").has_value());
+    ASSERT_TRUE(NotParsed<std::string>("STRING"));
+
+    const char* envp[] = {"SERVER_HOST=localhost", "SERVER_PORTS_0=1", "SERVER_PORTS_1=2", nullptr};
+    ServerConfig config;
+    const auto envp_table = uconfig::FlatKvTable::FromEnv(envp);
+    ASSERT_TRUE(config.Parse(format, "SERVER", &envp_table));
+    ASSERT_EQ(config.host, "localhost");
+    ASSERT_EQ(config.port, 80);
+    ASSERT_EQ(config.ports, std::vector<int>({1, 2}));
+
+    const std::string block("SERVER_HOST=remote\0SERVER_PORT=8080\0", 36);
+    const auto block_table = uconfig::FlatKvTable::FromEnvBlock(block);
+    ServerConfig block_config;
+    ASSERT_TRUE(block_config.Parse(format, "SERVER", &block_table));
+    ASSERT_EQ(block_config.host, "remote");
+    ASSERT_EQ(block_config.port, 8080);
+    ASSERT_FALSE(block_config.ports.Initialized());
+}
+
+TEST(Env, ParseTableStrict)
+{
+    const auto table = uconfig::FlatKvTable::FromEnv(
+        std::map<std::string, std::string>{{"SERVER_HOST", "localhost"}, {"SERVER_PROT", "80"}, {"SERVERS", "1"}});
+
+    ServerConfig config;
+    config.SetStrict(true);
+    try {
+        config.Parse(uconfig::EnvFormat{}, "SERVER", &table);
+        FAIL() << "unknown variable was not reported";
+    } catch (const uconfig::ParseError& ex) {
+        ASSERT_NE(std::string(ex.what()).find("SERVER_PROT"), std::string::npos) << ex.what();
+        ASSERT_EQ(std::string(ex.what()).find("SERVERS"), std::string::npos) << ex.what();
+    }
+}
+
+TEST(Env, ParseTableConcurrently)
+{
+    std::vector<uconfig::FlatKvTable> tables;
+    for (int index = 0; index < 8; ++index) {
+        tables.push_back(uconfig::FlatKvTable::FromEnv(std::map<std::string, std::string>{
+            {"SERVER_HOST", "host" + std::to_string(index)}, {"SERVER_PORT", std::to_string(index)}}));
+    }
+
+    std::vector<ServerConfig> configs(tables.size());
+    std::vector<std::thread> threads;
+    for (std::size_t index = 0; index < tables.size(); ++index) {
+        threads.emplace_back([&configs, &tables, index] {
+            configs[index].Parse(uconfig::EnvFormat{}, "SERVER", &tables[index]);
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (std::size_t index = 0; index < tables.size(); ++index) {
+        ASSERT_EQ(configs[index].host, "host" + std::to_string(index));
+        ASSERT_EQ(configs[index].port, static_cast<int>(index));
+    }
+}
+
+struct AppConfig: public uconfig::Config<uconfig::EnvFormat>
+{
+    ServerConfig db;
+    uconfig::LazyConfig<ServerConfig> cache;
+
+    using uconfig::Config<uconfig::EnvFormat>::Config;
+
+    virtual void Init(const std::string& config_path) override
+    {
+        Register<uconfig::EnvFormat>(config_path + "_DB", &db);
+        Register<uconfig::EnvFormat>(config_path + "_CACHE", &cache);
+    }
+};
+
+uconfig::FlatKvTable TypedTable(std::int64_t port)
+{
+    // typed values have no text, as in tables built from other formats
+    uconfig::FlatKvTable table;
+    table.Add("APP_DB_HOST", uconfig::FlatKvTable::Scalar::MakeText("db"));
+    table.Add("APP_DB_PORT", uconfig::FlatKvTable::Scalar::MakeInteger(port));
+    table.Add("APP_CACHE_HOST", uconfig::FlatKvTable::Scalar::MakeString("cache"));
+    table.Add("APP_CACHE_PORT", uconfig::FlatKvTable::Scalar::MakeInteger(port));
+    table.Build();
+    return table;
+}
+
+TEST(Env, ParseTypedTable)
+{
+    auto table = TypedTable(1);
+    AppConfig config;
+    config.SetMemoize(true);
+    ASSERT_TRUE(config.Parse(uconfig::EnvFormat{}, "APP", &table));
+    ASSERT_EQ(config.db.port, 1);
+    ASSERT_EQ(config.cache->host, "cache");
+    ASSERT_EQ(config.cache->port, 1);
+
+    // changed typed value is seen by memoization
+    table = TypedTable(2);
+    const std::size_t skipped = config.Memo().skipped;
+    ASSERT_TRUE(config.Parse(uconfig::EnvFormat{}, "APP", &table));
+    ASSERT_EQ(config.Memo().skipped, skipped);
+    ASSERT_EQ(config.db.port, 2);
+    ASSERT_EQ(config.cache->port, 2);
+
+    // and consumed by strict parse
+    AppConfig strict_config;
+    strict_config.SetStrict(true);
+    ASSERT_TRUE(strict_config.Parse(uconfig::EnvFormat{}, "APP", &table));
+    table.Add("APP_DB_PROT", uconfig::FlatKvTable::Scalar::MakeInteger(3));
+    table.Build();
+    try {
+        strict_config.Parse(uconfig::EnvFormat{}, "APP", &table);
+        FAIL() << "unknown variable was not reported";
+    } catch (const uconfig::ParseError& ex) {
+        ASSERT_NE(std::string(ex.what()).find("APP_DB_PROT"), std::string::npos) << ex.what();
+        ASSERT_EQ(std::string(ex.what()).find("APP_DB_PORT"), std::string::npos) << ex.what();
+    }
+}
+
 int main(int argc, char** argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,111 @@
+#include "uconfig/format/Rapidjson.h"
+#include "uconfig/uconfig.h"
+#include "gtest/gtest.h"
+
+/* Fingerprint depends on the config values only and is cached until the next parse */
+
+struct Limits: public uconfig::Config<uconfig::RapidjsonFormat<>>
+{
+    uconfig::Variable<int> rps{100};
+
+    using uconfig::Config<uconfig::RapidjsonFormat<>>::Config;
+
+    virtual void Init(const std::string& config_path) override
+    {
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/rps", &rps);
+    }
+};
+
+struct ServiceConfig: public uconfig::Config<uconfig::RapidjsonFormat<>>
+{
+    uconfig::Variable<std::string> id{"0"};
+    uconfig::Variable<int> number{0};
+    uconfig::Vector<std::string> hosts{true};
+    Limits limits;
+    uconfig::SharedSection<Limits> shared_limits;
+
+    using uconfig::Config<uconfig::RapidjsonFormat<>>::Config;
+
+    virtual void Init(const std::string& config_path) override
+    {
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/id", &id);
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/number", &number);
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/hosts", &hosts);
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/limits", &limits);
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/shared_limits", &shared_limits);
+    }
+};
+
+std::uint64_t Fingerprint(const char* text)
+{
+    rapidjson::Document json;
+    json.Parse(text);
+    ServiceConfig config;
+    config.Parse(uconfig::RapidjsonFormat<>{}, "", &json);
+    return config.Fingerprint();
+}
+
+TEST(Fingerprint, Values)
+{
+    const auto base = Fingerprint(R"({"id": "1", "number": 1, "hosts": ["a"], "limits": {"rps": 5}})");
+    ASSERT_EQ(base, Fingerprint(R"({"number": 1, "id": "1", "hosts": ["a"], "limits": {"rps": 5}})"));
+
+    ASSERT_NE(base, Fingerprint(R"({"id": "2", "number": 1, "hosts": ["a"], "limits": {"rps": 5}})"));
+    ASSERT_NE(base, Fingerprint(R"({"id": "1", "number": 1, "hosts": ["a", "b"], "limits": {"rps": 5}})"));
+    ASSERT_NE(base, Fingerprint(R"({"id": "1", "number": 1, "limits": {"rps": 5}})"));
+    ASSERT_NE(base, Fingerprint(R"({"id": "1", "number": 1, "hosts": ["a"], "limits": {"rps": 6}})"));
+    ASSERT_NE(base, Fingerprint(R"({"id": "1", "number": 1, "hosts": ["a"], "limits": {"rps": 5},)"
+                                R"( "shared_limits": {"rps": 5}})"));
+    // values are tagged with their kind
+    ASSERT_NE(Fingerprint(R"({"id": "1", "number": 0})"), Fingerprint(R"({"id": "0", "number": 1})"));
+}
+
+TEST(Fingerprint, Cache)
+{
+    rapidjson::Document json;
+    json.Parse(R"({"id": "1", "limits": {"rps": 5}})");
+
+    ServiceConfig config;
+    config.Parse(uconfig::RapidjsonFormat<>{}, "", &json);
+    const auto fingerprint = config.Fingerprint();
+
+    // cached value is kept until the next parse
+    config.id = std::string("2");
+    ASSERT_EQ(config.Fingerprint(), fingerprint);
+
+    json["limits"]["rps"].SetInt(6);
+    config.Parse(uconfig::RapidjsonFormat<>{}, "", &json);
+    ASSERT_NE(config.Fingerprint(), fingerprint);
+
+    json["limits"]["rps"].SetInt(5);
+    config.Parse(uconfig::RapidjsonFormat<>{}, "", &json);
+    ASSERT_EQ(config.Fingerprint(), fingerprint);
+
+    // copies have the same values
+    const ServiceConfig copy = config;
+    ASSERT_EQ(copy.Fingerprint(), fingerprint);
+}
+
+TEST(Fingerprint, Memoized)
+{
+    rapidjson::Document json;
+    json.Parse(R"({"id": "1", "limits": {"rps": 5}})");
+
+    ServiceConfig config;
+    config.SetMemoize(true);
+    config.Parse(uconfig::RapidjsonFormat<>{}, "", &json);
+    const auto fingerprint = config.Fingerprint();
+
+    // skipped sections keep their fingerprints
+    json["id"].SetString("2", json.GetAllocator());
+    config.Parse(uconfig::RapidjsonFormat<>{}, "", &json);
+    ASSERT_EQ(config.Memo().skipped, 1);
+    ASSERT_NE(config.Fingerprint(), fingerprint);
+    ASSERT_EQ(config.Fingerprint(), Fingerprint(R"({"id": "2", "limits": {"rps": 5}})"));
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -14,12 +14,12 @@ struct EnvFormatParam: public FormatParam<EnvTypeParam<ConfigType>>
         return ConfigType{};
     }
 
-    virtual void* Source() override
+    virtual uconfig::FlatKvTable* Source() override
     {
         return nullptr;
     }
 
-    virtual void SetOptional(void*) override
+    virtual void SetOptional(uconfig::FlatKvTable*) override
     {
         std::map<std::string, std::string> env_source;
 
@@ -27,7 +27,7 @@ struct EnvFormatParam: public FormatParam<EnvTypeParam<ConfigType>>
         SetEnv(env_source);
     }
 
-    virtual void SetMandatory(void*) override
+    virtual void SetMandatory(uconfig::FlatKvTable*) override
     {
         std::map<std::string, std::string> env_source;
 
@@ -35,7 +35,7 @@ struct EnvFormatParam: public FormatParam<EnvTypeParam<ConfigType>>
         SetEnv(env_source);
     }
 
-    virtual void SetAll(void* source) override
+    virtual void SetAll(uconfig::FlatKvTable* source) override
     {
         SetOptional(source);
         SetMandatory(source);
@@ -0,0 +1,263 @@
+#include "uconfig/format/FlatKv.h"
+#include "uconfig/format/Rapidjson.h"
+#include "uconfig/uconfig.h"
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <fstream>
+
+/* Values from env and files are untyped text, ones from JSON keep their types */
+
+const rapidjson::Document SetJson()
+{
+    rapidjson::Document json;
+    json.Parse(R"({
+        "string": "value",
+        "quoted": "123",
+        "posinteger": 123,
+        "neginteger": -123,
+        "poslonginteger": 123456789000,
+        "posdouble": 123456.789,
+        "boolean": true,
+        "nulled": null,
+        "a/b~c": 1,
+        "nested": {"key": "nested value"},
+        "objects": [{"name": "a", "port": 80}, {"name": "b", "port": 81}]
+    })");
+    return json;
+}
+
+template <typename T>
+testing::AssertionResult Parsed(const uconfig::FlatKvTable& table, const std::string& path, const T& expected_value)
+{
+    std::optional<T> value = uconfig::FlatKvFormat{}.Parse<T>(&table, path);
+    if (!value.has_value()) {
+        return ::testing::AssertionFailure() << "'" << path << "' table variable was not parsed";
+    }
+
+    if (*value != expected_value) {
+        return ::testing::AssertionFailure() << "'" << path << "' table variable value '" << *value
+                                             << "' differs from expected '" << expected_value << "'";
+    }
+
+    return testing::AssertionSuccess();
+}
+
+template <typename T>
+testing::AssertionResult NotParsed(const uconfig::FlatKvTable& table, const std::string& path)
+{
+    std::optional<T> value = uconfig::FlatKvFormat{}.Parse<T>(&table, path);
+    if (value.has_value()) {
+        return ::testing::AssertionFailure() << "'" << path << "' table variable was parsed";
+    }
+
+    return testing::AssertionSuccess();
+}
+
+struct NodeConfig: public uconfig::Config<uconfig::FlatKvFormat>
+{
+    uconfig::Variable<std::string> name;
+    uconfig::Variable<unsigned> port;
+
+    using uconfig::Config<uconfig::FlatKvFormat>::Config;
+
+    virtual void Init(const std::string& config_path) override
+    {
+        Register<uconfig::FlatKvFormat>(config_path + "/name", &name);
+        Register<uconfig::FlatKvFormat>(config_path + "/port", &port);
+    }
+};
+
+struct AppConfig: public uconfig::Config<uconfig::FlatKvFormat>
+{
+    uconfig::Variable<std::string> string;
+    uconfig::Variable<long> poslonginteger;
+    uconfig::Variable<bool> boolean;
+    uconfig::Vector<NodeConfig> objects;
+    uconfig::Variable<int> absent{42};
+
+    using uconfig::Config<uconfig::FlatKvFormat>::Config;
+
+    virtual void Init(const std::string& config_path) override
+    {
+        Register<uconfig::FlatKvFormat>(config_path + "/string", &string);
+        Register<uconfig::FlatKvFormat>(config_path + "/poslonginteger", &poslonginteger);
+        Register<uconfig::FlatKvFormat>(config_path + "/boolean", &boolean);
+        Register<uconfig::FlatKvFormat>(config_path + "/objects", &objects);
+        Register<uconfig::FlatKvFormat>(config_path + "/absent", &absent);
+    }
+};
+
+TEST(FlatKv, Build)
+{
+    using Scalar = uconfig::FlatKvTable::Scalar;
+
+    uconfig::FlatKvTable table;
+    table.Add("b", Scalar::MakeInteger(1));
+    table.Add("a", Scalar::MakeString("first"));
+    table.Add("a", Scalar::MakeString("second"));
+    ASSERT_EQ(table.Size(), 0);
+    ASSERT_FALSE(table.Find("a"));
+
+    table.Build();
+    ASSERT_EQ(table.Size(), 2);
+    ASSERT_EQ(table.Key(0), "a");
+    ASSERT_TRUE(Parsed<std::string>(table, "a", "second"));
+    ASSERT_TRUE(Parsed<int>(table, "b", 1));
+
+    table.Add("b", Scalar::MakeInteger(2));
+    table.Add("ab", Scalar::MakeNull());
+    ASSERT_TRUE(Parsed<int>(table, "b", 1));
+    table.Build();
+    ASSERT_EQ(table.Size(), 3);
+    ASSERT_TRUE(Parsed<int>(table, "b", 2));
+    ASSERT_TRUE(NotParsed<int>(table, "ab"));
+}
+
+TEST(FlatKv, Range)
+{
+    const uconfig::FlatKvTable table = uconfig::FlatKvTable::FromJson(SetJson());
+
+    auto [first, last] = table.Range("/objects/");
+    ASSERT_EQ(last - first, 4);
+    ASSERT_EQ(table.Key(first), "/objects/0/name");
+    ASSERT_EQ(table.Key(last - 1), "/objects/1/port");
+
+    auto [none_first, none_last] = table.Range("/absent");
+    ASSERT_EQ(none_first, none_last);
+    auto [all_first, all_last] = table.Range("");
+    ASSERT_EQ(all_last - all_first, table.Size());
+}
+
+TEST(FlatKv, Image)
+{
+    const uconfig::FlatKvTable table = uconfig::FlatKvTable::FromJson(SetJson());
+
+    std::vector<std::uint64_t> image(table.ImageSize() / sizeof(std::uint64_t) + 1);
+    table.WriteImage(image.data());
+
+    uconfig::FlatKvTable image_table = uconfig::FlatKvTable::FromImage(image.data(), table.ImageSize());
+    ASSERT_EQ(image_table.Size(), table.Size());
+    ASSERT_TRUE(Parsed<std::string>(image_table, "/objects/1/name", "b"));
+    ASSERT_TRUE(Parsed<long>(image_table, "/poslonginteger", 123456789000));
+    ASSERT_TRUE(Parsed<double>(image_table, "/posdouble", 123456.789));
+
+    // modified table does not refer to the image anymore
+    image_table.Add("/added", uconfig::FlatKvTable::Scalar::MakeBool(false));
+    image_table.Build();
+    image.assign(image.size(), 0);
+    ASSERT_TRUE(Parsed<std::string>(image_table, "/string", "value"));
+    ASSERT_TRUE(Parsed<bool>(image_table, "/added", false));
+
+    ASSERT_THROW(uconfig::FlatKvTable::FromImage(image.data(), table.ImageSize()), uconfig::ParseError);
+    ASSERT_THROW(uconfig::FlatKvTable::FromImage(image.data(), 8), uconfig::ParseError);
+}
+
+TEST(FlatKv, ParseJson)
+{
+    const uconfig::FlatKvTable table = uconfig::FlatKvTable::FromJson(SetJson());
+
+    ASSERT_TRUE(Parsed<std::string>(table, "/string", "value"));
+    ASSERT_TRUE(Parsed<std::string>(table, "/quoted", "123"));
+    ASSERT_TRUE(Parsed<std::string>(table, "/nested/key", "nested value"));
+    ASSERT_TRUE(Parsed<int>(table, "/posinteger", 123));
+    ASSERT_TRUE(Parsed<int>(table, "/neginteger", -123));
+    ASSERT_TRUE(Parsed<unsigned>(table, "/posinteger", 123));
+    ASSERT_TRUE(Parsed<long>(table, "/poslonginteger", 123456789000));
+    ASSERT_TRUE(Parsed<double>(table, "/posinteger", 123));
+    ASSERT_TRUE(Parsed<double>(table, "/posdouble", 123456.789));
+    ASSERT_TRUE(Parsed<bool>(table, "/boolean", true));
+    ASSERT_TRUE(Parsed<int>(table, "/a~1b~0c", 1));
+
+    ASSERT_TRUE(NotParsed<int>(table, "/quoted"));
+    ASSERT_TRUE(NotParsed<std::string>(table, "/posinteger"));
+    ASSERT_TRUE(NotParsed<int>(table, "/poslonginteger"));
+    ASSERT_TRUE(NotParsed<unsigned>(table, "/neginteger"));
+    ASSERT_TRUE(NotParsed<int>(table, "/posdouble"));
+    ASSERT_TRUE(NotParsed<float>(table, "/posdouble"));
+    ASSERT_TRUE(NotParsed<bool>(table, "/posinteger"));
+    ASSERT_TRUE(NotParsed<std::string>(table, "/nulled"));
+    ASSERT_TRUE(NotParsed<std::string>(table, "/nested"));
+}
+
+TEST(FlatKv, ParseText)
+{
+    const char* const envp[] = {"STRING=value", "POSINTEGER=123", "NEGINTEGER=-123", "POSDOUBLE=123456.789",
+                                "BOOLEAN=false", "EMPTY=", "ARRAY_0=a=b", "ARRAY_1=c", "NOVALUE", nullptr};
+    const uconfig::FlatKvTable table = uconfig::FlatKvTable::FromEnv(envp);
+
+    ASSERT_EQ(table.Size(), 8);
+    ASSERT_TRUE(Parsed<std::string>(table, "STRING", "value"));
+    ASSERT_TRUE(Parsed<std::string>(table, "POSINTEGER", "123"));
+    ASSERT_TRUE(Parsed<std::string>(table, "EMPTY", ""));
+    ASSERT_TRUE(Parsed<std::string>(table, "ARRAY_0", "a=b"));
+    ASSERT_TRUE(Parsed<int>(table, "POSINTEGER", 123));
+    ASSERT_TRUE(Parsed<int>(table, "NEGINTEGER", -123));
+    ASSERT_TRUE(Parsed<double>(table, "POSDOUBLE", 123456.789));
+    ASSERT_TRUE(Parsed<bool>(table, "BOOLEAN", false));
+
+    ASSERT_TRUE(NotParsed<int>(table, "STRING"));
+    ASSERT_TRUE(NotParsed<int>(table, "POSDOUBLE"));
+    ASSERT_TRUE(NotParsed<unsigned>(table, "NEGINTEGER"));
+    ASSERT_TRUE(NotParsed<std::string>(table, "NOVALUE"));
+
+    uconfig::Vector<std::string> array;
+    uconfig::VectorIface<std::string, uconfig::FlatKvFormat> iface("ARRAY", &array);
+    ASSERT_TRUE(iface.Parse(uconfig::FlatKvFormat{"_"}, &table));
+    ASSERT_EQ(array, std::vector<std::string>({"a=b", "c"}));
+}
+
+TEST(FlatKv, ParseLines)
+{
+    const std::string file_path = "flatkv_test.properties";
+    std::ofstream(file_path) << "# comment\n"
+                                "\n"
+                                "  db.host = localhost\r\n"
+                                "db.port=5432\n";
+
+    const uconfig::FlatKvTable table = uconfig::FlatKvTable::FromFile(file_path);
+    std::remove(file_path.c_str());
+
+    ASSERT_EQ(table.Size(), 2);
+    ASSERT_TRUE(Parsed<std::string>(table, "db.host", " localhost"));
+    ASSERT_TRUE(Parsed<unsigned>(table, "db.port", 5432));
+
+    ASSERT_THROW(uconfig::FlatKvTable::FromLines("key=value\nnovalue\n"), uconfig::ParseError);
+    ASSERT_THROW(uconfig::FlatKvTable::FromLines("=value\n"), uconfig::ParseError);
+    ASSERT_THROW(uconfig::FlatKvTable::FromFile(file_path), uconfig::ParseError);
+}
+
+TEST(FlatKv, ParseEmitConfig)
+{
+    const uconfig::FlatKvTable table = uconfig::FlatKvTable::FromJson(SetJson());
+    uconfig::FlatKvFormat format;
+
+    AppConfig config;
+    ASSERT_TRUE(config.Parse(format, "", &table));
+    ASSERT_TRUE(config.Initialized());
+
+    ASSERT_EQ(config.string, "value");
+    ASSERT_EQ(config.poslonginteger, 123456789000);
+    ASSERT_EQ(config.boolean, true);
+    ASSERT_EQ(config.objects->size(), 2);
+    ASSERT_EQ(config.objects[1].name, "b");
+    ASSERT_EQ(config.objects[1].port, 81);
+    ASSERT_EQ(config.absent, 42);
+
+    uconfig::FlatKvTable emitted;
+    ASSERT_NO_THROW(config.Emit(format, "", &emitted));
+    emitted.Build();
+    ASSERT_EQ(emitted.Size(), 8);
+
+    AppConfig reparsed;
+    ASSERT_TRUE(reparsed.Parse(format, "", &emitted));
+    ASSERT_EQ(reparsed.poslonginteger, 123456789000);
+    ASSERT_EQ(reparsed.objects[0].port, 80);
+    ASSERT_EQ(reparsed.absent, 42);
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,168 @@
+#include "uconfig/History.h"
+#include "uconfig/format/Rapidjson.h"
+#include "uconfig/uconfig.h"
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <thread>
+
+/* Versions share unchanged sections and vectors, rollback re-commits a retained version */
+
+struct LimitsConfig: public uconfig::Config<uconfig::RapidjsonFormat<>>
+{
+    uconfig::Variable<unsigned> rps;
+    uconfig::Variable<unsigned> burst{10};
+
+    using uconfig::Config<uconfig::RapidjsonFormat<>>::Config;
+
+    virtual void Init(const std::string& config_path) override
+    {
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/rps", &rps);
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/burst", &burst);
+    }
+
+    virtual void Validate() const override
+    {
+        if (*rps == 0) {
+            throw std::runtime_error("rps is zero");
+        }
+    }
+};
+
+struct ServiceConfig: public uconfig::Config<uconfig::RapidjsonFormat<>>
+{
+    uconfig::SharedSection<LimitsConfig> limits;
+    uconfig::SharedSection<LimitsConfig> extra_limits{true};
+    uconfig::SharedVector<std::string> hosts;
+
+    using uconfig::Config<uconfig::RapidjsonFormat<>>::Config;
+
+    virtual void Init(const std::string& config_path) override
+    {
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/limits", &limits);
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/extra_limits", &extra_limits);
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/hosts", &hosts);
+    }
+};
+
+rapidjson::Document MakeJson(const char* text)
+{
+    rapidjson::Document json;
+    json.Parse(text);
+    return json;
+}
+
+TEST(History, SharedSection)
+{
+    const auto json = MakeJson(R"({"limits": {"rps": 100}, "hosts": ["a", "b"]})");
+
+    ServiceConfig config;
+    ASSERT_TRUE(config.Parse(uconfig::RapidjsonFormat<>{}, "", &json));
+    ASSERT_EQ(config.limits->rps, 100u);
+    ASSERT_EQ(config.limits->burst, 10u);
+    ASSERT_TRUE(config.limits.Initialized());
+    ASSERT_FALSE(config.extra_limits.Initialized());
+
+    // unchanged section keeps the storage, changed one gets a new one
+    const ServiceConfig previous = config;
+    const auto changed_json = MakeJson(R"({"limits": {"rps": 100}, "hosts": ["a", "c"]})");
+    ASSERT_TRUE(config.Parse(uconfig::RapidjsonFormat<>{}, "", &changed_json));
+    ASSERT_EQ(previous.limits.Storage(), config.limits.Storage());
+    ASSERT_NE(previous.hosts.Storage(), config.hosts.Storage());
+
+    const auto limits_json = MakeJson(R"({"limits": {"rps": 200, "burst": 20}, "hosts": ["a", "c"]})");
+    ASSERT_TRUE(config.Parse(uconfig::RapidjsonFormat<>{}, "", &limits_json));
+    ASSERT_NE(previous.limits.Storage(), config.limits.Storage());
+    ASSERT_EQ(previous.limits->rps, 100u);
+    ASSERT_EQ(config.limits->rps, 200u);
+
+    config.limits.Mutable().burst = 30;
+    ASSERT_EQ(config.limits->burst, 30u);
+
+    rapidjson::Document emitted;
+    config.Emit(uconfig::RapidjsonFormat<>{}, "", &emitted);
+    ASSERT_EQ(emitted["limits"]["burst"].GetUint(), 30u);
+
+    // invalid section keeps the previous storage
+    const auto storage = config.limits.Storage();
+    const auto invalid_json = MakeJson(R"({"limits": {"rps": 0}, "hosts": ["a"]})");
+    ASSERT_THROW(config.Parse(uconfig::RapidjsonFormat<>{}, "", &invalid_json), uconfig::ParseError);
+    ASSERT_EQ(config.limits.Storage(), storage);
+}
+
+TEST(History, SharedInPlace)
+{
+    const auto json = MakeJson(R"({"limits": {"rps": 100}, "hosts": ["a", "b"]})");
+    const auto changed_json = MakeJson(R"({"limits": {"rps": 200}, "hosts": ["a", "b"]})");
+    ServiceConfig config;
+    ServiceConfig changed;
+    ASSERT_TRUE(config.Parse(uconfig::RapidjsonFormat<>{}, "", &json));
+    ASSERT_TRUE(changed.Parse(uconfig::RapidjsonFormat<>{}, "", &changed_json));
+    const std::uint64_t fingerprint = ServiceConfig(config).Fingerprint();
+    const std::uint64_t changed_fingerprint = ServiceConfig(changed).Fingerprint();
+    ASSERT_NE(fingerprint, changed_fingerprint);
+
+    // copies emit, compare and hash the shared storages in place
+    std::atomic<int> matched{0};
+    std::vector<std::thread> threads;
+    for (int thread = 0; thread < 8; ++thread) {
+        threads.emplace_back([&config, &changed, &matched, fingerprint] {
+            ServiceConfig copy = config;
+            ServiceConfig changed_copy = changed;
+            rapidjson::Document emitted;
+            copy.Emit(uconfig::RapidjsonFormat<>{}, "", &emitted);
+            const auto changes = uconfig::Diff(uconfig::RapidjsonFormat<>{}, copy, changed_copy);
+            if (emitted["limits"]["rps"].GetUint() == 100 && copy.Fingerprint() == fingerprint &&
+                changes.size() == 1 && changes[0].path == "/limits/rps") {
+                ++matched;
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQ(matched, 8);
+
+    // fingerprints cached in the storage do not hide modifications
+    ServiceConfig modified;
+    ASSERT_TRUE(modified.Parse(uconfig::RapidjsonFormat<>{}, "", &json));
+    ASSERT_EQ(ServiceConfig(modified).Fingerprint(), fingerprint);
+    modified.limits.Mutable().rps = 200;
+    ASSERT_EQ(ServiceConfig(modified).Fingerprint(), changed_fingerprint);
+}
+
+TEST(History, CommitRollback)
+{
+    uconfig::ConfigHistory<ServiceConfig> history(3);
+    ASSERT_EQ(history.Current(), nullptr);
+    ASSERT_EQ(history.CurrentVersion(), 0);
+
+    ServiceConfig config;
+    for (unsigned rps = 1; rps <= 4; ++rps) {
+        const auto json = MakeJson(
+            (R"({"limits": {"rps": )" + std::to_string(rps) + R"(}, "hosts": ["a", "b"]})").c_str());
+        ASSERT_TRUE(config.Parse(uconfig::RapidjsonFormat<>{}, "", &json));
+        ASSERT_EQ(history.Commit(config), rps);
+    }
+
+    ASSERT_EQ(history.Versions(), (std::vector<std::uint64_t>{2, 3, 4}));
+    ASSERT_EQ(history.Get(1), nullptr);
+    ASSERT_EQ(history.Get(5), nullptr);
+    // unchanged vector is stored once for all the versions
+    ASSERT_EQ(history.Get(2)->hosts.Storage(), history.Get(4)->hosts.Storage());
+    ASSERT_EQ(history.Get(3)->limits->rps, 3u);
+
+    const auto rolled_back = history.Get(2);
+    const auto snapshot = history.Rollback(2);
+    ASSERT_EQ(snapshot, rolled_back);
+    ASSERT_EQ(history.Current(), snapshot);
+    ASSERT_EQ(history.CurrentVersion(), 5);
+    ASSERT_EQ(history.Versions(), (std::vector<std::uint64_t>{3, 4, 5}));
+    ASSERT_THROW(history.Rollback(2), std::out_of_range);
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,132 @@
+#include "uconfig/format/Env.h"
+#include "uconfig/format/Rapidjson.h"
+#include "uconfig/format/Yaml.h"
+#include "uconfig/uconfig.h"
+#include "gtest/gtest.h"
+
+#include <cstdlib>
+
+/* Equal interned strings share the storage of the config pool */
+
+struct HostConfig: public uconfig::Config<uconfig::RapidjsonFormat<>, uconfig::YamlFormat, uconfig::EnvFormat>
+{
+    uconfig::Variable<uconfig::InternedString> region;
+    uconfig::Vector<uconfig::InternedString> hosts;
+
+    using uconfig::Config<uconfig::RapidjsonFormat<>, uconfig::YamlFormat, uconfig::EnvFormat>::Config;
+
+    virtual void Init(const std::string& config_path) override
+    {
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/region", &region);
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/hosts", &hosts);
+        Register<uconfig::YamlFormat>(config_path + "/region", &region);
+        Register<uconfig::YamlFormat>(config_path + "/hosts", &hosts);
+        Register<uconfig::EnvFormat>(config_path + "_REGION", &region);
+        Register<uconfig::EnvFormat>(config_path + "_HOSTS", &hosts);
+    }
+};
+
+struct ClusterConfig: public uconfig::Config<uconfig::RapidjsonFormat<>, uconfig::YamlFormat, uconfig::EnvFormat>
+{
+    HostConfig primary;
+    HostConfig secondary;
+
+    using uconfig::Config<uconfig::RapidjsonFormat<>, uconfig::YamlFormat, uconfig::EnvFormat>::Config;
+
+    virtual void Init(const std::string& config_path) override
+    {
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/primary", &primary);
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/secondary", &secondary);
+        Register<uconfig::YamlFormat>(config_path + "/primary", &primary);
+        Register<uconfig::YamlFormat>(config_path + "/secondary", &secondary);
+        Register<uconfig::EnvFormat>(config_path + "_PRIMARY", &primary);
+        Register<uconfig::EnvFormat>(config_path + "_SECONDARY", &secondary);
+    }
+};
+
+TEST(Intern, Rapidjson)
+{
+    rapidjson::Document json;
+    json.Parse(R"({"primary": {"region": "eu", "hosts": ["a", "b", "a", "eu"]},
+                   "secondary": {"region": "eu", "hosts": ["b", "b"]}})");
+
+    ClusterConfig config;
+    config.SetInterning(true);
+    ASSERT_EQ(config.StringPool(), nullptr);
+    ASSERT_TRUE(config.Parse(uconfig::RapidjsonFormat<>{}, "", &json));
+
+    ASSERT_EQ(config.primary.region, "eu");
+    ASSERT_EQ(config.primary.hosts[0], "a");
+    ASSERT_EQ(config.secondary.hosts[1], "b");
+    // equal strings share the storage across sections
+    ASSERT_EQ(&config.primary.region->Get(), &config.secondary.region->Get());
+    ASSERT_EQ(&config.primary.hosts[0].Get(), &config.primary.hosts[2].Get());
+    ASSERT_EQ(&config.primary.hosts[3].Get(), &config.secondary.region->Get());
+    ASSERT_EQ(&config.primary.hosts[1].Get(), &config.secondary.hosts[0].Get());
+    ASSERT_EQ(config.StringPool()->Size(), 3);
+    ASSERT_EQ(config.StringPool()->Bytes(), 4);
+
+    // strings keep the pool alive
+    const uconfig::InternedString region = *config.primary.region;
+    config.SetInterning(false);
+    ASSERT_TRUE(config.Parse(uconfig::RapidjsonFormat<>{}, "", &json));
+    ASSERT_NE(&config.primary.region->Get(), &config.secondary.region->Get());
+    ASSERT_EQ(region, "eu");
+
+    rapidjson::Document emitted;
+    config.Emit(uconfig::RapidjsonFormat<>{}, "", &emitted);
+    ASSERT_EQ(emitted, json);
+}
+
+TEST(Intern, Yaml)
+{
+    const uconfig::YamlDocument yaml(
+        "primary:\n  region: eu\n  hosts:\n    - a\n    - 'a'\nsecondary:\n  region: eu\n");
+
+    ClusterConfig config;
+    config.SetInterning(true);
+    ASSERT_TRUE(config.Parse(uconfig::YamlFormat{}, "", &yaml, false));
+    ASSERT_EQ(&config.primary.hosts[0].Get(), &config.primary.hosts[1].Get());
+    ASSERT_EQ(&config.primary.region->Get(), &config.secondary.region->Get());
+    ASSERT_EQ(config.StringPool()->Size(), 2);
+}
+
+TEST(Intern, Env)
+{
+    ::setenv("CLUSTER_PRIMARY_REGION", "eu", 1);
+    ::setenv("CLUSTER_SECONDARY_REGION", "eu", 1);
+
+    ClusterConfig config;
+    config.SetInterning(true);
+    ASSERT_TRUE(config.Parse(uconfig::EnvFormat{}, "CLUSTER", nullptr, false));
+    ASSERT_EQ(&config.primary.region->Get(), &config.secondary.region->Get());
+
+    ::unsetenv("CLUSTER_PRIMARY_REGION");
+    ::unsetenv("CLUSTER_SECONDARY_REGION");
+}
+
+TEST(Intern, ParallelVector)
+{
+    rapidjson::Document json{rapidjson::kObjectType};
+    rapidjson::Value hosts{rapidjson::kArrayType};
+    for (std::size_t index = 0; index < 1000; ++index) {
+        hosts.PushBack(rapidjson::Value("host-" + std::to_string(index % 10), json.GetAllocator()),
+                       json.GetAllocator());
+    }
+    json.AddMember("region", "eu", json.GetAllocator());
+    json.AddMember("hosts", hosts, json.GetAllocator());
+
+    HostConfig config;
+    config.SetInterning(true);
+    config.hosts.SetParallel(4, 16);
+    ASSERT_TRUE(config.Parse(uconfig::RapidjsonFormat<>{}, "", &json));
+    ASSERT_EQ(config.hosts->size(), 1000);
+    ASSERT_EQ(config.hosts[999], "host-9");
+    ASSERT_EQ(config.StringPool()->Size(), 11);
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
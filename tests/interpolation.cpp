@@ -0,0 +1,151 @@
+#include "uconfig/format/Env.h"
+#include "uconfig/format/Rapidjson.h"
+#include "uconfig/uconfig.h"
+#include "gtest/gtest.h"
+
+#include <cstdlib>
+
+/* Placeholders of string values are substituted once during the parse */
+
+struct Endpoint: public uconfig::Config<uconfig::RapidjsonFormat<>>
+{
+    uconfig::Variable<std::string> url{""};
+    uconfig::Variable<int> port{80};
+
+    using uconfig::Config<uconfig::RapidjsonFormat<>>::Config;
+
+    virtual void Init(const std::string& config_path) override
+    {
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/url", &url);
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/port", &port);
+    }
+};
+
+struct ServiceConfig: public uconfig::Config<uconfig::RapidjsonFormat<>>
+{
+    uconfig::Variable<std::string> host;
+    uconfig::Variable<std::string> data_dir{"/var"};
+    Endpoint endpoint;
+    uconfig::Vector<std::string> mirrors{true};
+    uconfig::Vector<uconfig::InternedString> tags{true};
+
+    using uconfig::Config<uconfig::RapidjsonFormat<>>::Config;
+
+    virtual void Init(const std::string& config_path) override
+    {
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/host", &host);
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/data_dir", &data_dir);
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/endpoint", &endpoint);
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/mirrors", &mirrors);
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/tags", &tags);
+    }
+};
+
+TEST(Interpolation, References)
+{
+    rapidjson::Document json;
+    // references point forward and backward, to values of any type and to paths not registered
+    json.Parse(R"({"endpoint": {"url": "http://${host}:${endpoint.port}/${/prefix}", "port": 8080},
+                   "host": "${name}.local", "name": "api", "prefix": "v1",
+                   "data_dir": "$${HOME}", "mirrors": ["${host}", "${endpoint.url}"], "tags": ["${name}"]})");
+
+    ServiceConfig config;
+    config.SetInterpolation(true);
+    ASSERT_TRUE(config.Parse(uconfig::RapidjsonFormat<>{}, "", &json));
+    ASSERT_EQ(config.host, "api.local");
+    ASSERT_EQ(config.endpoint.url, "http://api.local:8080/v1");
+    ASSERT_EQ(config.data_dir, "${HOME}");
+    ASSERT_EQ(config.mirrors, std::vector<std::string>({"api.local", "http://api.local:8080/v1"}));
+    ASSERT_EQ((*config.tags)[0], "api");
+
+    // placeholders are kept as is without interpolation
+    ServiceConfig raw_config;
+    ASSERT_TRUE(raw_config.Parse(uconfig::RapidjsonFormat<>{}, "", &json));
+    ASSERT_EQ(raw_config.host, "${name}.local");
+}
+
+testing::AssertionResult ParseFails(const char* text, const std::string& expected_error)
+{
+    rapidjson::Document json;
+    json.Parse(text);
+
+    ServiceConfig config;
+    config.SetInterpolation(true);
+    try {
+        config.Parse(uconfig::RapidjsonFormat<>{}, "", &json);
+    } catch (const uconfig::ParseError& ex) {
+        if (std::string(ex.what()).find(expected_error) == std::string::npos) {
+            return testing::AssertionFailure() << "unexpected error: " << ex.what();
+        }
+        return testing::AssertionSuccess();
+    }
+    return testing::AssertionFailure() << "'" << text << "' parsed";
+}
+
+TEST(Interpolation, Errors)
+{
+    ASSERT_TRUE(ParseFails(R"({"host": "${endpoint.url}", "endpoint": {"url": "${host}"}})",
+                           "config '/host' is not valid: reference cycle '/host' -> '/endpoint/url' -> '/host'"));
+    ASSERT_TRUE(ParseFails(R"({"host": "${host}"})", "reference cycle '/host' -> '/host'"));
+    ASSERT_TRUE(ParseFails(R"({"host": "${absent}"})", "unresolved reference 'absent'"));
+    ASSERT_TRUE(ParseFails(R"({"host": "${name"})", "unterminated placeholder"));
+    ASSERT_TRUE(ParseFails(R"({"host": "${env:UCONFIG_TEST_ABSENT}"})",
+                           "environment variable 'UCONFIG_TEST_ABSENT' is not set"));
+}
+
+TEST(Interpolation, Environment)
+{
+    setenv("UCONFIG_TEST_HOST", "remote", 1);
+
+    rapidjson::Document json;
+    json.Parse(R"({"host": "${env:UCONFIG_TEST_HOST}"})");
+    ServiceConfig config;
+    config.SetInterpolation(true);
+    ASSERT_TRUE(config.Parse(uconfig::RapidjsonFormat<>{}, "", &json));
+    ASSERT_EQ(config.host, "remote");
+
+    // env format maps references to variable names
+    struct EnvConfig: public uconfig::Config<uconfig::EnvFormat>
+    {
+        uconfig::Variable<std::string> url;
+
+        using uconfig::Config<uconfig::EnvFormat>::Config;
+
+        virtual void Init(const std::string& config_path) override
+        {
+            Register<uconfig::EnvFormat>(config_path + "_URL", &url);
+        }
+    };
+    const auto table = uconfig::FlatKvTable::FromEnv(
+        std::map<std::string, std::string>{{"APP_URL", "http://${app.host}:${APP_PORT}"}, {"APP_HOST", "local"},
+                                           {"APP_PORT", "80"}});
+    EnvConfig env_config;
+    env_config.SetInterpolation(true);
+    ASSERT_TRUE(env_config.Parse(uconfig::EnvFormat{}, "APP", &table));
+    ASSERT_EQ(env_config.url, "http://local:80");
+
+    unsetenv("UCONFIG_TEST_HOST");
+}
+
+TEST(Interpolation, Memoization)
+{
+    rapidjson::Document json;
+    json.Parse(R"({"host": "api", "endpoint": {"url": "http://${host}"}})");
+
+    ServiceConfig config;
+    config.SetInterpolation(true);
+    config.SetMemoize(true);
+    ASSERT_TRUE(config.Parse(uconfig::RapidjsonFormat<>{}, "", &json));
+    ASSERT_EQ(config.endpoint.url, "http://api");
+
+    // section is parsed again as the referenced value is outside of it
+    json["host"].SetString("web", json.GetAllocator());
+    ASSERT_TRUE(config.Parse(uconfig::RapidjsonFormat<>{}, "", &json));
+    ASSERT_EQ(config.endpoint.url, "http://web");
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
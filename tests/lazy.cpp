@@ -0,0 +1,199 @@
+#include "uconfig/format/Env.h"
+#include "uconfig/format/FlatKv.h"
+#include "uconfig/format/Rapidjson.h"
+#include "uconfig/uconfig.h"
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <thread>
+
+/* Lazy section is recorded by the parse and parsed on the first access */
+
+struct Limits: public uconfig::Config<uconfig::RapidjsonFormat<>, uconfig::EnvFormat, uconfig::FlatKvFormat>
+{
+    uconfig::Variable<int> rps;
+    uconfig::Variable<int> burst{10};
+
+    using uconfig::Config<uconfig::RapidjsonFormat<>, uconfig::EnvFormat, uconfig::FlatKvFormat>::Config;
+
+    virtual void Init(const std::string& config_path) override
+    {
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/rps", &rps);
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/burst", &burst);
+        Register<uconfig::EnvFormat>(config_path + "_RPS", &rps);
+        Register<uconfig::EnvFormat>(config_path + "_BURST", &burst);
+        Register<uconfig::FlatKvFormat>(config_path + "/rps", &rps);
+        Register<uconfig::FlatKvFormat>(config_path + "/burst", &burst);
+    }
+};
+
+struct ServiceConfig: public uconfig::Config<uconfig::RapidjsonFormat<>, uconfig::EnvFormat, uconfig::FlatKvFormat>
+{
+    uconfig::Variable<std::string> id;
+    uconfig::LazyConfig<Limits> limits;
+    uconfig::LazyConfig<Limits> fallback_limits{true};
+
+    using uconfig::Config<uconfig::RapidjsonFormat<>, uconfig::EnvFormat, uconfig::FlatKvFormat>::Config;
+
+    virtual void Init(const std::string& config_path) override
+    {
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/id", &id);
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/limits", &limits);
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/fallback_limits", &fallback_limits);
+        Register<uconfig::EnvFormat>(config_path + "_ID", &id);
+        Register<uconfig::EnvFormat>(config_path + "_LIMITS", &limits);
+        Register<uconfig::EnvFormat>(config_path + "_FALLBACK_LIMITS", &fallback_limits);
+        Register<uconfig::FlatKvFormat>(config_path + "/id", &id);
+        Register<uconfig::FlatKvFormat>(config_path + "/limits", &limits);
+        Register<uconfig::FlatKvFormat>(config_path + "/fallback_limits", &fallback_limits);
+    }
+};
+
+TEST(LazyConfig, Deferred)
+{
+    ServiceConfig config;
+    {
+        rapidjson::Document json;
+        json.Parse(R"({"id": "api", "limits": {"rps": 5}})");
+        ASSERT_TRUE(config.Parse(uconfig::RapidjsonFormat<>{}, "", &json));
+    }
+    // source is gone, the section has been captured by the parse
+    ASSERT_EQ(config.id, "api");
+    ASSERT_TRUE(config.limits.Initialized());
+    ASSERT_FALSE(config.limits.Loaded());
+
+    ASSERT_EQ(config.limits->rps, 5);
+    ASSERT_EQ(config.limits->burst, 10);
+    ASSERT_TRUE(config.limits.Loaded());
+
+    // absent optional section is parsed into its' initial value
+    ASSERT_FALSE(config.fallback_limits->rps.Initialized());
+    ASSERT_EQ(config.fallback_limits->burst, 10);
+}
+
+TEST(LazyConfig, Errors)
+{
+    rapidjson::Document json;
+    json.Parse(R"({"id": "api", "limits": {"burst": 5}})");
+
+    ServiceConfig config;
+    // failure is not seen by the parse
+    ASSERT_TRUE(config.Parse(uconfig::RapidjsonFormat<>{}, "", &json));
+    ASSERT_THROW(config.limits.Load(), uconfig::ParseError);
+    ASSERT_TRUE(config.limits.Loaded());
+    // but by every access
+    ASSERT_THROW(config.limits.Load(), uconfig::ParseError);
+    ASSERT_THROW(config.limits.Get(), uconfig::ParseError);
+
+    // next parse records the section anew
+    json["limits"].AddMember("rps", 7, json.GetAllocator());
+    ASSERT_TRUE(config.Parse(uconfig::RapidjsonFormat<>{}, "", &json));
+    ASSERT_NO_THROW(config.limits.Load());
+    ASSERT_EQ(config.limits->rps, 7);
+
+    // failure not thrown by the parse is not handed out as a partially parsed section
+    json["limits"].RemoveMember("rps");
+    ServiceConfig quiet_config;
+    ASSERT_TRUE(quiet_config.Parse(uconfig::RapidjsonFormat<>{}, "", &json, false));
+    ASSERT_THROW(quiet_config.limits.Load(), uconfig::ParseError);
+    const auto table = uconfig::FlatKvTable::FromJson(json);
+    ASSERT_TRUE(quiet_config.Parse(uconfig::FlatKvFormat{}, "", &table, false));
+    ASSERT_THROW(quiet_config.limits.Load(), uconfig::ParseError);
+}
+
+TEST(LazyConfig, Strict)
+{
+    rapidjson::Document json;
+    json.Parse(R"({"id": "api", "limits": {"burst": 5}})");
+
+    ServiceConfig config;
+    config.SetStrict(true);
+    // strict parse has to see the keys of the section
+    ASSERT_THROW(config.Parse(uconfig::RapidjsonFormat<>{}, "", &json), uconfig::ParseError);
+
+    json["limits"].AddMember("rps", 7, json.GetAllocator());
+    ASSERT_TRUE(config.Parse(uconfig::RapidjsonFormat<>{}, "", &json));
+    ASSERT_TRUE(config.limits.Loaded());
+    ASSERT_EQ(config.limits->rps, 7);
+}
+
+TEST(LazyConfig, Shared)
+{
+    rapidjson::Document json;
+    json.Parse(R"({"id": "api", "limits": {"rps": 5}})");
+
+    ServiceConfig config;
+    ASSERT_TRUE(config.Parse(uconfig::RapidjsonFormat<>{}, "", &json));
+
+    // copies share the parsed section
+    const ServiceConfig copy = config;
+    ASSERT_EQ(&copy.limits.Get(), &config.limits.Get());
+    ASSERT_TRUE(config.limits.Loaded());
+
+    // but not the emitted one
+    rapidjson::Document emitted;
+    config.Emit(uconfig::RapidjsonFormat<>{}, "", &emitted);
+    ASSERT_EQ(emitted["limits"]["rps"].GetInt(), 5);
+    ASSERT_EQ(emitted["limits"]["burst"].GetInt(), 10);
+    ASSERT_EQ(uconfig::Diff(uconfig::RapidjsonFormat<>{}, copy, config).size(), 0);
+}
+
+TEST(LazyConfig, Eager)
+{
+    ServiceConfig config;
+    {
+        rapidjson::Document json;
+        json.Parse(R"({"id": "api", "limits": {"rps": 5}})");
+        const auto table = uconfig::FlatKvTable::FromJson(json);
+        ASSERT_TRUE(config.Parse(uconfig::FlatKvFormat{}, "", &table));
+    }
+    // format keeps no copy of the source, so the section is parsed by the parse
+    ASSERT_TRUE(config.limits.Loaded());
+    ASSERT_EQ(config.limits->rps, 5);
+    ASSERT_EQ(config.fallback_limits->burst, 10);
+}
+
+TEST(LazyConfig, Env)
+{
+    setenv("SERVICE_ID", "api", 1);
+    setenv("SERVICE_LIMITS_RPS", "5", 1);
+
+    ServiceConfig config;
+    ASSERT_TRUE(config.Parse(uconfig::EnvFormat{}, "SERVICE", nullptr));
+    // variables of the section are captured by the parse
+    setenv("SERVICE_LIMITS_RPS", "6", 1);
+    ASSERT_EQ(config.limits->rps, 5);
+
+    unsetenv("SERVICE_ID");
+    unsetenv("SERVICE_LIMITS_RPS");
+}
+
+TEST(LazyConfig, Threads)
+{
+    rapidjson::Document json;
+    json.Parse(R"({"id": "api", "limits": {"rps": 5}})");
+
+    ServiceConfig config;
+    ASSERT_TRUE(config.Parse(uconfig::RapidjsonFormat<>{}, "", &json));
+
+    std::atomic<int> parsed{0};
+    std::vector<std::thread> threads;
+    for (int thread = 0; thread < 8; ++thread) {
+        threads.emplace_back([&config, &parsed] {
+            if (config.limits->rps == 5) {
+                ++parsed;
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQ(parsed, 8);
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,159 @@
+#include "uconfig/Loader.h"
+#include "uconfig/format/Rapidjson.h"
+#include "uconfig/uconfig.h"
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+
+#include <unistd.h>
+
+/* Files are handed over in order of completion, contents do not depend on the backend */
+
+static std::string root;
+
+std::string FilePath(std::size_t index)
+{
+    return root + "/fragment" + std::to_string(index) + ".json";
+}
+
+void SetDir(std::size_t files)
+{
+    char root_template[] = "/tmp/uconfig_loader_XXXXXX";
+    root = ::mkdtemp(root_template);
+
+    for (std::size_t index = 0; index < files; ++index) {
+        std::ofstream(FilePath(index), std::ios::binary)
+            << R"({"name": "node)" << index << R"(", "port": )" << 8000 + index << "}";
+    }
+    // larger than a page and not aligned to it
+    std::ofstream(root + "/large", std::ios::binary) << std::string(10000, 'x');
+    std::ofstream(root + "/empty", std::ios::binary);
+}
+
+void ClearDir(std::size_t files)
+{
+    for (std::size_t index = 0; index < files; ++index) {
+        std::remove(FilePath(index).c_str());
+    }
+    std::remove((root + "/large").c_str());
+    std::remove((root + "/empty").c_str());
+    ::rmdir(root.c_str());
+}
+
+const std::size_t kFiles = 100;
+
+struct NodeConfig: public uconfig::Config<uconfig::RapidjsonFormat<>>
+{
+    uconfig::Variable<std::string> name;
+    uconfig::Variable<unsigned> port;
+
+    using uconfig::Config<uconfig::RapidjsonFormat<>>::Config;
+
+    virtual void Init(const std::string& config_path) override
+    {
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/name", &name);
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/port", &port);
+    }
+};
+
+std::vector<std::unique_ptr<uconfig::FileLoader>> MakeLoaders()
+{
+    std::vector<std::unique_ptr<uconfig::FileLoader>> loaders;
+    // small queue depth to refill the ring while handling completions
+    loaders.push_back(std::make_unique<uconfig::FileLoader>(uconfig::FileLoader::Backend::Threads, 8, 3));
+    try {
+        loaders.push_back(std::make_unique<uconfig::FileLoader>(uconfig::FileLoader::Backend::IoUring, 8));
+    } catch (const uconfig::Error&) {
+        // io_uring is not permitted here
+    }
+    return loaders;
+}
+
+TEST(Loader, Backend)
+{
+    uconfig::FileLoader threads_loader{uconfig::FileLoader::Backend::Threads};
+    ASSERT_EQ(threads_loader.Used(), uconfig::FileLoader::Backend::Threads);
+
+    uconfig::FileLoader loader;
+    ASSERT_NE(loader.Used(), uconfig::FileLoader::Backend::Auto);
+}
+
+TEST(Loader, LoadFiles)
+{
+    std::vector<std::string> paths = {root + "/large", root + "/empty", "/proc/self/stat"};
+    for (auto& loader : MakeLoaders()) {
+        const std::vector<std::string> contents = loader->Load(paths);
+        ASSERT_EQ(contents.size(), 3);
+        ASSERT_EQ(contents[0], std::string(10000, 'x'));
+        ASSERT_EQ(contents[1], "");
+        // size of procfs files is not known up front
+        ASSERT_FALSE(contents[2].empty());
+        ASSERT_EQ(contents[2].back(), '\n');
+
+        ASSERT_TRUE(loader->Load({}).empty());
+    }
+}
+
+TEST(Loader, ParseFragments)
+{
+    std::vector<std::string> paths;
+    for (std::size_t index = 0; index < kFiles; ++index) {
+        paths.push_back(FilePath(index));
+    }
+
+    for (auto& loader : MakeLoaders()) {
+        std::vector<NodeConfig> nodes(kFiles);
+        std::vector<int> handled(kFiles, 0);
+        loader->Load(paths, [&](std::size_t index, std::string&& contents) {
+            rapidjson::Document json;
+            json.Parse(contents.c_str());
+            nodes[index].Parse(uconfig::RapidjsonFormat<>{}, "", &json);
+            ++handled[index];
+        });
+
+        ASSERT_EQ(handled, std::vector<int>(kFiles, 1));
+        for (std::size_t index = 0; index < kFiles; ++index) {
+            ASSERT_EQ(nodes[index].name, "node" + std::to_string(index));
+            ASSERT_EQ(nodes[index].port, 8000 + index);
+        }
+    }
+}
+
+TEST(Loader, Fail)
+{
+    std::vector<std::string> paths;
+    for (std::size_t index = 0; index < kFiles; ++index) {
+        paths.push_back(FilePath(index));
+    }
+
+    for (auto& loader : MakeLoaders()) {
+        std::vector<std::string> missing_paths = paths;
+        missing_paths[kFiles / 2] = root + "/missing";
+        ASSERT_THROW(loader->Load(missing_paths), uconfig::ParseError);
+
+        std::size_t handled = 0;
+        auto handler = [&handled](std::size_t, std::string&&) {
+            if (++handled == 10) {
+                throw std::runtime_error("handler failed");
+            }
+        };
+        ASSERT_THROW(loader->Load(paths, handler), std::runtime_error);
+        ASSERT_EQ(handled, 10);
+
+        // loader is reusable after failures
+        ASSERT_EQ(loader->Load(paths).size(), kFiles);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    SetDir(kFiles);
+    auto result = RUN_ALL_TESTS();
+    ClearDir(kFiles);
+
+    return result;
+}
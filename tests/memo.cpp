@@ -0,0 +1,206 @@
+#include "uconfig/format/Env.h"
+#include "uconfig/format/FlatKv.h"
+#include "uconfig/format/Rapidjson.h"
+#include "uconfig/format/Yaml.h"
+#include "uconfig/uconfig.h"
+#include "gtest/gtest.h"
+
+#include <cstdlib>
+
+/* Memoized parse skips sections with unchanged source subtree */
+
+template <typename Format>
+struct Listener: public uconfig::Config<Format>
+{
+    uconfig::Variable<std::string> host;
+    uconfig::Variable<unsigned> port;
+    std::size_t* validations;
+
+    Listener(std::size_t* validations_counter)
+        : validations(validations_counter)
+    {
+    }
+
+    virtual void Init(const std::string& config_path) override
+    {
+        this->template Register<Format>(config_path + Separator() + "host", &host);
+        this->template Register<Format>(config_path + Separator() + "port", &port);
+    }
+
+    virtual void Validate() const override
+    {
+        ++*validations;
+        if (*port == 0) {
+            throw std::runtime_error("port is zero");
+        }
+    }
+
+    static std::string Separator()
+    {
+        return std::is_same<Format, uconfig::EnvFormat>::value ? "_" : "/";
+    }
+};
+
+template <typename Format>
+struct ServerConfig: public uconfig::Config<Format>
+{
+    std::size_t validations = 0;
+    Listener<Format> http{&validations};
+    Listener<Format> admin{&validations};
+
+    virtual void Init(const std::string& config_path) override
+    {
+        this->template Register<Format>(config_path + Listener<Format>::Separator() + "http", &http);
+        this->template Register<Format>(config_path + Listener<Format>::Separator() + "admin", &admin);
+    }
+};
+
+rapidjson::Document MakeJson(unsigned admin_port)
+{
+    rapidjson::Document json;
+    json.Parse(R"({"http": {"host": "0.0.0.0", "port": 80}, "admin": {"host": "127.0.0.1", "port": 0}})");
+    json["admin"]["port"].SetUint(admin_port);
+    return json;
+}
+
+TEST(Memo, Rapidjson)
+{
+    using Format = uconfig::RapidjsonFormat<>;
+
+    ServerConfig<Format> config;
+    config.SetMemoize(true);
+    const auto json = MakeJson(8080);
+    ASSERT_TRUE(config.Parse(Format{}, "", &json));
+    ASSERT_EQ(config.validations, 2);
+    ASSERT_EQ(config.Memo().parsed, 3);
+    ASSERT_EQ(config.Memo().skipped, 0);
+
+    // whole config is unchanged
+    ASSERT_TRUE(config.Parse(Format{}, "", &json));
+    ASSERT_EQ(config.validations, 2);
+    ASSERT_EQ(config.Memo().parsed, 3);
+    ASSERT_EQ(config.Memo().skipped, 1);
+
+    // only admin section is changed
+    const auto changed_json = MakeJson(8081);
+    ASSERT_TRUE(config.Parse(Format{}, "", &changed_json));
+    ASSERT_EQ(config.validations, 3);
+    ASSERT_EQ(config.Memo().parsed, 5);
+    ASSERT_EQ(config.Memo().skipped, 2);
+    ASSERT_EQ(config.admin.port, 8081);
+    ASSERT_EQ(config.http.port, 80);
+
+    // failed section is not memoized and reports the error again
+    const auto failed_json = MakeJson(0);
+    ASSERT_THROW(config.Parse(Format{}, "", &failed_json), uconfig::ParseError);
+    ASSERT_THROW(config.Parse(Format{}, "", &failed_json), uconfig::ParseError);
+    ASSERT_TRUE(config.Parse(Format{}, "", &changed_json));
+    ASSERT_EQ(config.admin.port, 8081);
+}
+
+TEST(Memo, Disabled)
+{
+    using Format = uconfig::RapidjsonFormat<>;
+
+    ServerConfig<Format> config;
+    const auto json = MakeJson(8080);
+    ASSERT_TRUE(config.Parse(Format{}, "", &json));
+    ASSERT_TRUE(config.Parse(Format{}, "", &json));
+    ASSERT_EQ(config.validations, 4);
+    ASSERT_EQ(config.Memo().parsed, 0);
+    ASSERT_EQ(config.Memo().skipped, 0);
+}
+
+TEST(Memo, Yaml)
+{
+    ServerConfig<uconfig::YamlFormat> config;
+    config.SetMemoize(true);
+    const uconfig::YamlDocument yaml("http:\n  host: 0.0.0.0\n  port: 80\nadmin:\n  host: 127.0.0.1\n  port: 8080\n");
+    ASSERT_TRUE(config.Parse(uconfig::YamlFormat{}, "", &yaml));
+
+    // order of the mapping keys and redundant quotes do not matter
+    const uconfig::YamlDocument reordered_yaml(
+        "admin:\n  port: 8080\n  host: '127.0.0.1'\nhttp:\n  host: 0.0.0.0\n  port: 80\n");
+    ASSERT_TRUE(config.Parse(uconfig::YamlFormat{}, "", &reordered_yaml));
+    ASSERT_EQ(config.Memo().skipped, 1);
+
+    const uconfig::YamlDocument changed_yaml(
+        "http:\n  host: 0.0.0.0\n  port: 81\nadmin:\n  host: 127.0.0.1\n  port: 8080\n");
+    ASSERT_TRUE(config.Parse(uconfig::YamlFormat{}, "", &changed_yaml));
+    ASSERT_EQ(config.Memo().skipped, 2);
+    ASSERT_EQ(config.http.port, 81);
+}
+
+TEST(Memo, Env)
+{
+    ServerConfig<uconfig::EnvFormat> config;
+    config.SetMemoize(true);
+    ::setenv("SERVER_http_host", "0.0.0.0", 1);
+    ::setenv("SERVER_http_port", "80", 1);
+    ::setenv("SERVER_admin_host", "127.0.0.1", 1);
+    ::setenv("SERVER_admin_port", "8080", 1);
+    ASSERT_TRUE(config.Parse(uconfig::EnvFormat{}, "SERVER", nullptr));
+
+    ::setenv("SERVER_admin_port", "8081", 1);
+    ASSERT_TRUE(config.Parse(uconfig::EnvFormat{}, "SERVER", nullptr));
+    ASSERT_EQ(config.Memo().parsed, 5);
+    ASSERT_EQ(config.Memo().skipped, 1);
+    ASSERT_EQ(config.admin.port, 8081);
+
+    for (const char* name : {"SERVER_http_host", "SERVER_http_port", "SERVER_admin_host", "SERVER_admin_port"}) {
+        ::unsetenv(name);
+    }
+}
+
+TEST(Memo, Formats)
+{
+    using Json = uconfig::RapidjsonFormat<>;
+    using Kv = uconfig::FlatKvFormat;
+
+    struct Inner: public uconfig::Config<Json, Kv>
+    {
+        uconfig::Variable<unsigned> port;
+
+        using uconfig::Config<Json, Kv>::Config;
+
+        virtual void Init(const std::string& config_path) override
+        {
+            Register<Json>(config_path + "/port", &port);
+            Register<Kv>(config_path + "/port", &port);
+        }
+    };
+    struct Outer: public uconfig::Config<Json, Kv>
+    {
+        Inner inner;
+
+        virtual void Init(const std::string& config_path) override
+        {
+            Register<Json>(config_path + "/inner", &inner);
+            Register<Kv>(config_path + "/inner", &inner);
+        }
+    };
+
+    Outer config;
+    config.SetMemoize(true);
+    rapidjson::Document json;
+    json.Parse(R"({"inner": {"port": 1}})");
+    ASSERT_TRUE(config.Parse(Json{}, "", &json));
+    ASSERT_EQ(config.inner.port, 1);
+
+    // format without subtree hashes changes the values as well
+    rapidjson::Document kv_json;
+    kv_json.Parse(R"({"inner": {"port": 2}})");
+    const auto table = uconfig::FlatKvTable::FromJson(kv_json);
+    ASSERT_TRUE(config.Parse(Kv{}, "", &table));
+    ASSERT_EQ(config.inner.port, 2);
+
+    // so the same json is parsed again
+    ASSERT_TRUE(config.Parse(Json{}, "", &json));
+    ASSERT_EQ(config.inner.port, 1);
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
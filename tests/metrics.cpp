@@ -0,0 +1,105 @@
+#include "uconfig/format/Env.h"
+#include "uconfig/uconfig.h"
+#include "gtest/gtest.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+/* Every Config::Parse() is counted per config type and format */
+
+struct MetricsConfig: public uconfig::Config<uconfig::EnvFormat>
+{
+    uconfig::Variable<unsigned> port;
+
+    using uconfig::Config<uconfig::EnvFormat>::Config;
+
+    virtual void Init(const std::string& config_path) override
+    {
+        Register<uconfig::EnvFormat>(config_path + "_PORT", &port);
+    }
+};
+
+// series are kept per dynamic config type
+struct ConcurrentConfig: public MetricsConfig
+{
+    using MetricsConfig::MetricsConfig;
+};
+
+std::string Render()
+{
+    std::vector<char> buffer(64 * 1024);
+    const std::size_t length = uconfig::ParseMetrics::Global().Render(buffer.data(), buffer.size());
+    EXPECT_LT(length, buffer.size());
+    return std::string(buffer.data(), length);
+}
+
+TEST(Metrics, Render)
+{
+    ::setenv("METRICS_PORT", "80", 1);
+    MetricsConfig config;
+    ASSERT_TRUE(config.Parse(uconfig::EnvFormat{}, "METRICS", nullptr));
+    ASSERT_TRUE(config.Parse(uconfig::EnvFormat{}, "METRICS", nullptr));
+    ::setenv("METRICS_PORT", "port", 1);
+    MetricsConfig failed_config;
+    ASSERT_THROW(failed_config.Parse(uconfig::EnvFormat{}, "METRICS", nullptr), uconfig::ParseError);
+    // failure without an exception is counted as well
+    ASSERT_FALSE(failed_config.Parse(uconfig::EnvFormat{}, "METRICS", nullptr, false));
+    ::unsetenv("METRICS_PORT");
+
+    const std::string text = Render();
+    const std::string labels = R"({config="MetricsConfig",format="ENV")";
+    ASSERT_NE(text.find("# TYPE uconfig_parse_total counter\n"), std::string::npos);
+    ASSERT_NE(text.find("uconfig_parse_total" + labels + "} 4\n"), std::string::npos);
+    ASSERT_NE(text.find("uconfig_parse_failures_total" + labels + "} 2\n"), std::string::npos);
+    ASSERT_NE(text.find("uconfig_parse_duration_seconds_bucket" + labels + R"(,le="+Inf"} 4)"), std::string::npos);
+    ASSERT_NE(text.find("uconfig_parse_duration_seconds_bucket" + labels + R"(,le="0.0001"} )"), std::string::npos);
+    ASSERT_NE(text.find("uconfig_parse_duration_seconds_count" + labels + "} 4\n"), std::string::npos);
+    ASSERT_NE(text.find("uconfig_config_generation" + labels + "} 2\n"), std::string::npos);
+    ASSERT_EQ(text.find("uconfig_config_last_success_timestamp_seconds" + labels + "} 0.000\n"), std::string::npos);
+}
+
+TEST(Metrics, RenderTruncated)
+{
+    MetricsConfig config;
+    config.Parse(uconfig::EnvFormat{}, "METRICS", nullptr, false);
+
+    const std::string text = Render();
+    char buffer[100];
+    std::memset(buffer, 'x', sizeof(buffer));
+    ASSERT_EQ(uconfig::ParseMetrics::Global().Render(buffer, sizeof(buffer)), text.size());
+    ASSERT_EQ(std::string(buffer), text.substr(0, sizeof(buffer) - 1));
+    ASSERT_EQ(uconfig::ParseMetrics::Global().Render(nullptr, 0), text.size());
+}
+
+TEST(Metrics, ParseConcurrent)
+{
+    ::setenv("CONCURRENT_PORT", "80", 1);
+    std::vector<std::thread> threads;
+    for (std::size_t thread = 0; thread < 4; ++thread) {
+        threads.emplace_back([]() {
+            for (std::size_t parse = 0; parse < 100; ++parse) {
+                ConcurrentConfig config;
+                config.Parse(uconfig::EnvFormat{}, "CONCURRENT", nullptr);
+            }
+        });
+    }
+    threads.emplace_back([]() {
+        for (std::size_t render = 0; render < 10; ++render) {
+            Render();
+        }
+    });
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    ::unsetenv("CONCURRENT_PORT");
+
+    ASSERT_NE(Render().find(R"(uconfig_parse_total{config="ConcurrentConfig",format="ENV"} 400)"), std::string::npos);
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
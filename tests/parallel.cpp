@@ -0,0 +1,125 @@
+#include "uconfig/format/Rapidjson.h"
+#include "uconfig/format/Yaml.h"
+#include "uconfig/uconfig.h"
+#include "gtest/gtest.h"
+
+/* Parallel parsing gives the same vectors and errors as the sequential one */
+
+struct Route: public uconfig::Config<uconfig::RapidjsonFormat<>>
+{
+    uconfig::Variable<std::string> prefix;
+    uconfig::Variable<unsigned> port;
+
+    using uconfig::Config<uconfig::RapidjsonFormat<>>::Config;
+
+    virtual void Init(const std::string& config_path) override
+    {
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/prefix", &prefix);
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/port", &port);
+    }
+
+    virtual void Validate() const override
+    {
+        if (*port == 0) {
+            throw std::runtime_error("port is zero");
+        }
+    }
+};
+
+rapidjson::Document MakeRoutes(std::size_t size)
+{
+    rapidjson::Document json{rapidjson::kArrayType};
+    auto& allocator = json.GetAllocator();
+    for (std::size_t index = 0; index < size; ++index) {
+        rapidjson::Value route{rapidjson::kObjectType};
+        route.AddMember("prefix", rapidjson::Value("/" + std::to_string(index), allocator), allocator);
+        route.AddMember("port", static_cast<unsigned>(index % 1000 + 1), allocator);
+        json.PushBack(route, allocator);
+    }
+    return json;
+}
+
+template <typename T, typename F>
+std::optional<std::string> Parse(uconfig::Vector<T>* vector, const F& format, const typename F::source_type& source,
+                                 std::size_t threads)
+{
+    vector->SetParallel(threads, 16);
+    uconfig::VectorIface<T, F> iface("", vector);
+    try {
+        iface.Parse(format, &source);
+    } catch (const uconfig::Error& ex) {
+        return std::string(ex.what());
+    }
+    return std::nullopt;
+}
+
+TEST(Parallel, ParseConfigs)
+{
+    const auto json = MakeRoutes(1000);
+
+    uconfig::Vector<Route> sequential;
+    uconfig::Vector<Route> parallel;
+    ASSERT_EQ(Parse(&sequential, uconfig::RapidjsonFormat<>{}, json, 1), std::nullopt);
+    ASSERT_EQ(Parse(&parallel, uconfig::RapidjsonFormat<>{}, json, 8), std::nullopt);
+
+    ASSERT_EQ(parallel->size(), 1000);
+    for (std::size_t index = 0; index < parallel->size(); ++index) {
+        ASSERT_EQ(parallel[index].prefix, sequential[index].prefix);
+        ASSERT_EQ(parallel[index].port, sequential[index].port);
+    }
+    ASSERT_EQ(parallel[999].prefix, "/999");
+}
+
+TEST(Parallel, ParseFirstError)
+{
+    auto json = MakeRoutes(1000);
+    // the first failing element is reported regardless of which thread has failed first
+    json[900]["port"].SetInt(-1);
+    json[500]["port"].SetUint(0);
+    json[700].RemoveMember("prefix");
+
+    uconfig::Vector<Route> sequential{true};
+    uconfig::Vector<Route> parallel{true};
+    const auto sequential_error = Parse(&sequential, uconfig::RapidjsonFormat<>{}, json, 1);
+    const auto parallel_error = Parse(&parallel, uconfig::RapidjsonFormat<>{}, json, 8);
+    ASSERT_EQ(parallel_error, sequential_error);
+    ASSERT_EQ(parallel->size(), sequential->size());
+    ASSERT_EQ(parallel->size(), 500);
+
+    // mandatory vector reports the error of the first element
+    json[0]["port"].SetUint(0);
+    uconfig::Vector<Route> mandatory_sequential;
+    uconfig::Vector<Route> mandatory_parallel;
+    const auto mandatory_sequential_error = Parse(&mandatory_sequential, uconfig::RapidjsonFormat<>{}, json, 1);
+    const auto mandatory_parallel_error = Parse(&mandatory_parallel, uconfig::RapidjsonFormat<>{}, json, 8);
+    ASSERT_TRUE(mandatory_parallel_error);
+    ASSERT_EQ(mandatory_parallel_error, mandatory_sequential_error);
+    ASSERT_FALSE(mandatory_parallel.Initialized());
+}
+
+TEST(Parallel, ParseValues)
+{
+    std::string yaml_source = "list:\n";
+    for (std::size_t index = 0; index < 100; ++index) {
+        yaml_source += "  - " + std::to_string(index) + "\n";
+    }
+    yaml_source += "  - not a number\n";
+    const uconfig::YamlDocument yaml{yaml_source};
+
+    uconfig::Vector<int> sequential;
+    uconfig::Vector<int> parallel;
+    uconfig::VectorIface<int, uconfig::YamlFormat> sequential_iface("/list", &sequential);
+    uconfig::VectorIface<int, uconfig::YamlFormat> parallel_iface("/list", &parallel);
+    parallel.SetParallel(4, 10);
+    ASSERT_TRUE(sequential_iface.Parse(uconfig::YamlFormat{}, &yaml));
+    ASSERT_TRUE(parallel_iface.Parse(uconfig::YamlFormat{}, &yaml));
+
+    ASSERT_EQ(parallel->size(), 100);
+    ASSERT_EQ(*parallel, *sequential);
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,121 @@
+#include "uconfig/format/Rapidjson.h"
+#include "uconfig/uconfig.h"
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <sstream>
+#include <thread>
+
+/* Time is recorded only while the profiler is started, per phase, path and validator */
+
+struct NodeConfig: public uconfig::Config<uconfig::RapidjsonFormat<>>
+{
+    uconfig::Variable<std::string> name;
+    uconfig::Variable<unsigned> port;
+
+    using uconfig::Config<uconfig::RapidjsonFormat<>>::Config;
+
+    virtual void Init(const std::string& config_path) override
+    {
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/name", &name);
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/port", &port);
+    }
+
+    virtual void Validate() const override
+    {
+        // slow validator
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+};
+
+struct AppConfig: public uconfig::Config<uconfig::RapidjsonFormat<>>
+{
+    uconfig::Variable<std::string> string;
+    uconfig::Vector<int> numbers;
+    NodeConfig node;
+
+    using uconfig::Config<uconfig::RapidjsonFormat<>>::Config;
+
+    virtual void Init(const std::string& config_path) override
+    {
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/string", &string);
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/numbers", &numbers);
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/node", &node);
+    }
+};
+
+rapidjson::Document SetJson()
+{
+    rapidjson::Document json;
+    json.Parse(R"({"string": "value", "numbers": [1, 2, 3], "node": {"name": "a", "port": 80}})");
+    return json;
+}
+
+TEST(Profiler, Record)
+{
+    const auto json = SetJson();
+    uconfig::ParseProfiler profiler;
+
+    profiler.Start();
+    AppConfig config;
+    ASSERT_TRUE(config.Parse(uconfig::RapidjsonFormat<>{}, "", &json));
+    profiler.Stop();
+
+    using Phase = uconfig::ParseProfiler::Phase;
+    ASSERT_GE(profiler.PhaseTime(Phase::Validate), std::chrono::milliseconds(2));
+    ASSERT_GT(profiler.PhaseTime(Phase::Init).count(), 0);
+    ASSERT_GT(profiler.PhaseTime(Phase::Path).count(), 0);
+    ASSERT_GT(profiler.PhaseTime(Phase::Lookup).count(), 0);
+    ASSERT_GT(profiler.PhaseTime(Phase::Convert).count(), 0);
+    ASSERT_LT(profiler.PhaseTime(Phase::Lookup), std::chrono::milliseconds(2));
+
+    const auto validators = profiler.TopValidators(100);
+    ASSERT_EQ(validators[0].path, "/node");
+    ASSERT_EQ(validators[0].calls, 1);
+    ASSERT_GE(validators[0].time, std::chrono::milliseconds(2));
+    // validators are timed apart from their children
+    auto root = std::find_if(validators.begin(), validators.end(),
+                             [](const auto& entry) { return entry.path.empty(); });
+    ASSERT_NE(root, validators.end());
+    ASSERT_LT(root->time, std::chrono::milliseconds(2));
+
+    // string, numbers with 3 elements and a lookup past the end, node name and port
+    const auto paths = profiler.TopPaths(100);
+    ASSERT_EQ(paths.size(), 8);
+    auto find_path = [&paths](const std::string& path) {
+        return *std::find_if(paths.begin(), paths.end(), [&path](const auto& entry) { return entry.path == path; });
+    };
+    // vector includes time of its elements
+    ASSERT_EQ(find_path("/numbers").calls, 1);
+    ASSERT_GT(find_path("/numbers").time, find_path("/numbers/0").time + find_path("/numbers/1").time);
+    std::ostringstream dump;
+    profiler.Dump(dump, 3);
+    ASSERT_NE(dump.str().find("validate"), std::string::npos);
+    ASSERT_NE(dump.str().find("'/node'"), std::string::npos);
+}
+
+TEST(Profiler, Stopped)
+{
+    const auto json = SetJson();
+    uconfig::ParseProfiler profiler;
+
+    AppConfig config;
+    ASSERT_TRUE(config.Parse(uconfig::RapidjsonFormat<>{}, "", &json));
+    ASSERT_TRUE(profiler.TopPaths(10).empty());
+
+    profiler.Start();
+    ASSERT_TRUE(config.Parse(uconfig::RapidjsonFormat<>{}, "", &json));
+    profiler.Stop();
+    ASSERT_TRUE(config.Parse(uconfig::RapidjsonFormat<>{}, "", &json));
+    ASSERT_EQ(profiler.TopPaths(1)[0].calls, 1);
+
+    profiler.Reset();
+    ASSERT_TRUE(profiler.TopValidators(10).empty());
+    ASSERT_EQ(profiler.PhaseTime(uconfig::ParseProfiler::Phase::Validate).count(), 0);
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
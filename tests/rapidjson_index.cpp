@@ -0,0 +1,141 @@
+#include "uconfig/format/Rapidjson.h"
+#include "uconfig/uconfig.h"
+#include "gtest/gtest.h"
+
+#include <deque>
+#include <limits>
+
+/* Members of wide JSON-objects are looked up by hash, the same way as by a linear scan */
+
+struct OverridesConfig: public uconfig::Config<uconfig::RapidjsonFormat<>>
+{
+    std::deque<uconfig::Variable<unsigned>> services;
+
+    OverridesConfig(std::size_t size)
+        : services(size)
+    {
+    }
+
+    virtual void Init(const std::string& config_path) override
+    {
+        for (std::size_t index = 0; index < services.size(); ++index) {
+            Register<uconfig::RapidjsonFormat<>>(config_path + "/service-" + std::to_string(index) + "/limit",
+                                                 &services[index]);
+        }
+    }
+};
+
+rapidjson::Document MakeOverrides(std::size_t size, unsigned limit)
+{
+    rapidjson::Document json{rapidjson::kObjectType};
+    for (std::size_t index = size; index > 0; --index) {
+        rapidjson::Value service{rapidjson::kObjectType};
+        service.AddMember("limit", limit + static_cast<unsigned>(index - 1), json.GetAllocator());
+        json.AddMember(rapidjson::Value("service-" + std::to_string(index - 1), json.GetAllocator()), service,
+                       json.GetAllocator());
+    }
+    return json;
+}
+
+struct ServicesConfig: public uconfig::Config<uconfig::RapidjsonFormat<>>
+{
+    uconfig::LazyConfig<OverridesConfig> overrides{OverridesConfig(100)};
+    uconfig::Vector<unsigned> limits;
+
+    virtual void Init(const std::string& config_path) override
+    {
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/overrides", &overrides);
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/overrides/limits", &limits);
+    }
+};
+
+using MemberIndex = uconfig::RapidjsonFormat<>::MemberIndex;
+
+TEST(RapidjsonIndex, Lookup)
+{
+    rapidjson::Document json = MakeOverrides(100, 1);
+    json.AddMember("a/b", 7, json.GetAllocator());
+    json.AddMember("service-5", rapidjson::Value{rapidjson::kObjectType}, json.GetAllocator());
+
+    const uconfig::RapidjsonFormat<> format(8);
+    // lookups outside of a config parse scan members
+    ASSERT_EQ(format.Parse<unsigned>(&json, "/service-5/limit"), 6u);
+
+    MemberIndex index(format);
+    {
+        uconfig::FormatState<MemberIndex>::Scope index_scope(&index);
+        ASSERT_EQ(format.Parse<unsigned>(&json, "/service-5/limit"), 6u);
+        ASSERT_EQ(format.Parse<unsigned>(&json, "/a~1b"), 7u);
+        ASSERT_EQ(format.Parse<unsigned>(&json, "/service-100/limit"), std::nullopt);
+        ASSERT_EQ(format.Parse<unsigned>(&json, "/service-1/limit/0"), std::nullopt);
+    }
+    ASSERT_EQ(index.Size(), 1);
+    ASSERT_EQ(uconfig::FormatState<MemberIndex>::Current(), nullptr);
+}
+
+TEST(RapidjsonIndex, Reparse)
+{
+    OverridesConfig config(100);
+    const uconfig::RapidjsonFormat<> format;
+    for (unsigned limit = 1; limit <= 3; ++limit) {
+        // documents of the same shape may be allocated at the same address
+        const rapidjson::Document json = MakeOverrides(100, limit * 1000);
+        ASSERT_TRUE(config.Parse(format, "", &json));
+        ASSERT_EQ(config.services[0], limit * 1000);
+        ASSERT_EQ(config.services[99], limit * 1000 + 99);
+        // index is dropped at the end of the parse
+        ASSERT_EQ(uconfig::FormatState<MemberIndex>::Current(), nullptr);
+    }
+
+    // modified document is looked up anew by the next parse
+    rapidjson::Document json = MakeOverrides(100, 1);
+    ASSERT_TRUE(config.Parse(format, "", &json));
+    json.RemoveMember("service-0");
+    json.AddMember("service-0", rapidjson::Value{rapidjson::kObjectType}, json.GetAllocator());
+    json["service-0"].AddMember("limit", 5, json.GetAllocator());
+    ASSERT_TRUE(config.Parse(format, "", &json));
+    ASSERT_EQ(config.services[0], 5);
+}
+
+TEST(RapidjsonIndex, Wide)
+{
+    const std::size_t size = 4096;
+    const rapidjson::Document json = MakeOverrides(size, 0);
+
+    for (const std::size_t threshold : {uconfig::RapidjsonFormat<>::kIndexThreshold, std::size_t{8},
+                                        std::numeric_limits<std::size_t>::max()}) {
+        OverridesConfig config(size);
+        ASSERT_TRUE(config.Parse(uconfig::RapidjsonFormat<>(threshold), "", &json));
+        ASSERT_EQ(config.services[0], 0);
+        ASSERT_EQ(config.services[size - 1], size - 1);
+    }
+}
+
+TEST(RapidjsonIndex, Deferred)
+{
+    ServicesConfig config;
+    config.limits.SetParallel(4, 16);
+    {
+        rapidjson::Document json{rapidjson::kObjectType};
+        rapidjson::Document overrides = MakeOverrides(100, 1);
+        rapidjson::Value limits{rapidjson::kArrayType};
+        for (unsigned limit = 0; limit < 128; ++limit) {
+            limits.PushBack(limit, json.GetAllocator());
+        }
+        overrides.AddMember("limits", limits, overrides.GetAllocator());
+        json.AddMember("overrides", rapidjson::Value(overrides, json.GetAllocator()), json.GetAllocator());
+        ASSERT_TRUE(config.Parse(uconfig::RapidjsonFormat<>(8), "", &json));
+    }
+    // workers of the parallel parse share the index of the parse
+    ASSERT_EQ(config.limits->size(), 128);
+    ASSERT_EQ((*config.limits)[127], 127);
+
+    // deferred parse of the captured section builds an index of its' own
+    ASSERT_EQ(config.overrides->services[42], 43);
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
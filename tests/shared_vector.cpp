@@ -0,0 +1,136 @@
+#include "uconfig/format/Env.h"
+#include "uconfig/format/Rapidjson.h"
+#include "uconfig/uconfig.h"
+#include "gtest/gtest.h"
+
+#include <cstdlib>
+
+/* Unchanged shared vectors keep the storage between parses and copies */
+
+struct Backend: public uconfig::Config<uconfig::RapidjsonFormat<>>
+{
+    uconfig::Variable<std::string> host;
+
+    using uconfig::Config<uconfig::RapidjsonFormat<>>::Config;
+
+    virtual void Init(const std::string& config_path) override
+    {
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/host", &host);
+    }
+};
+
+struct NonEmptyPorts: public uconfig::SharedVector<unsigned>
+{
+    using uconfig::SharedVector<unsigned>::SharedVector;
+
+    virtual void Validate() const override
+    {
+        if (Get().empty() || Get()[0] == 0) {
+            throw std::runtime_error("first port is zero");
+        }
+    }
+};
+
+struct BalancerConfig: public uconfig::Config<uconfig::RapidjsonFormat<>, uconfig::EnvFormat>
+{
+    NonEmptyPorts ports;
+    uconfig::SharedVector<Backend> backends;
+    uconfig::SharedVector<std::string> tags{std::vector<std::string>{"default"}};
+
+    using uconfig::Config<uconfig::RapidjsonFormat<>, uconfig::EnvFormat>::Config;
+
+    virtual void Init(const std::string& config_path) override
+    {
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/ports", &ports);
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/backends", &backends);
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/tags", &tags);
+        Register<uconfig::EnvFormat>(config_path + "_PORTS", &ports);
+    }
+};
+
+rapidjson::Document MakeJson(const char* text)
+{
+    rapidjson::Document json;
+    json.Parse(text);
+    return json;
+}
+
+TEST(SharedVector, Parse)
+{
+    const auto json = MakeJson(R"({"ports": [80, 443], "backends": [{"host": "a"}, {"host": "b"}]})");
+
+    BalancerConfig config;
+    ASSERT_TRUE(config.Parse(uconfig::RapidjsonFormat<>{}, "", &json));
+    ASSERT_EQ(*config.ports, (std::vector<unsigned>{80, 443}));
+    ASSERT_EQ(config.backends[1].host, "b");
+    ASSERT_EQ(*config.tags, (std::vector<std::string>{"default"}));
+
+    // copies share the storage
+    const BalancerConfig previous = config;
+    ASSERT_EQ(previous.ports.Storage(), config.ports.Storage());
+    ASSERT_EQ(previous.backends.Storage(), config.backends.Storage());
+
+    // unchanged vectors keep the storage, changed ones get a new one
+    const auto changed_json = MakeJson(R"({"ports": [80, 443], "backends": [{"host": "a"}, {"host": "c"}]})");
+    ASSERT_TRUE(config.Parse(uconfig::RapidjsonFormat<>{}, "", &changed_json));
+    ASSERT_EQ(previous.ports.Storage(), config.ports.Storage());
+    ASSERT_NE(previous.backends.Storage(), config.backends.Storage());
+    ASSERT_EQ(previous.backends[1].host, "b");
+    ASSERT_EQ(config.backends[1].host, "c");
+
+    rapidjson::Document emitted;
+    config.Emit(uconfig::RapidjsonFormat<>{}, "", &emitted);
+    ASSERT_STREQ(emitted["backends"][1]["host"].GetString(), "c");
+    ASSERT_STREQ(emitted["tags"][0].GetString(), "default");
+}
+
+TEST(SharedVector, Mutable)
+{
+    const auto json = MakeJson(R"({"ports": [80], "backends": []})");
+
+    BalancerConfig config;
+    ASSERT_TRUE(config.Parse(uconfig::RapidjsonFormat<>{}, "", &json, false));
+    const BalancerConfig previous = config;
+
+    config.ports.Mutable().push_back(8080);
+    ASSERT_EQ(previous.ports->size(), 1);
+    ASSERT_EQ(config.ports->size(), 2);
+
+    // modified vector is parsed again
+    ASSERT_TRUE(config.Parse(uconfig::RapidjsonFormat<>{}, "", &json, false));
+    ASSERT_EQ(*config.ports, (std::vector<unsigned>{80}));
+}
+
+TEST(SharedVector, Validate)
+{
+    const auto json = MakeJson(R"({"ports": [0], "backends": []})");
+
+    BalancerConfig config;
+    ASSERT_THROW(config.Parse(uconfig::RapidjsonFormat<>{}, "", &json), uconfig::ParseError);
+    // failed vector is validated again
+    ASSERT_THROW(config.Parse(uconfig::RapidjsonFormat<>{}, "", &json), uconfig::ParseError);
+}
+
+TEST(SharedVector, ParseEqual)
+{
+    // env has no subtree hash, equal elements keep the storage
+    ::setenv("BALANCER_PORTS_0", "80", 1);
+    BalancerConfig config;
+    ASSERT_TRUE(config.Parse(uconfig::EnvFormat{}, "BALANCER", nullptr));
+    const auto storage = config.ports.Storage();
+    ASSERT_TRUE(config.Parse(uconfig::EnvFormat{}, "BALANCER", nullptr));
+    ASSERT_EQ(config.ports.Storage(), storage);
+
+    ::setenv("BALANCER_PORTS_1", "443", 1);
+    ASSERT_TRUE(config.Parse(uconfig::EnvFormat{}, "BALANCER", nullptr));
+    ASSERT_NE(config.ports.Storage(), storage);
+    ASSERT_EQ(*config.ports, (std::vector<unsigned>{80, 443}));
+    ::unsetenv("BALANCER_PORTS_0");
+    ::unsetenv("BALANCER_PORTS_1");
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,183 @@
+#include "uconfig/Shm.h"
+#include "uconfig/uconfig.h"
+#include "gtest/gtest.h"
+
+#include <thread>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+/* Publisher and readers share a segment, readers never see half-written generations */
+
+struct NodeConfig: public uconfig::Config<uconfig::FlatKvFormat>
+{
+    uconfig::Variable<std::string> name;
+    uconfig::Variable<unsigned> port;
+
+    using uconfig::Config<uconfig::FlatKvFormat>::Config;
+
+    virtual void Init(const std::string& config_path) override
+    {
+        Register<uconfig::FlatKvFormat>(config_path + "/name", &name);
+        Register<uconfig::FlatKvFormat>(config_path + "/port", &port);
+    }
+};
+
+struct AppConfig: public uconfig::Config<uconfig::FlatKvFormat>
+{
+    uconfig::Variable<unsigned> version;
+    uconfig::Variable<std::string> tag;
+    uconfig::Vector<NodeConfig> nodes;
+    uconfig::Variable<int> absent{42};
+
+    using uconfig::Config<uconfig::FlatKvFormat>::Config;
+
+    virtual void Init(const std::string& config_path) override
+    {
+        Register<uconfig::FlatKvFormat>(config_path + "/version", &version);
+        Register<uconfig::FlatKvFormat>(config_path + "/tag", &tag);
+        Register<uconfig::FlatKvFormat>(config_path + "/nodes", &nodes);
+        Register<uconfig::FlatKvFormat>(config_path + "/absent", &absent);
+    }
+};
+
+AppConfig MakeConfig(unsigned version)
+{
+    AppConfig config;
+    config.version = version;
+    // tag and nodes are derived from the version to check consistency of the parsed ones
+    config.tag = "v" + std::to_string(version);
+    config.nodes = std::vector<NodeConfig>(version % 5 + 1);
+    for (auto& node : *config.nodes) {
+        node.name = config.tag;
+        node.port = version;
+    }
+    return config;
+}
+
+testing::AssertionResult Consistent(const AppConfig& config)
+{
+    const unsigned version = *config.version;
+    for (const auto& node : *config.nodes) {
+        if (node.name != config.tag || node.port != version) {
+            return testing::AssertionFailure() << "config of version " << version << " is torn";
+        }
+    }
+    if (config.nodes->size() != version % 5 + 1 || config.tag != "v" + std::to_string(version)) {
+        return testing::AssertionFailure() << "config of version " << version << " is torn";
+    }
+    return testing::AssertionSuccess();
+}
+
+const std::string shm_name = "/uconfig_test_" + std::to_string(::getpid());
+
+TEST(Shm, PublishParse)
+{
+    uconfig::ShmPublisher publisher{shm_name, 4096};
+    const uconfig::ShmReader reader{shm_name};
+
+    AppConfig parsed;
+    ASSERT_EQ(reader.Generation(), 0);
+    ASSERT_THROW(reader.Parse(&parsed), uconfig::ParseError);
+
+    AppConfig config = MakeConfig(1);
+    ASSERT_EQ(publisher.Publish(config), 1);
+    ASSERT_EQ(reader.Generation(), 1);
+    ASSERT_EQ(reader.Parse(&parsed), 1);
+    ASSERT_TRUE(parsed.Initialized());
+    ASSERT_EQ(parsed.version, 1);
+    ASSERT_EQ(parsed.nodes->size(), 2);
+    ASSERT_EQ(parsed.nodes[1].name, "v1");
+    ASSERT_EQ(parsed.absent, 42);
+
+    config = MakeConfig(2);
+    ASSERT_EQ(publisher.Publish(config), 2);
+    ASSERT_EQ(reader.Parse(&parsed), 2);
+    ASSERT_EQ(parsed.version, 2);
+    ASSERT_TRUE(Consistent(parsed));
+
+    // failed parse leaves the config as is
+    ASSERT_EQ(reader.Parse(&parsed, "/absent", false), 0);
+    ASSERT_EQ(parsed.version, 2);
+    ASSERT_TRUE(Consistent(parsed));
+
+    // reopened publisher continues generations
+    uconfig::ShmPublisher reopened{shm_name, 4096};
+    ASSERT_EQ(reopened.Generation(), 2);
+    ASSERT_THROW(uconfig::ShmPublisher(shm_name, 8192), uconfig::Error);
+
+    uconfig::ShmPublisher::Unlink(shm_name);
+    ASSERT_THROW(uconfig::ShmReader{shm_name}, uconfig::Error);
+}
+
+TEST(Shm, PublishTooLarge)
+{
+    uconfig::ShmPublisher publisher{shm_name, 128};
+    const uconfig::ShmReader reader{shm_name};
+
+    AppConfig config = MakeConfig(4);
+    ASSERT_THROW(publisher.Publish(config), uconfig::EmitError);
+    ASSERT_EQ(reader.Generation(), 0);
+
+    uconfig::ShmPublisher::Unlink(shm_name);
+}
+
+TEST(Shm, ParseOtherProcess)
+{
+    uconfig::ShmPublisher publisher{shm_name, 4096};
+    AppConfig config = MakeConfig(3);
+    publisher.Publish(config);
+
+    const pid_t child = ::fork();
+    ASSERT_NE(child, -1);
+    if (child == 0) {
+        // mapping of the other process is at the other address
+        const uconfig::ShmReader reader{shm_name};
+        AppConfig parsed;
+        reader.Parse(&parsed);
+        ::_exit(parsed.version == 3u && Consistent(parsed) ? 0 : 1);
+    }
+
+    int status = 0;
+    ASSERT_EQ(::waitpid(child, &status, 0), child);
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(WEXITSTATUS(status), 0);
+
+    uconfig::ShmPublisher::Unlink(shm_name);
+}
+
+TEST(Shm, ParseConcurrent)
+{
+    uconfig::ShmPublisher publisher{shm_name, 4096};
+    const uconfig::ShmReader reader{shm_name};
+
+    const unsigned last_version = 2000;
+    AppConfig first = MakeConfig(1);
+    publisher.Publish(first);
+
+    std::thread publishing([&publisher, last_version]() {
+        for (unsigned version = 2; version <= last_version; ++version) {
+            AppConfig config = MakeConfig(version);
+            publisher.Publish(config);
+        }
+    });
+
+    AppConfig parsed;
+    std::uint64_t generation = 0;
+    while (generation < last_version) {
+        const std::uint64_t parsed_generation = reader.Parse(&parsed);
+        ASSERT_GE(parsed_generation, generation);
+        ASSERT_EQ(parsed.version, parsed_generation);
+        ASSERT_TRUE(Consistent(parsed));
+        generation = parsed_generation;
+    }
+    publishing.join();
+
+    uconfig::ShmPublisher::Unlink(shm_name);
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,95 @@
+#include "uconfig/Snapshot.h"
+#include "uconfig/format/Env.h"
+#include "uconfig/uconfig.h"
+#include "gtest/gtest.h"
+
+#include <thread>
+#include <vector>
+
+/* Readers keep their snapshots until they ask for the next one */
+
+struct AppConfig: public uconfig::Config<uconfig::EnvFormat>
+{
+    uconfig::Variable<unsigned> version;
+    uconfig::Vector<unsigned> copies;
+
+    using uconfig::Config<uconfig::EnvFormat>::Config;
+
+    virtual void Init(const std::string& config_path) override
+    {
+        Register<uconfig::EnvFormat>(config_path + "_VERSION", &version);
+        Register<uconfig::EnvFormat>(config_path + "_COPIES", &copies);
+    }
+};
+
+AppConfig MakeConfig(unsigned version)
+{
+    AppConfig config;
+    config.version = version;
+    config.copies = std::vector<unsigned>(8, version);
+    return config;
+}
+
+TEST(Snapshot, PublishRead)
+{
+    uconfig::SnapshotPublisher<AppConfig> publisher{MakeConfig(1)};
+    auto reader = publisher.MakeReader();
+
+    ASSERT_EQ(publisher.Generation(), 1);
+    ASSERT_EQ(reader.Generation(), 1);
+    ASSERT_EQ(reader->version, 1u);
+
+    const AppConfig& pinned = reader.Get();
+    std::shared_ptr<const AppConfig> shared = reader.Share();
+    ASSERT_EQ(publisher.Publish(MakeConfig(2)), 2);
+    // snapshot is held until the reader refreshes
+    ASSERT_EQ(reader.Generation(), 1);
+    ASSERT_EQ(pinned.version, 1u);
+
+    ASSERT_EQ((*reader).version, 2u);
+    ASSERT_EQ(reader.Generation(), 2);
+    ASSERT_EQ(shared->version, 1u);
+    ASSERT_EQ(publisher.Current()->version, 2u);
+
+    ASSERT_THROW(publisher.Publish(std::shared_ptr<const AppConfig>{}), std::runtime_error);
+}
+
+TEST(Snapshot, ReadConcurrent)
+{
+    const unsigned last_version = 1000;
+    uconfig::SnapshotPublisher<AppConfig> publisher{MakeConfig(1)};
+
+    std::vector<std::thread> readers;
+    std::vector<int> consistent(4, 1);
+    for (std::size_t index = 0; index < consistent.size(); ++index) {
+        readers.emplace_back([&publisher, &consistent, index, last_version]() {
+            auto reader = publisher.MakeReader();
+            unsigned version = 0;
+            while (version < last_version) {
+                const AppConfig& config = reader.Get();
+                if (config.version < version || config.version != reader.Generation()) {
+                    consistent[index] = 0;
+                }
+                for (unsigned copy : *config.copies) {
+                    consistent[index] = consistent[index] && copy == config.version ? 1 : 0;
+                }
+                version = *config.version;
+            }
+        });
+    }
+
+    for (unsigned version = 2; version <= last_version; ++version) {
+        publisher.Publish(MakeConfig(version));
+    }
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    ASSERT_EQ(consistent, std::vector<int>(consistent.size(), 1));
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
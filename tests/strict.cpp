@@ -0,0 +1,167 @@
+#include "uconfig/format/Env.h"
+#include "uconfig/format/FlatKv.h"
+#include "uconfig/format/Rapidjson.h"
+#include "uconfig/format/Yaml.h"
+#include "uconfig/uconfig.h"
+#include "gtest/gtest.h"
+
+#include <cstdlib>
+
+/* Strict parse reports keys of the source no element has consumed */
+
+using StrictConfig =
+    uconfig::Config<uconfig::RapidjsonFormat<>, uconfig::EnvFormat, uconfig::YamlFormat, uconfig::FlatKvFormat>;
+
+struct ServerConfig: public StrictConfig
+{
+    uconfig::Variable<std::string> host;
+    uconfig::Variable<unsigned> port{8080};
+    uconfig::Vector<unsigned> ports{true};
+
+    using StrictConfig::Config;
+
+    virtual void Init(const std::string& config_path) override
+    {
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/host", &host);
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/port", &port);
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/ports", &ports);
+        Register<uconfig::EnvFormat>(config_path + "_HOST", &host);
+        Register<uconfig::EnvFormat>(config_path + "_PORT", &port);
+        Register<uconfig::EnvFormat>(config_path + "_PORTS", &ports);
+        Register<uconfig::YamlFormat>(config_path + "/host", &host);
+        Register<uconfig::YamlFormat>(config_path + "/port", &port);
+        Register<uconfig::YamlFormat>(config_path + "/ports", &ports);
+        Register<uconfig::FlatKvFormat>(config_path + "/host", &host);
+    }
+};
+
+struct AppConfig: public StrictConfig
+{
+    ServerConfig server;
+    uconfig::Vector<ServerConfig> backends{true};
+
+    using StrictConfig::Config;
+
+    virtual void Init(const std::string& config_path) override
+    {
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/server", &server);
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/backends", &backends);
+        Register<uconfig::EnvFormat>(config_path + "_SERVER", &server);
+        Register<uconfig::YamlFormat>(config_path + "/server", &server);
+        Register<uconfig::YamlFormat>(config_path + "/backends", &backends);
+        Register<uconfig::FlatKvFormat>(config_path + "/server", &server);
+    }
+};
+
+TEST(Strict, Rapidjson)
+{
+    rapidjson::Document json;
+    json.Parse(R"({"server": {"host": "localhost", "prot": 80, "ports": [1, 2]},
+                   "backends": [{"host": "a"}, {"host": "b", "a/b": {"c": 1}}],
+                   "extra": {"key": true}})");
+
+    AppConfig config;
+    ASSERT_TRUE(config.Parse(uconfig::RapidjsonFormat<>{}, "", &json));
+    ASSERT_TRUE(config.UnknownKeys().empty());
+
+    config.SetStrict(true);
+    ASSERT_THROW(config.Parse(uconfig::RapidjsonFormat<>{}, "", &json), uconfig::ParseError);
+    ASSERT_EQ(config.UnknownKeys(), (std::vector<std::string>{"/server/prot", "/backends/1/a~1b", "/extra"}));
+
+    ASSERT_TRUE(config.Parse(uconfig::RapidjsonFormat<>{}, "", &json, false));
+    ASSERT_EQ(config.UnknownKeys().size(), 3);
+    ASSERT_EQ(config.server.port, 8080u);
+
+    // memoized sections are parsed again to track their keys
+    config.SetMemoize(true);
+    config.SetStrict(false);
+    ASSERT_TRUE(config.Parse(uconfig::RapidjsonFormat<>{}, "", &json));
+    config.SetStrict(true);
+    ASSERT_TRUE(config.Parse(uconfig::RapidjsonFormat<>{}, "", &json, false));
+    ASSERT_EQ(config.UnknownKeys().size(), 3);
+
+    rapidjson::Document known;
+    known.Parse(R"({"server": {"host": "localhost"}})");
+    ASSERT_TRUE(config.Parse(uconfig::RapidjsonFormat<>{}, "", &known));
+    ASSERT_TRUE(config.UnknownKeys().empty());
+}
+
+TEST(Strict, ParallelVector)
+{
+    rapidjson::Document json;
+    json.Parse(R"({"server": {"host": "localhost", "ports": [1, 2, 3, 4, 5, 6, 7, 8]}, "backends": []})");
+
+    AppConfig config;
+    config.SetStrict(true);
+    config.server.ports.SetParallel(4, 1);
+    ASSERT_TRUE(config.Parse(uconfig::RapidjsonFormat<>{}, "", &json));
+    ASSERT_EQ(config.server.ports->size(), 8);
+}
+
+TEST(Strict, Env)
+{
+    ::setenv("APP_SERVER_HOST", "localhost", 1);
+    ::setenv("APP_SERVER_PORTS_0", "80", 1);
+    ::setenv("APP_SERVER_PROT", "80", 1);
+    ::setenv("APPLICATION", "other", 1);
+
+    AppConfig config;
+    config.SetStrict(true);
+    ASSERT_THROW(config.Parse(uconfig::EnvFormat{}, "APP", nullptr), uconfig::ParseError);
+    ASSERT_EQ(config.UnknownKeys(), (std::vector<std::string>{"APP_SERVER_PROT"}));
+
+    ::unsetenv("APP_SERVER_PROT");
+    ASSERT_TRUE(config.Parse(uconfig::EnvFormat{}, "APP", nullptr));
+    ASSERT_TRUE(config.UnknownKeys().empty());
+
+    ::unsetenv("APP_SERVER_HOST");
+    ::unsetenv("APP_SERVER_PORTS_0");
+    ::unsetenv("APPLICATION");
+}
+
+TEST(Strict, Yaml)
+{
+    const uconfig::YamlDocument yaml(R"(server:
+  host: localhost
+  prot: 80
+  ports:
+    - 1
+    - 2
+backends:
+  - host: a
+  - host: b
+    a/b:
+      c: 1
+extra:
+  key: true
+)");
+
+    AppConfig config;
+    config.SetStrict(true);
+    ASSERT_THROW(config.Parse(uconfig::YamlFormat{}, "", &yaml), uconfig::ParseError);
+    ASSERT_EQ(config.UnknownKeys(), (std::vector<std::string>{"/server/prot", "/backends/1/a~1b", "/extra"}));
+
+    const uconfig::YamlDocument known("server:\n  host: localhost\n  ports:\n    - 1\n");
+    ASSERT_TRUE(config.Parse(uconfig::YamlFormat{}, "", &known));
+    ASSERT_TRUE(config.UnknownKeys().empty());
+}
+
+TEST(Strict, Unsupported)
+{
+    uconfig::FlatKvTable table;
+    table.Add("/server/host", uconfig::FlatKvTable::Scalar::MakeText("localhost"));
+    table.Build();
+
+    // format reports no unknown keys, so strict parse can not pass
+    AppConfig config;
+    ASSERT_TRUE(config.Parse(uconfig::FlatKvFormat{}, "", &table));
+    config.SetStrict(true);
+    ASSERT_THROW(config.Parse(uconfig::FlatKvFormat{}, "", &table), uconfig::ParseError);
+    ASSERT_FALSE(config.Parse(uconfig::FlatKvFormat{}, "", &table, false));
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
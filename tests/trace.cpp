@@ -0,0 +1,151 @@
+#define UCONFIG_TRACING 1
+
+#include "uconfig/format/Env.h"
+#include "uconfig/uconfig.h"
+#include "gtest/gtest.h"
+
+#include <cstdlib>
+#include <vector>
+
+/* Hook sees matched begin and end of every parse, emit, section and validator */
+
+struct Event
+{
+    std::string kind;
+    uconfig::TraceEvent event;
+    std::string path;
+    bool failed;
+
+    bool operator==(const Event& other) const
+    {
+        return kind == other.kind && event == other.event && path == other.path && failed == other.failed;
+    }
+};
+
+std::ostream& operator<<(std::ostream& out, const Event& event)
+{
+    return out << event.kind << " " << uconfig::TraceEventName(event.event) << " '" << event.path << "'"
+               << (event.failed ? " failed" : "");
+}
+
+struct RecordingHook: public uconfig::TraceHook
+{
+    std::vector<Event> events;
+
+    virtual void Begin(uconfig::TraceEvent event, const std::string& format, const std::string& path) noexcept override
+    {
+        EXPECT_EQ(format, uconfig::EnvFormat::name);
+        events.push_back(Event{"begin", event, path, false});
+    }
+
+    virtual void End(uconfig::TraceEvent event, const std::string& format, const std::string& path,
+                     bool failed) noexcept override
+    {
+        EXPECT_EQ(format, uconfig::EnvFormat::name);
+        events.push_back(Event{"end", event, path, failed});
+    }
+};
+
+struct NodeConfig: public uconfig::Config<uconfig::EnvFormat>
+{
+    uconfig::Variable<unsigned> port;
+
+    using uconfig::Config<uconfig::EnvFormat>::Config;
+
+    virtual void Init(const std::string& config_path) override
+    {
+        Register<uconfig::EnvFormat>(config_path + "_PORT", &port);
+    }
+
+    virtual void Validate() const override
+    {
+        if (*port == 0) {
+            throw std::runtime_error("port is zero");
+        }
+    }
+};
+
+struct AppConfig: public uconfig::Config<uconfig::EnvFormat>
+{
+    NodeConfig node;
+
+    using uconfig::Config<uconfig::EnvFormat>::Config;
+
+    virtual void Init(const std::string& config_path) override
+    {
+        Register<uconfig::EnvFormat>(config_path + "_NODE", &node);
+    }
+};
+
+TEST(Trace, Parse)
+{
+    using uconfig::TraceEvent;
+
+    RecordingHook hook;
+    uconfig::SetTraceHook(&hook);
+    ASSERT_EQ(uconfig::GetTraceHook(), &hook);
+
+    ::setenv("APP_NODE_PORT", "80", 1);
+    AppConfig config;
+    ASSERT_TRUE(config.Parse(uconfig::EnvFormat{}, "APP", nullptr));
+
+    const std::vector<Event> expected_events = {
+        {"begin", TraceEvent::Parse, "APP", false},
+        {"begin", TraceEvent::ParseSection, "APP", false},
+        {"begin", TraceEvent::ParseSection, "APP_NODE", false},
+        {"begin", TraceEvent::Validate, "APP_NODE_PORT", false},
+        {"end", TraceEvent::Validate, "APP_NODE_PORT", false},
+        {"begin", TraceEvent::Validate, "APP_NODE", false},
+        {"end", TraceEvent::Validate, "APP_NODE", false},
+        {"end", TraceEvent::ParseSection, "APP_NODE", false},
+        {"begin", TraceEvent::Validate, "APP", false},
+        {"end", TraceEvent::Validate, "APP", false},
+        {"end", TraceEvent::ParseSection, "APP", false},
+        {"end", TraceEvent::Parse, "APP", false},
+    };
+    ASSERT_EQ(hook.events, expected_events);
+
+    // failed validator ends with an exception
+    hook.events.clear();
+    ::setenv("APP_NODE_PORT", "0", 1);
+    ASSERT_THROW(config.Parse(uconfig::EnvFormat{}, "APP", nullptr), uconfig::ParseError);
+    ASSERT_EQ(hook.events[6], (Event{"end", TraceEvent::Validate, "APP_NODE", true}));
+    ASSERT_EQ(hook.events.back(), (Event{"end", TraceEvent::Parse, "APP", true}));
+    ::unsetenv("APP_NODE_PORT");
+
+    uconfig::SetTraceHook(nullptr);
+}
+
+TEST(Trace, Emit)
+{
+    using uconfig::TraceEvent;
+
+    RecordingHook hook;
+    uconfig::SetTraceHook(&hook);
+
+    AppConfig config;
+    config.node.port = 80;
+    std::map<std::string, std::string> dest;
+    config.Emit(uconfig::EnvFormat{}, "APP", &dest);
+
+    const std::vector<Event> expected_events = {
+        {"begin", TraceEvent::Emit, "APP", false},
+        {"begin", TraceEvent::EmitSection, "APP", false},
+        {"begin", TraceEvent::EmitSection, "APP_NODE", false},
+        {"end", TraceEvent::EmitSection, "APP_NODE", false},
+        {"end", TraceEvent::EmitSection, "APP", false},
+        {"end", TraceEvent::Emit, "APP", false},
+    };
+    ASSERT_EQ(hook.events, expected_events);
+
+    uconfig::SetTraceHook(nullptr);
+    hook.events.clear();
+    config.Emit(uconfig::EnvFormat{}, "APP", &dest);
+    ASSERT_TRUE(hook.events.empty());
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,139 @@
+#include "uconfig/Writer.h"
+#include "uconfig/format/Env.h"
+#include "uconfig/format/Rapidjson.h"
+#include "uconfig/uconfig.h"
+#include "gtest/gtest.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* Emitted configs are written into a temporary file and renamed over the target */
+
+struct ServerConfig: public uconfig::Config<uconfig::RapidjsonFormat<>, uconfig::EnvFormat>
+{
+    uconfig::Variable<std::string> host;
+    uconfig::Vector<unsigned> ports;
+
+    using uconfig::Config<uconfig::RapidjsonFormat<>, uconfig::EnvFormat>::Config;
+
+    virtual void Init(const std::string& config_path) override
+    {
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/host", &host);
+        Register<uconfig::RapidjsonFormat<>>(config_path + "/ports", &ports);
+        Register<uconfig::EnvFormat>(config_path + "_HOST", &host);
+        Register<uconfig::EnvFormat>(config_path + "_PORTS", &ports);
+    }
+};
+
+class Writer: public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        char dir[] = "/tmp/uconfig-writer-XXXXXX";
+        ASSERT_NE(::mkdtemp(dir), nullptr);
+        dir_ = dir;
+    }
+
+    void TearDown() override
+    {
+        for (const auto& file : Files()) {
+            ::unlink((dir_ + "/" + file).c_str());
+        }
+        ::rmdir(dir_.c_str());
+    }
+
+    std::vector<std::string> Files() const
+    {
+        std::vector<std::string> files;
+        DIR* dir = ::opendir(dir_.c_str());
+        while (const dirent* entry = ::readdir(dir)) {
+            if (entry->d_name[0] != '.') {
+                files.emplace_back(entry->d_name);
+            }
+        }
+        ::closedir(dir);
+        return files;
+    }
+
+    std::string Read(const std::string& file) const
+    {
+        std::ifstream in(dir_ + "/" + file);
+        std::stringstream contents;
+        contents << in.rdbuf();
+        return contents.str();
+    }
+
+    std::string dir_;
+};
+
+TEST_F(Writer, Rapidjson)
+{
+    ServerConfig config;
+    config.host = "localhost";
+    config.ports = std::vector<unsigned>{80, 443};
+
+    uconfig::EmitFile(uconfig::RapidjsonFormat<>{}, config, "", dir_ + "/config.json");
+    ASSERT_EQ(Files(), std::vector<std::string>{"config.json"});
+
+    rapidjson::Document json;
+    json.Parse(Read("config.json").c_str());
+    ServerConfig parsed;
+    ASSERT_TRUE(parsed.Parse(uconfig::RapidjsonFormat<>{}, "", &json));
+    ASSERT_EQ(parsed.host, "localhost");
+    ASSERT_EQ(parsed.ports[1], 443u);
+
+    struct stat file_stat;
+    ASSERT_EQ(::stat((dir_ + "/config.json").c_str(), &file_stat), 0);
+    ASSERT_EQ(file_stat.st_mode & 0777, 0644u);
+}
+
+TEST_F(Writer, Env)
+{
+    ServerConfig config;
+    config.host = "localhost";
+    config.ports = std::vector<unsigned>{80};
+
+    uconfig::EmitFile(uconfig::EnvFormat{}, config, "SERVER", dir_ + "/server.env", 0600);
+    ASSERT_EQ(Read("server.env"), "SERVER_HOST=localhost\nSERVER_PORTS_0=80\n");
+
+    // previous contents are kept if the new ones failed to be written
+    config.host = "local\nhost";
+    ASSERT_THROW(uconfig::EmitFile(uconfig::EnvFormat{}, config, "SERVER", dir_ + "/server.env"), uconfig::EmitError);
+    ASSERT_EQ(Files(), std::vector<std::string>{"server.env"});
+    ASSERT_EQ(Read("server.env"), "SERVER_HOST=localhost\nSERVER_PORTS_0=80\n");
+}
+
+TEST_F(Writer, Buffering)
+{
+    {
+        uconfig::AtomicFileWriter file(dir_ + "/data", 0644, 3);
+        file.Write("abcdefgh");
+        file.Put('i');
+        // nothing is visible until commit
+        ASSERT_EQ(Read("data"), "");
+        file.Commit();
+    }
+    ASSERT_EQ(Read("data"), "abcdefghi");
+
+    {
+        uconfig::AtomicFileWriter file(dir_ + "/data");
+        file.Write("partial");
+        file.Flush();
+    }
+    ASSERT_EQ(Files(), std::vector<std::string>{"data"});
+    ASSERT_EQ(Read("data"), "abcdefghi");
+
+    ASSERT_THROW(uconfig::AtomicFileWriter(dir_ + "/missing/data"), uconfig::EmitError);
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,305 @@
+#include "uconfig/format/Yaml.h"
+#include "uconfig/uconfig.h"
+#include "gtest/gtest.h"
+
+/* YAML scalars are typed by their form: quoted ones are strings only */
+
+static const std::string yaml_source = R"(# values of all kinds
+string: value
+quoted: "123"
+single_quoted: 'it''s'
+escaped: "line\nbreak \u00e9"
+posinteger: 123
+neginteger: -123 # trailing comment
+poslonginteger: 123456789000
+neglonginteger: -123456789000
+posdouble: 123456.789
+negdouble: -123456.789
+boolean: true
+empty:
+nulled: ~
+nested:
+  key: nested value
+  deeper:
+    key: 1
+list:
+- first
+- second
+indented_list:
+  - 1
+  - 2
+objects:
+  - name: a
+    port: 80
+  - name: b
+    port: 81
+matrix:
+  - - 1
+    - 2
+  - []
+)";
+
+template <typename T>
+testing::AssertionResult Parsed(const uconfig::YamlDocument& yaml, const std::string& path, const T& expected_value)
+{
+    std::optional<T> value = uconfig::YamlFormat{}.Parse<T>(&yaml, path);
+    if (!value.has_value()) {
+        return ::testing::AssertionFailure() << "'" << path << "' yaml variable was not parsed";
+    }
+
+    if (*value != expected_value) {
+        return ::testing::AssertionFailure() << "'" << path << "' yaml variable value '" << *value
+                                             << "' differs from expected '" << expected_value << "'";
+    }
+
+    return testing::AssertionSuccess();
+}
+
+template <typename T>
+testing::AssertionResult NotParsed(const uconfig::YamlDocument& yaml, const std::string& path)
+{
+    std::optional<T> value = uconfig::YamlFormat{}.Parse<T>(&yaml, path);
+    if (value.has_value()) {
+        return ::testing::AssertionFailure() << "'" << path << "' yaml variable was parsed";
+    }
+
+    return testing::AssertionSuccess();
+}
+
+struct NodeConfig: public uconfig::Config<uconfig::YamlFormat>
+{
+    uconfig::Variable<std::string> name;
+    uconfig::Variable<unsigned> port;
+
+    using uconfig::Config<uconfig::YamlFormat>::Config;
+
+    virtual void Init(const std::string& config_path) override
+    {
+        Register<uconfig::YamlFormat>(config_path + "/name", &name);
+        Register<uconfig::YamlFormat>(config_path + "/port", &port);
+    }
+};
+
+struct AppConfig: public uconfig::Config<uconfig::YamlFormat>
+{
+    uconfig::Variable<std::string> string;
+    uconfig::Variable<double> posdouble;
+    uconfig::Variable<bool> boolean;
+    uconfig::Vector<std::string> list;
+    uconfig::Vector<NodeConfig> objects;
+    uconfig::Variable<int> absent{42};
+
+    using uconfig::Config<uconfig::YamlFormat>::Config;
+
+    virtual void Init(const std::string& config_path) override
+    {
+        Register<uconfig::YamlFormat>(config_path + "/string", &string);
+        Register<uconfig::YamlFormat>(config_path + "/posdouble", &posdouble);
+        Register<uconfig::YamlFormat>(config_path + "/boolean", &boolean);
+        Register<uconfig::YamlFormat>(config_path + "/list", &list);
+        Register<uconfig::YamlFormat>(config_path + "/objects", &objects);
+        Register<uconfig::YamlFormat>(config_path + "/absent", &absent);
+    }
+};
+
+TEST(Yaml, ParseNoValue)
+{
+    const uconfig::YamlDocument yaml;
+
+    ASSERT_TRUE(NotParsed<std::string>(yaml, "/string"));
+    ASSERT_TRUE(NotParsed<int>(yaml, "/posinteger"));
+    ASSERT_TRUE(NotParsed<double>(yaml, "/posdouble"));
+}
+
+TEST(Yaml, ParseAsString)
+{
+    const uconfig::YamlDocument yaml{yaml_source};
+
+    ASSERT_TRUE(Parsed<std::string>(yaml, "/string", "value"));
+    ASSERT_TRUE(Parsed<std::string>(yaml, "/quoted", "123"));
+    ASSERT_TRUE(Parsed<std::string>(yaml, "/single_quoted", "it's"));
+    ASSERT_TRUE(Parsed<std::string>(yaml, "/escaped", "line\nbreak \xC3\xA9"));
+    ASSERT_TRUE(Parsed<std::string>(yaml, "/posinteger", "123"));
+    ASSERT_TRUE(Parsed<std::string>(yaml, "/nested/key", "nested value"));
+
+    ASSERT_TRUE(NotParsed<std::string>(yaml, "/empty"));
+    ASSERT_TRUE(NotParsed<std::string>(yaml, "/nulled"));
+    ASSERT_TRUE(NotParsed<std::string>(yaml, "/nested"));
+    ASSERT_TRUE(NotParsed<std::string>(yaml, "/absent"));
+}
+
+TEST(Yaml, ParseAsNumber)
+{
+    const uconfig::YamlDocument yaml{yaml_source};
+
+    ASSERT_TRUE(Parsed<int>(yaml, "/posinteger", 123));
+    ASSERT_TRUE(Parsed<int>(yaml, "/neginteger", -123));
+    ASSERT_TRUE(Parsed<unsigned>(yaml, "/posinteger", 123));
+    ASSERT_TRUE(Parsed<long int>(yaml, "/poslonginteger", 123456789000));
+    ASSERT_TRUE(Parsed<long int>(yaml, "/neglonginteger", -123456789000));
+    ASSERT_TRUE(Parsed<double>(yaml, "/posdouble", 123456.789));
+    ASSERT_TRUE(Parsed<double>(yaml, "/negdouble", -123456.789));
+    ASSERT_TRUE(Parsed<int>(yaml, "/nested/deeper/key", 1));
+
+    ASSERT_TRUE(NotParsed<int>(yaml, "/quoted"));
+    ASSERT_TRUE(NotParsed<int>(yaml, "/string"));
+    ASSERT_TRUE(NotParsed<int>(yaml, "/poslonginteger"));
+    ASSERT_TRUE(NotParsed<int>(yaml, "/posdouble"));
+    ASSERT_TRUE(NotParsed<unsigned>(yaml, "/neginteger"));
+}
+
+TEST(Yaml, ParseAsBool)
+{
+    const uconfig::YamlDocument yaml{yaml_source};
+
+    ASSERT_TRUE(Parsed<bool>(yaml, "/boolean", true));
+
+    ASSERT_TRUE(NotParsed<bool>(yaml, "/string"));
+    ASSERT_TRUE(NotParsed<bool>(yaml, "/posinteger"));
+}
+
+TEST(Yaml, ParseSequence)
+{
+    const uconfig::YamlDocument yaml{yaml_source};
+
+    ASSERT_TRUE(Parsed<std::string>(yaml, "/list/0", "first"));
+    ASSERT_TRUE(Parsed<std::string>(yaml, "/list/1", "second"));
+    ASSERT_TRUE(Parsed<int>(yaml, "/indented_list/0", 1));
+    ASSERT_TRUE(Parsed<int>(yaml, "/indented_list/1", 2));
+    ASSERT_TRUE(Parsed<std::string>(yaml, "/objects/0/name", "a"));
+    ASSERT_TRUE(Parsed<int>(yaml, "/objects/1/port", 81));
+    ASSERT_TRUE(Parsed<int>(yaml, "/matrix/0/1", 2));
+
+    ASSERT_TRUE(NotParsed<std::string>(yaml, "/list/2"));
+    ASSERT_TRUE(NotParsed<std::string>(yaml, "/list/01"));
+    ASSERT_TRUE(NotParsed<std::string>(yaml, "/matrix/1/0"));
+    ASSERT_EQ(yaml.Size(yaml.Find("/matrix/1")), 0);
+}
+
+TEST(Yaml, ParseInvalid)
+{
+    ASSERT_THROW(uconfig::YamlDocument{"a: 1\n\tb: 2\n"}, uconfig::ParseError);
+    ASSERT_THROW(uconfig::YamlDocument{"a:\n  b: 1\n c: 2\n"}, uconfig::ParseError);
+    ASSERT_THROW(uconfig::YamlDocument{"a: 1\n- b\n"}, uconfig::ParseError);
+    ASSERT_THROW(uconfig::YamlDocument{"a: 1\na: 2\n"}, uconfig::ParseError);
+    ASSERT_THROW(uconfig::YamlDocument{"a: \"unclosed\n"}, uconfig::ParseError);
+    ASSERT_THROW(uconfig::YamlDocument{"a: [1, 2]\n"}, uconfig::ParseError);
+    ASSERT_THROW(uconfig::YamlDocument{"a: |\n  text\n"}, uconfig::ParseError);
+    ASSERT_THROW(uconfig::YamlDocument{"a: &anchor 1\n"}, uconfig::ParseError);
+}
+
+TEST(Yaml, ParseWideMapping)
+{
+    // members of wide mappings are looked up by hashed keys
+    std::string source;
+    std::string reversed;
+    for (int key = 0; key < 1000; ++key) {
+        source += "key" + std::to_string(key) + ": " + std::to_string(key) + "\n";
+        reversed.insert(0, "key" + std::to_string(key) + ": " + std::to_string(key) + "\n");
+    }
+    const uconfig::YamlDocument yaml{source};
+    ASSERT_TRUE(Parsed<int>(yaml, "/key0", 0));
+    ASSERT_TRUE(Parsed<int>(yaml, "/key999", 999));
+    ASSERT_TRUE(NotParsed<int>(yaml, "/key1000"));
+
+    ASSERT_THROW(uconfig::YamlDocument{source + "key500: 1\n"}, uconfig::ParseError);
+    ASSERT_EQ(uconfig::YamlDocument{source}, uconfig::YamlDocument{reversed});
+    ASSERT_NE(uconfig::YamlDocument{source}, uconfig::YamlDocument{reversed + "key1000: 1\n"});
+
+    // replaced mapping is not found by its' former members
+    uconfig::YamlDocument emitted;
+    uconfig::YamlFormat format;
+    for (int key = 0; key < 100; ++key) {
+        format.Emit<int>(&emitted, "/wide/key" + std::to_string(key), key);
+    }
+    ASSERT_TRUE(Parsed<int>(emitted, "/wide/key50", 50));
+    format.Emit<int>(&emitted, "/wide", 1);
+    for (int key = 0; key < 10; ++key) {
+        format.Emit<int>(&emitted, "/wide/other" + std::to_string(key), key);
+    }
+    ASSERT_TRUE(NotParsed<int>(emitted, "/wide/key50"));
+    ASSERT_TRUE(Parsed<int>(emitted, "/wide/other9", 9));
+}
+
+TEST(Yaml, ParseEmitValue)
+{
+    uconfig::YamlFormat format;
+    uconfig::YamlDocument yaml_dest;
+
+    format.Emit<std::string>(&yaml_dest, "/string", "value");
+    format.Emit<std::string>(&yaml_dest, "/quoted", "123");
+    format.Emit<int>(&yaml_dest, "/posinteger", 123);
+    format.Emit<long int>(&yaml_dest, "/neglonginteger", -123456789000);
+    format.Emit<double>(&yaml_dest, "/posdouble", 123456.789);
+    format.Emit<bool>(&yaml_dest, "/boolean", false);
+    format.Emit<std::string>(&yaml_dest, "/list/0", "first");
+    format.Emit<std::string>(&yaml_dest, "/list/1", "it's: \"quoted\"");
+    format.Emit<int>(&yaml_dest, "/objects/0/port", 80);
+    format.Emit<std::string>(&yaml_dest, "/objects/0/name", "a");
+
+    const std::string dumped = yaml_dest.Dump();
+    ASSERT_EQ(dumped, "string: value\n"
+                      "quoted: \"123\"\n"
+                      "posinteger: 123\n"
+                      "neglonginteger: -123456789000\n"
+                      "posdouble: 123456.789\n"
+                      "boolean: false\n"
+                      "list:\n"
+                      "  - first\n"
+                      "  - \"it's: \\\"quoted\\\"\"\n"
+                      "objects:\n"
+                      "  - port: 80\n"
+                      "    name: a\n");
+
+    const uconfig::YamlDocument yaml{dumped};
+    ASSERT_EQ(yaml, yaml_dest);
+    ASSERT_TRUE(NotParsed<int>(yaml, "/quoted"));
+    ASSERT_TRUE(Parsed<std::string>(yaml, "/list/1", "it's: \"quoted\""));
+    ASSERT_TRUE(Parsed<bool>(yaml, "/boolean", false));
+}
+
+TEST(Yaml, ParseEmitConfig)
+{
+    const uconfig::YamlDocument yaml{yaml_source};
+    uconfig::YamlFormat format;
+
+    AppConfig config;
+    ASSERT_TRUE(config.Parse(format, "", &yaml));
+    ASSERT_TRUE(config.Initialized());
+
+    ASSERT_EQ(config.string, "value");
+    ASSERT_EQ(config.posdouble, 123456.789);
+    ASSERT_EQ(config.boolean, true);
+    ASSERT_EQ(config.list, std::vector<std::string>({"first", "second"}));
+    ASSERT_EQ(config.objects->size(), 2);
+    ASSERT_EQ(config.objects[1].name, "b");
+    ASSERT_EQ(config.objects[1].port, 81);
+    ASSERT_EQ(config.absent, 42);
+
+    uconfig::YamlDocument emitted;
+    ASSERT_NO_THROW(config.Emit(format, "", &emitted));
+
+    AppConfig reparsed;
+    const uconfig::YamlDocument reparsed_yaml{emitted.Dump()};
+    ASSERT_TRUE(reparsed.Parse(format, "", &reparsed_yaml));
+    ASSERT_EQ(reparsed.list, config.list);
+    ASSERT_EQ(reparsed.objects[0].port, 80);
+    ASSERT_EQ(reparsed.absent, 42);
+}
+
+TEST(Yaml, ParseMandatoryAbsent)
+{
+    const uconfig::YamlDocument yaml{"string: value\n"};
+    uconfig::YamlFormat format;
+
+    AppConfig config;
+    ASSERT_THROW(config.Parse(format, "", &yaml), uconfig::ParseError);
+    ASSERT_TRUE(config.Parse(format, "", &yaml, false));
+    ASSERT_FALSE(config.Initialized());
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}